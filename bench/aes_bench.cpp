@@ -0,0 +1,505 @@
+// 测量各实现、密钥长度和工作模式的性能，输出 JSON ，并可与基线比较
+// 用法：cango_aes_bench [--json <文件>] [--baseline <文件>] [--tolerance <比例>] [--filter <子串>]
+//                      [--min-time <秒>] [--max-size <字节>] [--threads <n,n,...>] [--ghz <频率>]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cango/aes.hpp>
+#include <cango/sha.hpp>
+
+#if CANGO_AES_X86 && !(defined(_MSC_VER) && !defined(__clang__))
+#include <x86intrin.h>
+#endif
+
+using namespace cango::aes;
+
+namespace {
+
+struct Options {
+    const char* json = nullptr;
+    const char* baseline = nullptr;
+    double tolerance = 0.15;
+    std::string filter;
+    double min_time = 0.05;
+    std::size_t max_size = 64 * 1024 * 1024;
+    std::vector<std::size_t> threads;
+
+    /// @brief 不为 0 时按该频率由时间换算周期数，否则在 x86 上读取时间戳计数器
+    double ghz = 0;
+};
+
+/// @brief 一项测量的结果，op 为一次操作，bytes 为一次操作处理的字节数
+struct Result {
+    std::string name;
+    std::string group;
+    std::string engine;
+    std::size_t key_bits = 0;
+    std::string op;
+    std::size_t bytes = 0;
+    std::size_t threads = 1;
+    double ns_per_op = 0;
+
+    /// @brief 一次操作的周期数，无法测量时为负
+    double cycles_per_op = -1;
+};
+
+/// @brief 周期计数，x86 上为时间戳计数器，以标称频率计数
+std::uint64_t read_cycles() noexcept {
+#if CANGO_AES_X86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+class Bench {
+    Options options;
+    std::vector<Result> results;
+
+public:
+    explicit Bench(Options options) : options(std::move(options)) {}
+
+    [[nodiscard]] const Options& config() const noexcept {
+        return options;
+    }
+
+    [[nodiscard]] const std::vector<Result>& all() const noexcept {
+        return results;
+    }
+
+    [[nodiscard]] bool selected(const std::string& name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    /// @brief 重复调用 func 直到超过最短时间，取 3 轮中每次操作最快的一轮，减少其他进程的干扰
+    /// @param ops func 一次调用包含的操作数
+    template<typename TFunc>
+    void measure(Result result, const std::size_t ops, const TFunc& func) {
+        if (!selected(result.name)) return;
+        func();
+        double best_seconds = 0;
+        double best_cycles = 0;
+        for (int round = 0; round < 3; ++round) {
+            std::size_t calls = 0;
+            const auto begin = std::chrono::steady_clock::now();
+            const auto cycles_begin = read_cycles();
+            std::chrono::duration<double> elapsed{};
+            do {
+                func();
+                ++calls;
+                elapsed = std::chrono::steady_clock::now() - begin;
+            } while (elapsed.count() < options.min_time / 3);
+            const auto seconds = elapsed.count() / static_cast<double>(calls * ops);
+            const auto cycles = static_cast<double>(read_cycles() - cycles_begin) / static_cast<double>(calls * ops);
+            if (round == 0 || seconds < best_seconds) {
+                best_seconds = seconds;
+                best_cycles = cycles;
+            }
+        }
+        result.ns_per_op = best_seconds * 1e9;
+        if (options.ghz > 0) result.cycles_per_op = best_seconds * options.ghz * 1e9;
+        else if (CANGO_AES_X86) result.cycles_per_op = best_cycles;
+        print(result);
+        results.push_back(std::move(result));
+    }
+
+private:
+    static void print(const Result& result) {
+        std::printf("%-48s %12.1f ns", result.name.c_str(), result.ns_per_op);
+        if (result.bytes != 0) {
+            std::printf(" %9.3f GB/s", static_cast<double>(result.bytes) / result.ns_per_op);
+            if (result.cycles_per_op >= 0) std::printf(" %9.2f cycles/B", result.cycles_per_op / static_cast<double>(result.bytes));
+        }
+        else if (result.cycles_per_op >= 0) {
+            std::printf(" %9.0f cycles", result.cycles_per_op);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+};
+
+std::string size_name(const std::size_t bytes) {
+    if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0) return std::to_string(bytes / (1024 * 1024)) + "MiB";
+    if (bytes >= 1024 && bytes % 1024 == 0) return std::to_string(bytes / 1024) + "KiB";
+    return std::to_string(bytes) + "B";
+}
+
+/// @brief 测量用的缓冲区，在各项测量之间复用
+struct Buffers {
+    std::vector<std::byte> in;
+    std::vector<std::byte> out;
+
+    explicit Buffers(const std::size_t size) : in(size), out(size) {
+        std::uint32_t seed = 0x5eed'0019u;
+        for (auto& byte: in) {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<std::byte>(seed >> 24);
+        }
+    }
+};
+
+/// @param multiplier 不同的乘数得到不同的密钥，如 XTS 的数据密钥和调整密钥必须不同
+template<std::size_t NBytes>
+std::array<std::uint8_t, NBytes> bench_key(const std::size_t multiplier = 7) {
+    std::array<std::uint8_t, NBytes> key{};
+    for (std::size_t i = 0; i < NBytes; ++i) key[i] = static_cast<std::uint8_t>(i * multiplier + 1);
+    return key;
+}
+
+/// @brief 单块延迟、多块吞吐量、加密与解密、密钥扩展
+/// @param maxSize 多块测量的最大消息长度，参考实现很慢，只测到较小的长度
+template<typename TCryptor, std::size_t NBytes>
+void bench_engine(Bench& bench, Buffers& buffers, const std::string& engine, const std::size_t maxSize) {
+    const auto key = bench_key<NBytes>();
+    const TCryptor cryptor{key};
+    const auto prefix = std::to_string(NBytes * 8) + "/" + engine;
+    Result base{};
+    base.engine = engine;
+    base.key_bits = NBytes * 8;
+
+    // 每块以上一块的输出为输入，测量的是一块的延迟而不是吞吐量
+    constexpr std::size_t chain = 256;
+    for (const bool encrypt: {true, false}) {
+        auto result = base;
+        result.group = "block";
+        result.op = encrypt ? "encrypt" : "decrypt";
+        result.name = "block/" + result.op + "/" + prefix;
+        result.bytes = 16;
+        block_t block{};
+        bench.measure(result, chain, [&] {
+            for (std::size_t i = 0; i < chain; ++i) {
+                if (encrypt) cryptor.encrypt(block);
+                else cryptor.decrypt(block);
+            }
+        });
+    }
+
+    for (std::size_t size = 16; size <= maxSize; size *= 4) {
+        for (const bool encrypt: {true, false}) {
+            auto result = base;
+            result.group = "bulk";
+            result.op = encrypt ? "encrypt" : "decrypt";
+            result.name = "bulk/" + result.op + "/" + prefix + "/" + size_name(size);
+            result.bytes = size;
+            const std::span in{buffers.in.data(), size};
+            const std::span out{buffers.out.data(), size};
+            bench.measure(result, 1, [&] {
+                if (encrypt) cryptor.encrypt_blocks(in, out);
+                else cryptor.decrypt_blocks(in, out);
+            });
+        }
+    }
+
+    {
+        auto result = base;
+        result.group = "key";
+        result.op = "reinit";
+        result.name = "key/reinit/" + prefix;
+        TCryptor target{};
+        bench.measure(result, 1, [&] { target.reinit(key); });
+    }
+    {
+        constexpr std::size_t count = 1024;
+        auto result = base;
+        result.group = "key";
+        result.op = "reinit_many";
+        result.name = "key/reinit_many/" + prefix;
+        const std::vector keys(count, key);
+        std::vector<TCryptor> targets(count);
+        bench.measure(result, count, [&] { TCryptor::reinit_many(keys, targets); });
+    }
+}
+
+/// @brief 默认实现上的工作模式，以及多线程的吞吐量
+template<typename TCryptor, std::size_t NBytes>
+void bench_modes(Bench& bench, Buffers& buffers) {
+    const auto key = bench_key<NBytes>();
+    const TCryptor cryptor{key};
+    const TCryptor tweak_cryptor{bench_key<NBytes>(11)};
+    constexpr std::array<std::byte, 12> iv{};
+    const auto bits = std::to_string(NBytes * 8);
+    Result base{};
+    base.engine = details::engine_name(details::active_engine());
+    base.key_bits = NBytes * 8;
+    const auto max_size = bench.config().max_size;
+
+    const auto mode = [&](const std::string& op, const std::size_t size, const auto& func) {
+        if (size > max_size) return;
+        auto result = base;
+        result.group = "mode";
+        result.op = op;
+        result.name = "mode/" + op + "/" + bits + "/" + size_name(size);
+        result.bytes = size;
+        const std::span<const std::byte> in{buffers.in.data(), size};
+        const std::span out{buffers.out.data(), size};
+        bench.measure(result, 1, [&] { func(in, out); });
+    };
+    for (const std::size_t size: {std::size_t{4096}, std::size_t{1024 * 1024}, std::size_t{16 * 1024 * 1024}}) {
+        mode("ctr", size, [&](const auto in, const auto out) { CtrCryptor<TCryptor>{cryptor, block_t{}}.apply(in, out); });
+        mode("cbc-encrypt", size, [&](const auto in, const auto out) { CbcCryptor<TCryptor>{cryptor, block_t{}}.encrypt(in, out); });
+        mode("cbc-decrypt", size, [&](const auto in, const auto out) { CbcCryptor<TCryptor>{cryptor, block_t{}}.decrypt(in, out); });
+        mode("gcm-encrypt", size, [&](const auto in, const auto out) {
+            GcmCryptor<TCryptor> gcm{cryptor};
+            gcm.start(iv);
+            gcm.encrypt(in, out);
+            static_cast<void>(gcm.finish());
+        });
+        mode("xts-encrypt", size, [&](const auto in, const auto out) {
+            XtsCryptor<TCryptor>{cryptor, tweak_cryptor}.encrypt_sectors(0, in, out, 4096, 1);
+        });
+    }
+
+    if (max_size >= 1024 * 64) {
+        // 64 字节短消息的 CMAC ，逐条计算受轮函数延迟限制，compute_many 交错多条消息；每次操作为一条消息
+        constexpr std::size_t count = 1024;
+        CmacCryptor<TCryptor> cmac{cryptor};
+        std::vector<CmacMessage> messages(count);
+        for (std::size_t i = 0; i < count; ++i) messages[i].data = std::span<const std::byte>{buffers.in.data() + i * 64, 64};
+        auto result = base;
+        result.group = "mode";
+        result.bytes = 64;
+        result.op = "cmac";
+        result.name = "mode/cmac/" + bits + "/64B";
+        bench.measure(result, count, [&] {
+            for (auto& message: messages) message.tag = cmac.compute(message.data);
+        });
+        result.op = "cmac-many";
+        result.name = "mode/cmac-many/" + bits + "/64B";
+        bench.measure(result, count, [&] { cmac.compute_many(messages); });
+    }
+
+    // 多线程只测最大的消息
+    const auto size = std::min<std::size_t>(max_size, 64 * 1024 * 1024);
+    const std::span in{buffers.in.data(), size};
+    const std::span out{buffers.out.data(), size};
+    for (const auto threads: bench.config().threads) {
+        Executor executor{{.threads = threads}};
+        auto result = base;
+        result.group = "threads";
+        result.bytes = size;
+        result.threads = threads;
+        result.op = "encrypt";
+        result.name = "threads/encrypt/" + bits + "/" + size_name(size) + "/t" + std::to_string(threads);
+        bench.measure(result, 1, [&] { encrypt_blocks(cryptor, in, out, executor); });
+        result.op = "ctr";
+        result.name = "threads/ctr/" + bits + "/" + size_name(size) + "/t" + std::to_string(threads);
+        bench.measure(result, 1, [&] { CtrCryptor<TCryptor>{cryptor, block_t{}}.apply_parallel(in, out, executor); });
+    }
+}
+
+template<std::size_t NWord, std::size_t NRound>
+void bench_key_size(Bench& bench, Buffers& buffers) {
+    constexpr auto bytes = NWord * 4;
+    const auto max_size = bench.config().max_size;
+    bench_engine<Cryptor<NWord, NRound>, bytes>(bench, buffers, std::string{"dispatch-"} + details::engine_name(details::active_engine()), max_size);
+    bench_engine<TableCryptor<NWord, NRound>, bytes>(bench, buffers, "table", max_size);
+    bench_engine<BitsliceCryptor<NWord, NRound>, bytes>(bench, buffers, "bitslice", max_size);
+    bench_engine<VpermCryptor<NWord, NRound>, bytes>(bench, buffers, "vperm", max_size);
+    bench_engine<ReferenceCryptor<NWord, NRound>, bytes>(bench, buffers, "reference", std::min<std::size_t>(max_size, 1024 * 1024));
+    bench_modes<Cryptor<NWord, NRound>, bytes>(bench, buffers);
+}
+
+/// @brief SHA-256 的单条消息吞吐量、可移植实现和 Merkle 树哈希
+void bench_sha(Bench& bench, Buffers& buffers) {
+    Result base{};
+    base.group = "sha";
+    base.engine = details::cpu_features().sha ? "sha-ni" : "portable";
+    const auto max_size = bench.config().max_size;
+
+    const auto sha = [&](const std::string& op, const std::string& engine, const std::size_t size, const auto& func) {
+        if (size > max_size) return;
+        auto result = base;
+        result.op = op;
+        if (!engine.empty()) result.engine = engine;
+        result.name = "sha/" + op + "/" + size_name(size);
+        result.bytes = size;
+        const std::span<const std::byte> data{buffers.in.data(), size};
+        bench.measure(result, 1, [&] { func(data); });
+    };
+    for (const std::size_t size: {std::size_t{64}, std::size_t{4096}, std::size_t{1024 * 1024}, std::size_t{16 * 1024 * 1024}}) {
+        sha("sha256", "", size, [](const auto data) { static_cast<void>(cango::sha::SHA256::hash(data)); });
+    }
+    sha("sha256-portable", "portable", 1024 * 1024, [](const auto data) {
+        std::array<std::uint32_t, 8> state{};
+        cango::sha::details::compress_portable(state, reinterpret_cast<const std::uint8_t*>(data.data()), data.size() / 64);
+    });
+    {
+        // 多缓冲实现一次处理 1024 条 64 字节消息，每次操作为一条消息
+        constexpr std::size_t count = 1024;
+        auto result = base;
+        result.op = "sha256-many";
+        result.name = "sha/sha256-many/64B";
+        result.bytes = 64;
+        std::vector<std::span<const std::byte>> messages(count);
+        for (std::size_t i = 0; i < count; ++i) messages[i] = std::span<const std::byte>{buffers.in.data() + i * 64, 64};
+        std::vector<cango::sha::SHA256::digest_t> digests(count);
+        if (count * 64 <= max_size) bench.measure(result, count, [&] { cango::sha::sha256_many(messages, digests); });
+    }
+    {
+        // 由同一个 PRK 批量派生 AES-256 主钥，每次操作为一个密钥
+        constexpr std::size_t count = 1024;
+        auto result = base;
+        result.op = "hkdf-expand-many";
+        result.name = "sha/hkdf-expand-many/32B";
+        constexpr std::array<std::byte, 32> ikm{};
+        const cango::sha::Hkdf hkdf{cango::sha::Hkdf::extract({}, ikm)};
+        std::vector<std::array<std::byte, 8>> ids(count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t j = 0; j < 8; ++j) ids[i][j] = static_cast<std::byte>(i >> (8 * j));
+        const std::vector<std::span<const std::byte>> infos(ids.begin(), ids.end());
+        std::vector<std::byte> keys(count * 32);
+        bench.measure(result, count, [&] { hkdf.expand_many(infos, keys, 32); });
+    }
+    sha("merkle", "", 64 * 1024 * 1024, [](const auto data) { static_cast<void>(cango::sha::MerkleTree::build(data)); });
+}
+
+void write_json(std::FILE* file, const std::vector<Result>& results) {
+    const auto& features = details::cpu_features();
+    std::fprintf(file, "{\n  \"engine\": \"%s\",\n", details::engine_name(details::active_engine()));
+    std::fprintf(file, "  \"cpu\": {\"aes\": %d, \"ssse3\": %d, \"avx2\": %d, \"avx512f\": %d},\n",
+                 features.aes, features.ssse3, features.avx2, features.avx512f);
+    std::fprintf(file, "  \"hardware_concurrency\": %u,\n  \"results\": [\n", std::thread::hardware_concurrency());
+    // 每项结果占一行，基线比较按行读取
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"group\": \"%s\", \"engine\": \"%s\", \"key_bits\": %zu, \"op\": \"%s\", "
+                           "\"bytes\": %zu, \"threads\": %zu, \"ns_per_op\": %.3f",
+                     r.name.c_str(), r.group.c_str(), r.engine.c_str(), r.key_bits, r.op.c_str(), r.bytes, r.threads, r.ns_per_op);
+        if (r.bytes != 0) std::fprintf(file, ", \"gb_per_s\": %.4f", static_cast<double>(r.bytes) / r.ns_per_op);
+        if (r.cycles_per_op >= 0) {
+            std::fprintf(file, ", \"cycles_per_op\": %.1f", r.cycles_per_op);
+            if (r.bytes != 0) std::fprintf(file, ", \"cycles_per_byte\": %.4f", r.cycles_per_op / static_cast<double>(r.bytes));
+        }
+        std::fprintf(file, "}%s\n", i + 1 == results.size() ? "" : ",");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+/// @brief 读取本工具写出的 JSON 中每项的名称和每次操作的纳秒数
+std::map<std::string, double> read_baseline(const char* path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file{path};
+    std::string line;
+    while (std::getline(file, line)) {
+        constexpr std::string_view name_key = "\"name\": \"";
+        constexpr std::string_view time_key = "\"ns_per_op\": ";
+        const auto name = line.find(name_key);
+        const auto time = line.find(time_key);
+        if (name == std::string::npos || time == std::string::npos) continue;
+        const auto begin = name + name_key.size();
+        const auto end = line.find('"', begin);
+        if (end == std::string::npos) continue;
+        baseline[line.substr(begin, end - begin)] = std::strtod(line.c_str() + time + time_key.size(), nullptr);
+    }
+    return baseline;
+}
+
+/// @brief 每次操作的时间比基线慢超过容差的项视为退化
+/// @return 退化的项数
+std::size_t compare_baseline(const std::map<std::string, double>& baseline, const std::vector<Result>& results, const double tolerance) {
+    std::size_t compared = 0;
+    std::size_t regressions = 0;
+    for (const auto& result: results) {
+        const auto found = baseline.find(result.name);
+        if (found == baseline.end() || found->second <= 0) continue;
+        ++compared;
+        const auto ratio = result.ns_per_op / found->second;
+        if (ratio <= 1 + tolerance) continue;
+        ++regressions;
+        std::fprintf(stderr, "性能退化：%s 从 %.1f ns 变为 %.1f ns (慢 %.1f%%)\n", result.name.c_str(), found->second, result.ns_per_op,
+                     (ratio - 1) * 100);
+    }
+    std::printf("与基线比较了 %zu 项，%zu 项退化(容差 %.0f%%)\n", compared, regressions, tolerance * 100);
+    return regressions;
+}
+
+bool parse_threads(const char* text, std::vector<std::size_t>& threads) {
+    threads.clear();
+    for (const char* p = text; *p != '\0';) {
+        char* end = nullptr;
+        const auto n = std::strtoull(p, &end, 10);
+        if (end == p || n == 0) return false;
+        threads.push_back(static_cast<std::size_t>(n));
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return false;
+    }
+    return !threads.empty();
+}
+
+/// @brief 默认的线程数：1, 2, 4, ... 直到硬件并发数
+std::vector<std::size_t> default_threads() {
+    const auto hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<std::size_t> threads;
+    for (std::size_t n = 1; n < hardware; n *= 2) threads.push_back(n);
+    threads.push_back(hardware);
+    return threads;
+}
+
+}
+
+int main(const int argc, char** argv) {
+    Options options{};
+    options.threads = default_threads();
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        bool valid = true;
+        if (arg == "--json") valid = (options.json = value()) != nullptr;
+        else if (arg == "--baseline") valid = (options.baseline = value()) != nullptr;
+        else if (arg == "--tolerance") valid = (v = value()) != nullptr && (options.tolerance = std::strtod(v, nullptr)) >= 0;
+        else if (arg == "--filter") valid = (v = value()) != nullptr && (options.filter = v, true);
+        else if (arg == "--min-time") valid = (v = value()) != nullptr && (options.min_time = std::strtod(v, nullptr)) > 0;
+        else if (arg == "--max-size") valid = (v = value()) != nullptr && (options.max_size = std::strtoull(v, nullptr, 10)) >= 16;
+        else if (arg == "--threads") valid = (v = value()) != nullptr && parse_threads(v, options.threads);
+        else if (arg == "--ghz") valid = (v = value()) != nullptr && (options.ghz = std::strtod(v, nullptr)) > 0;
+        else valid = false;
+        if (!valid) {
+            std::fprintf(stderr, "用法：%s [--json <文件>] [--baseline <文件>] [--tolerance <比例>] [--filter <子串>]\n"
+                                 "         [--min-time <秒>] [--max-size <字节>] [--threads <n,n,...>] [--ghz <频率>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Bench bench{options};
+    Buffers buffers{std::min<std::size_t>(options.max_size, 64 * 1024 * 1024)};
+    std::printf("默认实现：%s，周期数：%s\n", details::engine_name(details::active_engine()),
+                options.ghz > 0 ? "按给定频率换算" : CANGO_AES_X86 ? "时间戳计数器" : "不可用");
+    bench_key_size<4, 10>(bench, buffers);
+    bench_key_size<6, 12>(bench, buffers);
+    bench_key_size<8, 14>(bench, buffers);
+    bench_sha(bench, buffers);
+
+    if (options.json) {
+        std::FILE* file = std::fopen(options.json, "w");
+        if (!file) {
+            std::fprintf(stderr, "无法写入 %s\n", options.json);
+            return 1;
+        }
+        write_json(file, bench.all());
+        std::fclose(file);
+    }
+    if (options.baseline) {
+        const auto baseline = read_baseline(options.baseline);
+        if (baseline.empty()) {
+            std::fprintf(stderr, "无法读取基线 %s\n", options.baseline);
+            return 1;
+        }
+        if (compare_baseline(baseline, bench.all(), options.tolerance) != 0) return 1;
+    }
+    return 0;
+}
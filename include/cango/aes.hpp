@@ -2,5 +2,15 @@
 #define CANGO_AES
 
 #include "aes/cryptor.hpp"
+#include "aes/async.hpp"
+#include "aes/cache.hpp"
+#include "aes/cbc.hpp"
+#include "aes/cmac.hpp"
+#include "aes/ctr.hpp"
+#include "aes/ecb.hpp"
+#include "aes/executor.hpp"
+#include "aes/gcm.hpp"
+#include "aes/stream.hpp"
+#include "aes/xts.hpp"
 
 #endif//CANGO_AES
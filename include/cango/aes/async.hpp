@@ -0,0 +1,321 @@
+#ifndef INCLUDE_CANGO_AES_ASYNC
+#define INCLUDE_CANGO_AES_ASYNC
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace cango::aes {
+
+/// @brief 异步线程池的选项
+struct AsyncExecutorOptions {
+    /// @brief 工作线程数，为 0 时使用硬件并发数；提交任务的线程不参与计算
+    std::size_t threads = 0;
+
+    /// @brief 每段的最大字节数，一个操作被切成若干段，由多个工作线程同时处理
+    std::size_t chunk_bytes = 256 * 1024;
+
+    /// @brief 已放行但尚未完成的操作的字节数上限
+    /// @details 超出时新的操作挂起排队，不阻塞调用线程；单个超过上限的操作在线程池空闲时单独放行
+    std::size_t max_inflight_bytes = 16 * 1024 * 1024;
+
+    /// @brief 小于该字节数的操作在 co_await 处直接执行，不切换线程
+    std::size_t inline_bytes = 16 * 1024;
+};
+
+/// @brief 异步操作的结果
+struct AsyncResult {
+    /// @brief 已完成的单位数，加密和解密时为块数；取消时只包括已完成的段
+    std::size_t units = 0;
+
+    /// @brief 是否因取消而跳过了部分段，此时输出中只有已完成的段有效
+    bool cancelled = false;
+};
+
+namespace details {
+
+/// @brief 一次异步操作，保存在等待它的协程帧中，线程池只保存其地址
+struct AsyncJob {
+    void (*invoke)(const void* func, std::size_t begin, std::size_t n) = nullptr;
+    const void* func = nullptr;
+    std::size_t units = 0;
+    std::size_t bytes = 0;
+
+    /// @brief 每段的单位数，最后一段可能更短
+    std::size_t chunk = 0;
+
+    /// @brief 段数
+    std::size_t count = 0;
+
+    std::stop_token stop;
+    std::coroutine_handle<> continuation;
+
+    /// @brief 下一个被领取的段，只在线程池的锁内访问
+    std::size_t next = 0;
+
+    std::atomic<std::size_t> finished{0};
+    std::atomic<std::size_t> done{0};
+    std::atomic<bool> skipped{false};
+};
+
+}
+
+template<typename TFunc>
+class AsyncOperation;
+
+/// @brief 供协程使用的有界加密线程池
+/// @details 操作以 co_await 提交，调用线程(如事件循环)随即返回处理其他协程，不等待计算。
+/// 已放行的操作按先后顺序被切成段，空闲的工作线程依次领取；放行的总字节数受 max_inflight_bytes 限制，
+/// 超出时后来的操作挂起排队，形成背压。最后完成一段的工作线程恢复等待的协程，
+/// 需要回到事件循环线程的调用方应在恢复后自行调度。线程池必须比所有未完成的操作存活更久。
+class AsyncExecutor {
+    AsyncExecutorOptions options;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    /// @brief 已放行且还有未领取段的操作
+    std::deque<details::AsyncJob*> ready;
+
+    /// @brief 等待放行的操作
+    std::deque<details::AsyncJob*> waiting;
+
+    std::size_t inflight = 0;
+    bool stopping = false;
+
+    std::vector<std::jthread> workers;
+
+    template<typename TFunc>
+    friend class AsyncOperation;
+
+public:
+    explicit AsyncExecutor(const AsyncExecutorOptions& options = {}) : options(options) {
+        auto threads = options.threads;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) workers.emplace_back([this] { work(); });
+    }
+
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    ~AsyncExecutor() {
+        {
+            const std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        wake.notify_all();
+    }
+
+    /// @brief 工作线程数
+    [[nodiscard]] std::size_t concurrency() const noexcept {
+        return workers.size();
+    }
+
+    /// @brief 已放行但尚未完成的字节数
+    [[nodiscard]] std::size_t inflight_bytes() {
+        const std::lock_guard lock{mutex};
+        return inflight;
+    }
+
+    /// @brief 创建一个异步操作，co_await 时提交，完成后得到 AsyncResult
+    /// @param units 总单位数
+    /// @param unitBytes 每个单位的字节数，用于切分和背压
+    /// @param func 以 (起始单位, 单位数) 调用，可能在多个工作线程上同时调用
+    /// @param stop 请求停止后，尚未开始的段被跳过，排队中的操作立即完成
+    template<typename TFunc>
+    [[nodiscard]] AsyncOperation<TFunc> run_async(std::size_t units, std::size_t unitBytes, TFunc func, std::stop_token stop = {});
+
+private:
+    /// @brief 按提交顺序放行，直到超出字节数上限；线程池空闲时总是放行队首
+    void admit() {
+        while (!waiting.empty()) {
+            auto* job = waiting.front();
+            if (inflight != 0 && inflight + job->bytes > options.max_inflight_bytes) return;
+            waiting.pop_front();
+            inflight += job->bytes;
+            ready.push_back(job);
+        }
+    }
+
+    void submit(details::AsyncJob& job) {
+        {
+            const std::lock_guard lock{mutex};
+            if (job.stop.stop_requested()) {
+                // 已取消的操作不占用字节数，只需要一个工作线程跳过各段后恢复协程
+                job.bytes = 0;
+                ready.push_back(&job);
+            }
+            else {
+                waiting.push_back(&job);
+                admit();
+            }
+        }
+        wake.notify_all();
+    }
+
+    /// @brief 取消排队中的操作；已放行的操作由工作线程在领取每段时检查
+    void cancel(details::AsyncJob& job) {
+        {
+            const std::lock_guard lock{mutex};
+            const auto it = std::ranges::find(waiting, &job);
+            if (it == waiting.end()) return;
+            waiting.erase(it);
+            job.bytes = 0;
+            ready.push_back(&job);
+        }
+        wake.notify_one();
+    }
+
+    void work() {
+        while (true) {
+            details::AsyncJob* job;
+            std::size_t index;
+            {
+                std::unique_lock lock{mutex};
+                wake.wait(lock, [this] { return stopping || !ready.empty(); });
+                if (stopping) return;
+                job = ready.front();
+                index = job->next++;
+                if (job->next == job->count) ready.pop_front();
+            }
+
+            const auto begin = index * job->chunk;
+            const auto n = std::min(job->chunk, job->units - begin);
+            if (job->stop.stop_requested()) job->skipped.store(true, std::memory_order_relaxed);
+            else {
+                job->invoke(job->func, begin, n);
+                job->done.fetch_add(n, std::memory_order_relaxed);
+            }
+            if (job->finished.fetch_add(1, std::memory_order_acq_rel) + 1 == job->count) complete(*job);
+        }
+    }
+
+    /// @brief 释放字节数并放行排队的操作，然后恢复协程；恢复后 job 可能已被销毁
+    void complete(details::AsyncJob& job) {
+        const auto continuation = job.continuation;
+        {
+            const std::lock_guard lock{mutex};
+            inflight -= job.bytes;
+            admit();
+        }
+        wake.notify_all();
+        continuation.resume();
+    }
+};
+
+/// @brief 可等待的异步操作，由 AsyncExecutor::run_async 创建，应当立即 co_await
+/// @details 操作的状态保存在自身中，随 co_await 表达式存放在协程帧里，提交时不分配内存。
+/// func 只在 co_await 时执行，调用方需要保证其引用的数据在那之前有效。
+template<typename TFunc>
+class AsyncOperation {
+    /// @brief 停止请求的回调，把排队中的操作移出队列
+    struct Cancel {
+        AsyncExecutor* executor;
+        details::AsyncJob* job;
+
+        void operator()() const noexcept {
+            executor->cancel(*job);
+        }
+    };
+
+    AsyncExecutor* executor;
+    TFunc func;
+    details::AsyncJob job;
+    std::optional<std::stop_callback<Cancel>> on_stop;
+    AsyncResult result{};
+
+public:
+    AsyncOperation(AsyncExecutor& executor, const std::size_t units, const std::size_t unitBytes, TFunc func, std::stop_token stop)
+        : executor(&executor), func(std::move(func)) {
+        constexpr auto invoke = [](const void* f, const std::size_t begin, const std::size_t n) {
+            (*static_cast<const TFunc*>(f))(begin, n);
+        };
+        job.invoke = invoke;
+        job.func = &this->func;
+        job.units = units;
+        job.bytes = units * unitBytes;
+        job.chunk = std::max<std::size_t>(executor.options.chunk_bytes / std::max<std::size_t>(unitBytes, 1), 1);
+        job.count = (units + job.chunk - 1) / job.chunk;
+        job.stop = std::move(stop);
+    }
+
+    AsyncOperation(const AsyncOperation&) = delete;
+    AsyncOperation& operator=(const AsyncOperation&) = delete;
+
+    /// @brief 已取消、没有数据或数据量小于 inline_bytes 时不挂起
+    bool await_ready() {
+        if (job.units == 0) return true;
+        if (job.stop.stop_requested()) {
+            result.cancelled = true;
+            return true;
+        }
+        if (job.bytes >= executor->options.inline_bytes) return false;
+        func(std::size_t{0}, job.units);
+        result.units = job.units;
+        return true;
+    }
+
+    /// @brief 先登记停止回调再提交，提交后协程可能已在工作线程上恢复，不再访问自身
+    void await_suspend(const std::coroutine_handle<> continuation) {
+        job.continuation = continuation;
+        on_stop.emplace(job.stop, Cancel{executor, &job});
+        executor->submit(job);
+    }
+
+    AsyncResult await_resume() noexcept {
+        if (!job.continuation) return result;
+        return {job.done.load(std::memory_order_relaxed), job.skipped.load(std::memory_order_relaxed)};
+    }
+};
+
+template<typename TFunc>
+AsyncOperation<TFunc> AsyncExecutor::run_async(const std::size_t units, const std::size_t unitBytes, TFunc func, std::stop_token stop) {
+    return {*this, units, unitBytes, std::move(func), std::move(stop)};
+}
+
+/// @brief 在异步线程池上加密多个块，co_await 得到的单位数为块数
+/// @details 与 Cryptor::encrypt_blocks 相同，只处理完整的块；in 和 out 在 co_await 完成前必须有效
+template<typename TCryptor>
+auto encrypt_async(const TCryptor& cryptor, const std::span<const std::byte> in, const std::span<std::byte> out, AsyncExecutor& executor,
+                   std::stop_token stop = {}) {
+    const auto count = std::min(in.size(), out.size()) / 16;
+    return executor.run_async(count, 16, [&cryptor, in, out](const std::size_t begin, const std::size_t n) {
+        cryptor.encrypt_blocks(in.subspan(begin * 16, n * 16), out.subspan(begin * 16, n * 16));
+    }, std::move(stop));
+}
+
+/// @brief 在异步线程池上原地加密多个块
+template<typename TCryptor>
+auto encrypt_async(const TCryptor& cryptor, const std::span<std::byte> data, AsyncExecutor& executor, std::stop_token stop = {}) {
+    return encrypt_async(cryptor, data, data, executor, std::move(stop));
+}
+
+/// @brief 在异步线程池上解密多个块，co_await 得到的单位数为块数
+template<typename TCryptor>
+auto decrypt_async(const TCryptor& cryptor, const std::span<const std::byte> in, const std::span<std::byte> out, AsyncExecutor& executor,
+                   std::stop_token stop = {}) {
+    const auto count = std::min(in.size(), out.size()) / 16;
+    return executor.run_async(count, 16, [&cryptor, in, out](const std::size_t begin, const std::size_t n) {
+        cryptor.decrypt_blocks(in.subspan(begin * 16, n * 16), out.subspan(begin * 16, n * 16));
+    }, std::move(stop));
+}
+
+/// @brief 在异步线程池上原地解密多个块
+template<typename TCryptor>
+auto decrypt_async(const TCryptor& cryptor, const std::span<std::byte> data, AsyncExecutor& executor, std::stop_token stop = {}) {
+    return decrypt_async(cryptor, data, data, executor, std::move(stop));
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_ASYNC
@@ -0,0 +1,278 @@
+#ifndef INCLUDE_CANGO_AES_CACHE
+#define INCLUDE_CANGO_AES_CACHE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cango::aes {
+
+/// @brief 密钥缓存的选项
+struct KeyCacheOptions {
+    /// @brief 最多缓存的密钥数，向上取整到 shards * ways 的倍数
+    std::size_t capacity = 4096;
+
+    /// @brief 分片数，每个分片有独立的写锁和计数器
+    std::size_t shards = 16;
+};
+
+/// @brief 密钥缓存的计数，用于评估容量是否合适
+struct KeyCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+
+    /// @brief 因容量不足被换出的密钥数，不包括 erase 和 clear
+    std::uint64_t evictions = 0;
+};
+
+namespace details {
+
+/// @brief 清零一段内存，不会被编译器当作死存储而删除
+inline void secure_zero(void* data, const std::size_t size) noexcept {
+    auto* bytes = static_cast<volatile std::uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i) bytes[i] = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+}
+
+/// @brief 线程安全的已扩展密钥缓存，把密钥标识映射到共享的只读密码工具
+/// @details 密码工具在扩展密钥时已同时生成加密轮密钥和等价逆密码的解密轮密钥，取出后两者都可以直接使用。
+/// 标识的哈希选择分片和组，每组 ways 个槽位，组满时按 CLOCK 换出最近未被访问的槽位。
+/// 读路径不取互斥锁：先比较槽位中的哈希标签，命中后登记为该槽位的读者，读出缓存项指针并核对标识，取得共享引用；
+/// 只有未命中时才在分片的锁内扩展并插入。替换槽位的线程换上新指针后等待该槽位的读者离开，
+/// 再释放槽位对旧缓存项的引用，因此读者不会访问已释放的缓存项。被换出或删除的密钥在最后一个使用者释放后清零。
+/// @tparam TCryptor 密码工具类型，如 AES256Cryptor
+/// @tparam TKeyId 密钥标识类型，需要可比较相等
+template<typename TCryptor, typename TKeyId = std::uint64_t, typename THash = std::hash<TKeyId>>
+class KeyCache {
+public:
+    /// @brief 每组的槽位数
+    static constexpr std::size_t ways = 8;
+
+    using handle_t = std::shared_ptr<const TCryptor>;
+
+private:
+    /// @brief 不可变的缓存项，析构时清零轮密钥
+    /// @details 直接从主钥构造密码工具，轮密钥只在缓存项内扩展一次，栈上不会留下未清零的副本。
+    struct Entry : std::enable_shared_from_this<Entry> {
+        TKeyId id;
+        TCryptor cryptor;
+
+        template<std::size_t NBytes>
+        Entry(const TKeyId& id, const std::array<std::uint8_t, NBytes>& mainKey) : id(id), cryptor(mainKey) {}
+
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        ~Entry() {
+            details::secure_zero(&cryptor, sizeof(cryptor));
+        }
+    };
+
+    struct Slot {
+        /// @brief 哈希标签，0 表示空槽位；读者先比较标签，避免逐个取出共享指针
+        std::atomic<std::size_t> tag{0};
+
+        /// @brief CLOCK 的访问位，命中时置位，换出时扫过的槽位被清除
+        std::atomic<bool> referenced{false};
+
+        /// @brief 正在读取 entry 的读者数
+        std::atomic<std::uint32_t> readers{0};
+
+        std::atomic<const Entry*> entry{nullptr};
+
+        /// @brief 槽位对缓存项的引用，只在分片的锁内访问
+        std::shared_ptr<const Entry> owner;
+    };
+
+    struct alignas(64) Shard {
+        /// @brief 只在插入、换出、删除时持有
+        std::mutex mutex;
+
+        std::unique_ptr<Slot[]> slots;
+
+        /// @brief 每组 CLOCK 指针的位置，只在锁内访问
+        std::unique_ptr<std::uint8_t[]> hands;
+
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> evictions{0};
+    };
+
+    THash hasher{};
+    std::size_t groups_per_shard;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+public:
+    explicit KeyCache(const KeyCacheOptions& options = {}) {
+        const auto shard_count = std::max<std::size_t>(options.shards, 1);
+        groups_per_shard = std::max<std::size_t>((options.capacity + shard_count * ways - 1) / (shard_count * ways), 1);
+        shards.reserve(shard_count);
+        for (std::size_t i = 0; i < shard_count; ++i) {
+            auto shard = std::make_unique<Shard>();
+            shard->slots = std::make_unique<Slot[]>(groups_per_shard * ways);
+            shard->hands = std::make_unique<std::uint8_t[]>(groups_per_shard);
+            shards.push_back(std::move(shard));
+        }
+    }
+
+    KeyCache(const KeyCache&) = delete;
+    KeyCache& operator=(const KeyCache&) = delete;
+
+    /// @brief 最多缓存的密钥数
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return shards.size() * groups_per_shard * ways;
+    }
+
+    /// @brief 查找已缓存的密码工具，未命中时返回空
+    [[nodiscard]] handle_t find(const TKeyId& id) const noexcept {
+        const auto hash = hasher(id);
+        auto& shard = shard_of(hash);
+        auto result = lookup(shard, group_of(hash), tag_of(hash), id);
+        (result ? shard.hits : shard.misses).fetch_add(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    /// @brief 查找密码工具，未命中时以 make_key() 返回的主钥扩展并插入
+    /// @details make_key 只在未命中时调用，调用时持有该分片的锁，应当只取得密钥，不要再访问缓存。
+    /// 组满时换出一个最近未被访问的密钥；已取出的句柄不受影响，直到释放后才清零。
+    template<typename TMakeKey>
+    handle_t find_or_insert(const TKeyId& id, const TMakeKey& make_key) {
+        const auto hash = hasher(id);
+        auto& shard = shard_of(hash);
+        const auto group = group_of(hash);
+        const auto tag = tag_of(hash);
+        if (auto result = lookup(shard, group, tag, id)) {
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+        const std::lock_guard lock{shard.mutex};
+        // 其他线程可能已经插入了同一个密钥
+        if (auto result = lookup(shard, group, tag, id)) return result;
+        auto key = make_key();
+        std::shared_ptr<const Entry> entry = std::make_shared<Entry>(id, key);
+        details::secure_zero(key.data(), key.size());
+
+        auto& slot = choose_victim(shard, group);
+        if (slot.owner) shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        // 先清除标签，读者不会把旧标签与新项配对；即使配对，也会因为标识不同而视为未命中
+        slot.tag.store(0, std::memory_order_release);
+        replace(slot, entry);
+        slot.referenced.store(true, std::memory_order_relaxed);
+        slot.tag.store(tag, std::memory_order_release);
+        const auto* cryptor = &entry->cryptor;
+        return {std::move(entry), cryptor};
+    }
+
+    /// @brief 查找密码工具，未命中时以给定的主钥扩展并插入
+    template<std::size_t NBytes>
+    handle_t find_or_insert(const TKeyId& id, const std::array<std::uint8_t, NBytes>& mainKey) {
+        return find_or_insert(id, [&mainKey] { return mainKey; });
+    }
+
+    /// @brief 删除一个密钥，如会话结束或密钥被吊销
+    /// @return 密钥是否在缓存中
+    bool erase(const TKeyId& id) {
+        const auto hash = hasher(id);
+        auto& shard = shard_of(hash);
+        const std::lock_guard lock{shard.mutex};
+        auto* slots = shard.slots.get() + group_of(hash) * ways;
+        for (std::size_t way = 0; way < ways; ++way) {
+            auto& slot = slots[way];
+            if (!slot.owner || !(slot.owner->id == id)) continue;
+            slot.tag.store(0, std::memory_order_release);
+            replace(slot, nullptr);
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief 删除所有密钥，计数不变
+    void clear() {
+        for (const auto& shard: shards) {
+            const std::lock_guard lock{shard->mutex};
+            for (std::size_t i = 0; i < groups_per_shard * ways; ++i) {
+                shard->slots[i].tag.store(0, std::memory_order_release);
+                replace(shard->slots[i], nullptr);
+            }
+        }
+    }
+
+    /// @brief 各分片计数之和
+    [[nodiscard]] KeyCacheStats stats() const noexcept {
+        KeyCacheStats result{};
+        for (const auto& shard: shards) {
+            result.hits += shard->hits.load(std::memory_order_relaxed);
+            result.misses += shard->misses.load(std::memory_order_relaxed);
+            result.evictions += shard->evictions.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    [[nodiscard]] Shard& shard_of(const std::size_t hash) const noexcept {
+        return *shards[hash % shards.size()];
+    }
+
+    [[nodiscard]] std::size_t group_of(const std::size_t hash) const noexcept {
+        return hash / shards.size() % groups_per_shard;
+    }
+
+    /// @brief 标签总是非 0 ，与空槽位区分
+    [[nodiscard]] static constexpr std::size_t tag_of(const std::size_t hash) noexcept {
+        return hash | 1;
+    }
+
+    static handle_t lookup(Shard& shard, const std::size_t group, const std::size_t tag, const TKeyId& id) noexcept {
+        auto* slots = shard.slots.get() + group * ways;
+        for (std::size_t way = 0; way < ways; ++way) {
+            auto& slot = slots[way];
+            if (slot.tag.load(std::memory_order_acquire) != tag) continue;
+            // 登记读者与读指针、替换指针与检查读者，两组操作都是顺序一致的，
+            // 读者要么读到新指针，要么被替换者看到并等待
+            slot.readers.fetch_add(1, std::memory_order_seq_cst);
+            const auto* entry = slot.entry.load(std::memory_order_seq_cst);
+            handle_t result;
+            if (entry && entry->id == id) result = {entry->shared_from_this(), &entry->cryptor};
+            slot.readers.fetch_sub(1, std::memory_order_release);
+            if (!result) continue;
+            if (!slot.referenced.load(std::memory_order_relaxed)) slot.referenced.store(true, std::memory_order_relaxed);
+            return result;
+        }
+        return nullptr;
+    }
+
+    /// @brief 在锁内替换槽位的缓存项，等待读者离开后才释放旧缓存项
+    static void replace(Slot& slot, std::shared_ptr<const Entry> entry) noexcept {
+        slot.entry.store(entry.get(), std::memory_order_seq_cst);
+        while (slot.readers.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+        slot.owner = std::move(entry);
+    }
+
+    /// @brief 优先选空槽位，否则转动 CLOCK 指针，清除经过的访问位，直到遇到未被访问的槽位
+    static Slot& choose_victim(Shard& shard, const std::size_t group) noexcept {
+        auto* slots = shard.slots.get() + group * ways;
+        for (std::size_t way = 0; way < ways; ++way)
+            if (!slots[way].owner) return slots[way];
+        auto& hand = shard.hands[group];
+        while (true) {
+            auto& slot = slots[hand];
+            hand = static_cast<std::uint8_t>((hand + 1) % ways);
+            if (!slot.referenced.exchange(false, std::memory_order_relaxed)) return slot;
+        }
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_CACHE
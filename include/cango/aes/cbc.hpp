@@ -0,0 +1,262 @@
+#ifndef INCLUDE_CANGO_AES_CBC
+#define INCLUDE_CANGO_AES_CBC
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "cryptor.hpp"
+#include "details/padding.hpp"
+#include "details/parallel.hpp"
+#include "details/segments.hpp"
+#include "executor.hpp"
+
+namespace cango::aes {
+
+/// @brief 多路交错加密中的一条独立 CBC 消息
+struct CbcStream {
+    /// @brief 链接值，开始时为 IV ，结束时为最后一个密文块，可以接着加密同一条消息的后续数据
+    block_t chain;
+
+    /// @brief 明文，只处理完整的块
+    std::span<const std::byte> in;
+
+    /// @brief 密文，可以与 in 是同一段内存，否则两者不能重叠
+    std::span<std::byte> out;
+};
+
+/// @brief 密码分组链接(CBC)模式
+/// @details 加密本质上是串行的，单条消息逐块调用 encrypt ；多条消息可以用 cbc_encrypt_streams 交错处理。
+/// 解密的每个明文块只依赖两个密文块，按 8 块一批走多块解密接口，大块数据还可以分给多个线程。
+/// 对象内保存链接值，同一条消息可以分多次处理，每次都只处理完整的块。
+/// @tparam TCryptor 密码工具类型，需要提供 encrypt_blocks, decrypt_blocks ，对象的生命周期必须长于本对象
+template<typename TCryptor>
+class CbcCryptor {
+    /// @brief 每批解密的块数
+    static constexpr std::size_t batch_blocks = 8;
+
+    /// @brief 多线程时每个线程至少处理的块数
+    static constexpr std::size_t min_blocks_per_thread = 16 * 1024;
+
+    const TCryptor* cryptor;
+
+    /// @brief 上一个密文块，开始时为 IV
+    block_t chain;
+
+public:
+    /// @param cryptor 已初始化的密码工具
+    /// @param iv 初始向量
+    constexpr CbcCryptor(const TCryptor& cryptor, const block_t& iv) noexcept
+        : cryptor(&cryptor), chain(iv) {}
+
+    /// @brief 用新的 IV 开始一条新消息，轮密钥不变
+    constexpr void reset(const block_t& iv) noexcept {
+        chain = iv;
+    }
+
+    /// @brief 加密完整的块
+    /// @param in 明文，只处理其中完整的块
+    /// @param out 密文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 写入的字节数，为 16 的倍数
+    std::size_t encrypt(const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        const auto count = std::min(in.size(), out.size()) / 16;
+        for (std::size_t i = 0; i < count; ++i) {
+            for (std::size_t j = 0; j < 16; ++j) chain[j] ^= static_cast<std::uint8_t>(in[i * 16 + j]);
+            cryptor->encrypt(chain);
+            std::memcpy(out.data() + i * 16, chain.data(), 16);
+        }
+        return count * 16;
+    }
+
+    /// @brief 原地加密完整的块
+    std::size_t encrypt(const std::span<std::byte> data) noexcept {
+        return encrypt(data, data);
+    }
+
+    /// @brief 解密完整的块，每 8 块一批
+    /// @param in 密文，只处理其中完整的块
+    /// @param out 明文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 写入的字节数，为 16 的倍数
+    std::size_t decrypt(const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        const auto count = std::min(in.size(), out.size()) / 16;
+        decrypt_blocks(*cryptor, chain, in.data(), out.data(), count);
+        return count * 16;
+    }
+
+    /// @brief 原地解密完整的块
+    std::size_t decrypt(const std::span<std::byte> data) noexcept {
+        return decrypt(data, data);
+    }
+
+    /// @brief 加密一串分段中的完整块，块可以跨越分段边界
+    /// @details 分段内的块直接在分段上处理，只有跨越边界的块经过栈上的 16 字节缓冲区
+    /// @param out 输出分段，切分方式可以与 in 不同，但不能与 in 部分重叠
+    /// @return 写入的字节数，为 16 的倍数；末尾不足一块的数据不处理
+    std::size_t encrypt_segments(const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+        return details::for_each_block_run(in, out, [this](const auto source, const auto target) { encrypt(source, target); });
+    }
+
+    /// @brief 原地加密一串分段
+    std::size_t encrypt_segments(const std::span<const std::span<std::byte>> data) noexcept {
+        return details::for_each_block_run(data, data, [this](const auto source, const auto target) { encrypt(source, target); });
+    }
+
+    /// @brief 解密一串分段中的完整块，参数与 encrypt_segments 相同
+    std::size_t decrypt_segments(const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+        return details::for_each_block_run(in, out, [this](const auto source, const auto target) { decrypt(source, target); });
+    }
+
+    /// @brief 原地解密一串分段
+    std::size_t decrypt_segments(const std::span<const std::span<std::byte>> data) noexcept {
+        return details::for_each_block_run(data, data, [this](const auto source, const auto target) { decrypt(source, target); });
+    }
+
+    /// @brief 与 decrypt 相同，但把数据分给多个线程
+    /// @param threads 线程数，为 0 时使用硬件并发数；数据较少时自动减少线程数
+    std::size_t decrypt_parallel(const std::span<const std::byte> in, const std::span<std::byte> out, const std::size_t threads = 0) {
+        const auto count = std::min(in.size(), out.size()) / 16;
+        return decrypt_chunks(in, out, details::plan_chunks(count, threads, min_blocks_per_thread),
+                              [](const auto&... args) { details::run_chunks(args...); });
+    }
+
+    /// @brief 原地并行解密
+    std::size_t decrypt_parallel(const std::span<std::byte> data, const std::size_t threads = 0) {
+        return decrypt_parallel(data, data, threads);
+    }
+
+    /// @brief 与 decrypt 相同，但交给线程池处理
+    std::size_t decrypt_parallel(const std::span<const std::byte> in, const std::span<std::byte> out, Executor& executor) {
+        const auto count = std::min(in.size(), out.size()) / 16;
+        return decrypt_chunks(in, out, executor.plan(count, 16), [&executor](const auto&... args) { executor.run(args...); });
+    }
+
+    /// @brief 用线程池原地解密
+    std::size_t decrypt_parallel(const std::span<std::byte> data, Executor& executor) {
+        return decrypt_parallel(data, data, executor);
+    }
+
+    /// @brief 加密消息的最后一段并按 PKCS#7 填充，不分配内存
+    /// @param in 明文，任意长度
+    /// @param out 密文，至少 in.size() / 16 * 16 + 16 字节，可以与 in 是同一段内存
+    /// @return 写入的字节数；out 不够大时不做任何处理并返回 0
+    std::size_t encrypt_padded(const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        const auto whole = in.size() / 16 * 16;
+        if (out.size() < whole + 16) return 0;
+        block_t last{};
+        std::memcpy(last.data(), in.data() + whole, in.size() - whole);
+        encrypt(in.first(whole), out);
+        details::pkcs7_pad(last, in.size() - whole);
+        encrypt(std::as_bytes(std::span{last}), out.subspan(whole));
+        return whole + 16;
+    }
+
+    /// @brief 解密消息的最后一段并去掉 PKCS#7 填充，填充以常数时间检查
+    /// @param in 密文，长度必须是 16 的正整数倍
+    /// @param out 明文，至少与 in 一样长，填充字节也会写入
+    /// @return 去掉填充后的明文长度；长度或填充无效时返回空
+    /// @note 向对端暴露填充是否有效会构成填充预言攻击，应与消息认证一起使用
+    std::optional<std::size_t> decrypt_padded(const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        if (in.empty() || in.size() % 16 != 0 || out.size() < in.size()) return std::nullopt;
+        decrypt(in, out);
+        const auto pad = details::pkcs7_padding_length(reinterpret_cast<const std::uint8_t*>(out.data()) + in.size() - 16);
+        if (pad == 0) return std::nullopt;
+        return in.size() - pad;
+    }
+
+private:
+    template<typename TRun>
+    std::size_t decrypt_chunks(const std::span<const std::byte> in, const std::span<std::byte> out, const details::ChunkPlan& plan, const TRun& run) {
+        if (plan.count <= 1) return decrypt(in, out);
+        const auto count = std::min(in.size(), out.size()) / 16;
+
+        // 原地解密时各段的第一个链接值会被前一段覆盖，需要在开始前取出
+        std::vector<block_t> chains(plan.count);
+        chains[0] = chain;
+        for (std::size_t index = 1; index < plan.count; ++index)
+            std::memcpy(chains[index].data(), in.data() + (index * plan.chunk - 1) * 16, 16);
+        std::memcpy(chain.data(), in.data() + (count - 1) * 16, 16);
+
+        run(plan, count, [&](const std::size_t index, const std::size_t begin, const std::size_t n) {
+            auto local = chains[index];
+            decrypt_blocks(*cryptor, local, in.data() + begin * 16, out.data() + begin * 16, n);
+        });
+        return count * 16;
+    }
+
+    /// @brief 解密 count 个块；原地解密时先保存每批的密文才能取到链接值，否则直接从 in 解密
+    static void decrypt_blocks(const TCryptor& cryptor, block_t& chain, const std::byte* in, std::byte* out, std::size_t count) noexcept {
+        const auto in_place = in == out;
+        std::array<std::byte, 16 * batch_blocks> saved;
+        while (count > 0) {
+            const auto n = std::min(count, batch_blocks);
+            auto source = in;
+            if (in_place) {
+                std::memcpy(saved.data(), in, n * 16);
+                source = saved.data();
+            }
+            cryptor.decrypt_blocks(std::span{source, n * 16}, std::span{out, n * 16});
+            for (std::size_t j = 0; j < 16; ++j) out[j] ^= static_cast<std::byte>(chain[j]);
+            for (std::size_t i = 16; i < n * 16; ++i) out[i] ^= source[i - 16];
+            std::memcpy(chain.data(), source + (n - 1) * 16, 16);
+            in += n * 16;
+            out += n * 16;
+            count -= n;
+        }
+    }
+};
+
+/// @brief 交错加密多条独立的 CBC 消息
+/// @details 每一步从最多 8 条消息中各取一块，一起走多块加密接口，使 AES 流水线保持满载；
+/// 某条消息结束后由下一条消息补上。不分配内存。
+/// @param streams 消息列表，每条消息的 chain 会更新为其最后一个密文块
+template<typename TCryptor>
+void cbc_encrypt_streams(const TCryptor& cryptor, const std::span<CbcStream> streams) noexcept {
+    constexpr std::size_t lanes = 8;
+    std::array<CbcStream*, lanes> lane{};
+    std::array<std::size_t, lanes> offset{};
+    std::size_t next = 0;
+    const auto refill = [&](const std::size_t l) {
+        lane[l] = nullptr;
+        while (next < streams.size() && lane[l] == nullptr) {
+            auto& stream = streams[next++];
+            if (std::min(stream.in.size(), stream.out.size()) >= 16) {
+                lane[l] = &stream;
+                offset[l] = 0;
+            }
+        }
+    };
+    for (std::size_t l = 0; l < lanes; ++l) refill(l);
+
+    std::array<std::byte, 16 * lanes> buffer;
+    std::array<std::size_t, lanes> owner{};
+    while (true) {
+        std::size_t n = 0;
+        for (std::size_t l = 0; l < lanes; ++l) {
+            if (lane[l] == nullptr) continue;
+            const auto& stream = *lane[l];
+            for (std::size_t j = 0; j < 16; ++j)
+                buffer[n * 16 + j] = stream.in[offset[l] + j] ^ static_cast<std::byte>(stream.chain[j]);
+            owner[n++] = l;
+        }
+        if (n == 0) break;
+
+        cryptor.encrypt_blocks(std::span{buffer}.first(n * 16));
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto l = owner[i];
+            auto& stream = *lane[l];
+            std::memcpy(stream.out.data() + offset[l], buffer.data() + i * 16, 16);
+            std::memcpy(stream.chain.data(), buffer.data() + i * 16, 16);
+            offset[l] += 16;
+            if (offset[l] + 16 > std::min(stream.in.size(), stream.out.size())) refill(l);
+        }
+    }
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_CBC
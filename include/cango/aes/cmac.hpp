@@ -0,0 +1,183 @@
+#ifndef INCLUDE_CANGO_AES_CMAC
+#define INCLUDE_CANGO_AES_CMAC
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "cryptor.hpp"
+#include "details/tag.hpp"
+#include "details/tweak.hpp"
+
+namespace cango::aes {
+
+/// @brief 批量计算 CMAC 时的一条消息
+struct CmacMessage {
+    /// @brief 消息，任意长度
+    std::span<const std::byte> data;
+
+    /// @brief 计算得到的 16 字节标签
+    block_t tag{};
+};
+
+/// @brief 基于分组密码的消息认证码 CMAC(RFC 4493, SP 800-38B)
+/// @details 子密钥 K1, K2 在构造时由 E(0) 倍乘得到，之后每条消息都直接使用。
+/// 单条消息依次调用 start, update(可多次), finish 或 verify ；内部只暂存一个块，因为最后一块需要与子密钥异或，
+/// 在后续数据到来之前不能确定它是不是最后一块。
+/// 单条消息的 CBC-MAC 链是串行的，受轮函数延迟限制；compute_many 把多条互不相关的消息交错到多块接口的流水线中。
+/// @tparam TCryptor 密码工具类型，需要提供 encrypt_blocks ，对象的生命周期必须长于本对象
+template<typename TCryptor>
+class CmacCryptor {
+    /// @brief compute_many 同时处理的消息数
+    static constexpr std::size_t lanes = 8;
+
+    const TCryptor* cryptor;
+
+    /// @brief 最后一块完整时使用的子密钥
+    block_t k1{};
+
+    /// @brief 最后一块需要填充时使用的子密钥
+    block_t k2{};
+
+    /// @brief CBC-MAC 的链接值
+    block_t state{};
+
+    /// @brief 尚未吸收的最后 1 到 16 个字节
+    block_t pending{};
+    std::size_t pending_size = 0;
+
+public:
+    /// @brief 标签的最大字节数
+    static constexpr std::size_t tag_size = 16;
+
+    /// @brief verify 接受的最短截断标签字节数，SP 800-38B 附录 A 建议不少于 64 位
+    static constexpr std::size_t min_tag_size = 8;
+
+    /// @param cryptor 已初始化的密码工具
+    explicit CmacCryptor(const TCryptor& cryptor) noexcept
+        : cryptor(&cryptor), k1(details::xtime_block(cryptor.encrypt(block_t{}))), k2(details::xtime_block(k1)) {}
+
+    /// @brief 开始一条新消息，子密钥不变
+    void start() noexcept {
+        state = {};
+        pending_size = 0;
+    }
+
+    /// @brief 吸收一段消息，任意长度
+    void update(std::span<const std::byte> data) noexcept {
+        if (data.empty()) return;
+        // 先补满暂存的块；之后还有数据时它就不是最后一块，可以吸收
+        const auto fill = std::min(16 - pending_size, data.size());
+        std::memcpy(pending.data() + pending_size, data.data(), fill);
+        pending_size += fill;
+        data = data.subspan(fill);
+        if (data.empty()) return;
+        absorb(pending.data());
+
+        // 保留最后 1 到 16 个字节，直接吸收其余的完整块
+        const auto blocks = (data.size() - 1) / 16;
+        for (std::size_t i = 0; i < blocks; ++i) absorb(reinterpret_cast<const std::uint8_t*>(data.data()) + i * 16);
+        pending_size = data.size() - blocks * 16;
+        std::memcpy(pending.data(), data.data() + blocks * 16, pending_size);
+    }
+
+    /// @brief 结束消息并计算 16 字节标签，截断标签取前若干字节；之后可以直接开始下一条消息
+    [[nodiscard]] block_t finish() noexcept {
+        const auto last = last_block(pending, pending_size);
+        for (std::size_t i = 0; i < 16; ++i) state[i] ^= last[i];
+        cryptor->encrypt(state);
+        const auto tag = state;
+        start();
+        return tag;
+    }
+
+    /// @brief 结束消息并以常数时间比较标签
+    /// @param tag 收到的标签，可以是截断的标签，长度为 8 到 16 字节
+    [[nodiscard]] bool verify(const std::span<const std::byte> tag) noexcept {
+        return details::tag_equal(finish(), tag, min_tag_size);
+    }
+
+    /// @brief 计算一条完整消息的标签，不影响正在进行的 start/update
+    [[nodiscard]] block_t compute(const std::span<const std::byte> data) const noexcept {
+        CmacMessage message{data, {}};
+        compute_many(std::span{&message, 1});
+        return message.tag;
+    }
+
+    /// @brief 计算多条互不相关的消息的标签
+    /// @details 每一步从最多 8 条消息中各取一块，与各自的链接值异或后一起走多块加密接口，使 AES 流水线保持满载；
+    /// 某条消息结束后由下一条消息补上。不分配内存，不影响正在进行的 start/update 。
+    void compute_many(const std::span<CmacMessage> messages) const noexcept {
+        std::array<CmacMessage*, lanes> lane{};
+        std::array<std::size_t, lanes> offset{};
+        std::array<block_t, lanes> chain{};
+        std::size_t next = 0;
+        // 空消息也有一个填充后的最后一块，每条消息至少占用一步
+        const auto refill = [&](const std::size_t l) {
+            lane[l] = next < messages.size() ? &messages[next++] : nullptr;
+            offset[l] = 0;
+            chain[l] = {};
+        };
+        for (std::size_t l = 0; l < lanes; ++l) refill(l);
+
+        std::array<std::uint8_t, 16 * lanes> buffer;
+        std::array<std::size_t, lanes> owner{};
+        std::array<bool, lanes> finishing{};
+        while (true) {
+            std::size_t n = 0;
+            for (std::size_t l = 0; l < lanes; ++l) {
+                if (lane[l] == nullptr) continue;
+                const auto data = lane[l]->data.subspan(offset[l]);
+                auto* block = buffer.data() + n * 16;
+                finishing[n] = data.size() <= 16;
+                if (finishing[n]) {
+                    block_t tail{};
+                    if (!data.empty()) std::memcpy(tail.data(), data.data(), data.size());
+                    const auto last = last_block(tail, data.size());
+                    for (std::size_t j = 0; j < 16; ++j) block[j] = chain[l][j] ^ last[j];
+                }
+                else {
+                    for (std::size_t j = 0; j < 16; ++j) block[j] = chain[l][j] ^ static_cast<std::uint8_t>(data[j]);
+                    offset[l] += 16;
+                }
+                owner[n++] = l;
+            }
+            if (n == 0) break;
+
+            cryptor->encrypt_blocks(std::as_writable_bytes(std::span{buffer}.first(n * 16)));
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto l = owner[i];
+                std::memcpy(chain[l].data(), buffer.data() + i * 16, 16);
+                if (!finishing[i]) continue;
+                lane[l]->tag = chain[l];
+                refill(l);
+            }
+        }
+    }
+
+private:
+    void absorb(const std::uint8_t* block) noexcept {
+        for (std::size_t i = 0; i < 16; ++i) state[i] ^= block[i];
+        cryptor->encrypt(state);
+    }
+
+    /// @brief 最后一块：完整时与 K1 异或，否则按 10* 填充后与 K2 异或
+    [[nodiscard]] block_t last_block(const block_t& tail, const std::size_t size) const noexcept {
+        auto last = tail;
+        if (size == 16) {
+            for (std::size_t i = 0; i < 16; ++i) last[i] ^= k1[i];
+            return last;
+        }
+        last[size] = 0x80;
+        std::fill(last.begin() + static_cast<std::ptrdiff_t>(size) + 1, last.end(), std::uint8_t{0});
+        for (std::size_t i = 0; i < 16; ++i) last[i] ^= k2[i];
+        return last;
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_CMAC
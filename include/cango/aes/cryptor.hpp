@@ -1,7 +1,18 @@
 #ifndef INCLUDE_CANGO_AES_CRYPTOR
 #define INCLUDE_CANGO_AES_CRYPTOR
 
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "details/bitslice.hpp"
+#include "details/blocks.hpp"
+#include "details/dispatch.hpp"
+#include "details/instrument.hpp"
 #include "details/key.hpp"
+#include "details/ttable.hpp"
+#include "details/vperm.hpp"
 
 namespace cango::aes {
 
@@ -27,28 +38,70 @@ inline constexpr Standard AES256 {256, 14};
 using block_t = std::array<std::uint8_t, 4 * 4>;
 
 /// @brief AES 密码工具，包含加密和解密功能，需要使用主钥初始化
-template<std::size_t NWord, std::size_t NRound>
+/// @tparam TRoundKeys 轮密钥类型，决定加密解密使用的实现，默认在运行时按 CPU 特性选择
+template<std::size_t NWord, std::size_t NRound, typename TRoundKeys = details::DispatchRoundKeys<NRound>>
 class Cryptor {
     /// @brief 轮密钥列表
-    details::RoundKeys<NRound> keys{};
+    TRoundKeys keys{};
 
 public:
     /// @brief 暴露轮密钥为公开成员的 AES 密码工具
     struct BareCryptor {
-        details::RoundKeys<NRound> keys;
+        TRoundKeys keys;
 
         /// @brief 加密数据
         [[nodiscard]] constexpr block_t encrypt(const block_t& data) const noexcept {
-            const auto input_mat = details::StateMatrix::from_array(data);
-            const auto output_mat = keys.encrypt(input_mat);
-            return details::StateMatrix::to_array(output_mat);
+            CANGO_AES_COUNT(encrypted_blocks, 1);
+            auto result = data;
+            keys.encrypt(result);
+            return result;
         }
 
         /// @brief 解密数据
         [[nodiscard]] constexpr block_t decrypt(const block_t& data) const noexcept {
-            const auto input_mat = details::StateMatrix::from_array(data);
-            const auto output_mat = keys.decrypt(input_mat);
-            return details::StateMatrix::to_array(output_mat);
+            CANGO_AES_COUNT(decrypted_blocks, 1);
+            auto result = data;
+            keys.decrypt(result);
+            return result;
+        }
+
+        /// @brief 直接在调用方的内存上加密一个块，不要求对齐，不经过临时的块
+        /// @param out 可以与 in 是同一段内存，否则两者不能重叠
+        constexpr void encrypt(const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) const noexcept {
+            CANGO_AES_COUNT(encrypted_blocks, 1);
+            details::process_block<true>(keys, in, out);
+        }
+
+        /// @brief 直接在调用方的内存上解密一个块
+        constexpr void decrypt(const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) const noexcept {
+            CANGO_AES_COUNT(decrypted_blocks, 1);
+            details::process_block<false>(keys, in, out);
+        }
+
+        /// @brief 加密连续的多个数据块，支持多块接口的实现会交错处理以隐藏指令延迟
+        /// @param in 明文，只处理其中完整的 16 字节块，不要求对齐
+        /// @param out 密文，可以与 in 是同一段内存，否则两者不能重叠
+        /// @return 处理的块数，即 min(in.size(), out.size()) / 16 ，其后的字节保持不变
+        std::size_t encrypt_blocks(const std::span<const std::byte> in, const std::span<std::byte> out) const noexcept {
+            return process_spans<true>(keys, in, out);
+        }
+
+        /// @brief 原地加密连续的多个数据块
+        std::size_t encrypt_blocks(const std::span<std::byte> data) const noexcept {
+            return process_spans<true>(keys, data, data);
+        }
+
+        /// @brief 解密连续的多个数据块
+        /// @param in 密文，只处理其中完整的 16 字节块，不要求对齐
+        /// @param out 明文，可以与 in 是同一段内存，否则两者不能重叠
+        /// @return 处理的块数，即 min(in.size(), out.size()) / 16 ，其后的字节保持不变
+        std::size_t decrypt_blocks(const std::span<const std::byte> in, const std::span<std::byte> out) const noexcept {
+            return process_spans<false>(keys, in, out);
+        }
+
+        /// @brief 原地解密连续的多个数据块
+        std::size_t decrypt_blocks(const std::span<std::byte> data) const noexcept {
+            return process_spans<false>(keys, data, data);
         }
     };
 
@@ -62,11 +115,29 @@ public:
 
     /// @brief 使用主钥重新初始化上下文
     constexpr void reinit(const std::array<std::uint8_t, NWord * 4>& mainKey) noexcept {
+        CANGO_AES_COUNT(key_expansions, 1);
         keys.expand_from(mainKey);
     }
 
+    /// @brief 批量初始化多个密码工具，如同时轮换大量密钥
+    /// @details 默认实现在支持 AES-NI 时交错扩展多个密钥，比逐个调用 reinit 快得多；其他实现逐个调用 reinit 。
+    /// 密码工具按缓存行对齐，std::vector<Cryptor> 即为连续且按缓存行对齐的轮密钥数组。
+    /// @return 初始化的个数，即 min(mainKeys.size(), out.size())
+    static std::size_t reinit_many(const std::span<const std::array<std::uint8_t, NWord * 4>> mainKeys, const std::span<Cryptor> out) noexcept {
+        const auto count = std::min(mainKeys.size(), out.size());
+        if constexpr (std::is_same_v<TRoundKeys, details::DispatchRoundKeys<NRound>>) {
+            CANGO_AES_COUNT(key_expansions, count);
+            TRoundKeys::expand_many(mainKeys.data(), count, [&out](const std::size_t i) -> TRoundKeys& { return out[i].keys; });
+        }
+        else {
+            for (std::size_t i = 0; i < count; ++i) out[i].reinit(mainKeys[i]);
+        }
+        return count;
+    }
+
     /// @brief 加密数据
     constexpr void encrypt(block_t& data) const noexcept {
+        CANGO_AES_COUNT(encrypted_blocks, 1);
         keys.encrypt(data);
     }
 
@@ -78,6 +149,7 @@ public:
 
     /// @brief 解密数据
     constexpr void decrypt(block_t& data) const noexcept {
+        CANGO_AES_COUNT(decrypted_blocks, 1);
         keys.decrypt(data);
     }
 
@@ -87,8 +159,62 @@ public:
         return result;
     }
 
+    /// @brief 直接在调用方的内存上加密一个块，不要求对齐，不经过临时的块
+    /// @details 默认实现经由多块接口直接读写调用方的内存，适合加密大缓冲区中的某一块或 struct 中的字段
+    /// @param out 可以与 in 是同一段内存，否则两者不能重叠
+    constexpr void encrypt(const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) const noexcept {
+        CANGO_AES_COUNT(encrypted_blocks, 1);
+        details::process_block<true>(keys, in, out);
+    }
+
+    /// @brief 直接在调用方的内存上解密一个块
+    constexpr void decrypt(const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) const noexcept {
+        CANGO_AES_COUNT(decrypted_blocks, 1);
+        details::process_block<false>(keys, in, out);
+    }
+
+    /// @brief 加密连续的多个数据块，支持多块接口的实现会交错处理以隐藏指令延迟
+    /// @param in 明文，只处理其中完整的 16 字节块，不要求对齐
+    /// @param out 密文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 处理的块数，即 min(in.size(), out.size()) / 16 ，其后的字节保持不变
+    std::size_t encrypt_blocks(const std::span<const std::byte> in, const std::span<std::byte> out) const noexcept {
+        return process_spans<true>(keys, in, out);
+    }
+
+    /// @brief 原地加密连续的多个数据块
+    std::size_t encrypt_blocks(const std::span<std::byte> data) const noexcept {
+        return process_spans<true>(keys, data, data);
+    }
+
+    /// @brief 解密连续的多个数据块
+    /// @param in 密文，只处理其中完整的 16 字节块，不要求对齐
+    /// @param out 明文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 处理的块数，即 min(in.size(), out.size()) / 16 ，其后的字节保持不变
+    std::size_t decrypt_blocks(const std::span<const std::byte> in, const std::span<std::byte> out) const noexcept {
+        return process_spans<false>(keys, in, out);
+    }
+
+    /// @brief 原地解密连续的多个数据块
+    std::size_t decrypt_blocks(const std::span<std::byte> data) const noexcept {
+        return process_spans<false>(keys, data, data);
+    }
+
     static constexpr BareCryptor create_const(const std::array<std::uint8_t, NWord * 4>& mainKey) noexcept {
-        return {details::RoundKeys<NRound>::from_array(mainKey)};
+        return {TRoundKeys::from_array(mainKey)};
+    }
+
+private:
+    template<bool Encrypt>
+    static std::size_t process_spans(const TRoundKeys& roundKeys, const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        const auto count = std::min(in.size(), out.size()) / 16;
+        if constexpr (Encrypt) CANGO_AES_COUNT(encrypted_blocks, count);
+        else CANGO_AES_COUNT(decrypted_blocks, count);
+        details::process_blocks<Encrypt>(
+            roundKeys,
+            reinterpret_cast<const std::uint8_t*>(in.data()),
+            reinterpret_cast<std::uint8_t*>(out.data()),
+            count);
+        return count;
     }
 };
 
@@ -101,6 +227,22 @@ using AES192Cryptor = Cryptor<6, 12>;
 /// @brief AES-256 密码工具，指定 256 二进制位(32字节)密钥后可用于加密和解密 128 二进制位(16字节)数据
 using AES256Cryptor = Cryptor<8, 14>;
 
+/// @brief 逐字节操作状态矩阵的参考实现，便于对照标准学习
+template<std::size_t NWord, std::size_t NRound>
+using ReferenceCryptor = Cryptor<NWord, NRound, details::RoundKeys<NRound>>;
+
+/// @brief 使用 T 表实现的 AES 密码工具，与参考实现的结果逐位相同
+template<std::size_t NWord, std::size_t NRound>
+using TableCryptor = Cryptor<NWord, NRound, details::TableRoundKeys<NRound>>;
+
+/// @brief 使用位切片实现的 AES 密码工具，常数时间，没有依赖秘密数据的查表
+template<std::size_t NWord, std::size_t NRound>
+using BitsliceCryptor = Cryptor<NWord, NRound, details::BitsliceRoundKeys<NRound>>;
+
+/// @brief 使用向量置换实现的 AES 密码工具，支持 SSSE3 时单块也是常数时间
+template<std::size_t NWord, std::size_t NRound>
+using VpermCryptor = Cryptor<NWord, NRound, details::VpermRoundKeys<NRound>>;
+
 }
 
 #endif//INCLUDE_CANGO_AES_CRYPTOR
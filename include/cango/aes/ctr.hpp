@@ -0,0 +1,209 @@
+#ifndef INCLUDE_CANGO_AES_CTR
+#define INCLUDE_CANGO_AES_CTR
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "cryptor.hpp"
+#include "details/counter.hpp"
+#include "details/parallel.hpp"
+#include "details/segments.hpp"
+#include "executor.hpp"
+
+namespace cango::aes {
+
+/// @brief 计数器(CTR)模式，加密和解密是同一个操作
+/// @details 第 i 个密钥流块为 E(初始计数器 + i)，计数器块末尾 NCounterBits 位为大端计数器，
+/// 溢出时只在这些位内回绕。密钥流每次按 8 块生成，走密码工具的多块接口。
+/// 只保存当前字节偏移，seek 为 O(1)，可以直接处理大对象中间的一段。
+/// @tparam TCryptor 密码工具类型，需要提供 encrypt_blocks ，对象的生命周期必须长于本对象
+/// @tparam NCounterBits 计数器位数，32, 64 或 128
+template<typename TCryptor, std::size_t NCounterBits = 32> requires details::CounterBits<NCounterBits>
+class CtrCryptor {
+    /// @brief 每次生成的密钥流块数
+    static constexpr std::size_t batch_blocks = 8;
+
+    /// @brief 多线程时每个线程至少处理的字节数，更小的数据不值得启动线程
+    static constexpr std::size_t min_bytes_per_thread = 256 * 1024;
+
+    const TCryptor* cryptor;
+
+    /// @brief 偏移为 0 处的计数器块
+    block_t initial_counter;
+
+    /// @brief 当前字节偏移
+    std::uint64_t position = 0;
+
+    /// @brief 最近生成的密钥流块及其块序号，用于不按块对齐的连续调用
+    block_t cached_keystream{};
+    std::uint64_t cached_block = UINT64_MAX;
+
+public:
+    /// @brief 计数器位数
+    static constexpr auto counter_bits = NCounterBits;
+
+    /// @param cryptor 已初始化的密码工具
+    /// @param initialCounter 偏移为 0 处的计数器块，通常为 nonce 与初始计数值的拼接
+    constexpr CtrCryptor(const TCryptor& cryptor, const block_t& initialCounter) noexcept
+        : cryptor(&cryptor), initial_counter(initialCounter) {}
+
+    /// @brief 跳到指定的字节偏移，之后的处理从该偏移的密钥流开始
+    constexpr void seek(const std::uint64_t offset) noexcept {
+        position = offset;
+    }
+
+    /// @brief 当前字节偏移
+    [[nodiscard]] constexpr std::uint64_t tell() const noexcept {
+        return position;
+    }
+
+    /// @brief 指定块序号的计数器块
+    [[nodiscard]] constexpr block_t counter_at(const std::uint64_t block) const noexcept {
+        auto counter = initial_counter;
+        details::add_counter<NCounterBits>(counter, block);
+        return counter;
+    }
+
+    /// @brief 用密钥流异或数据，并把偏移向后移动
+    /// @param in 输入数据，任意长度
+    /// @param out 输出数据，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 处理的字节数，即 min(in.size(), out.size())
+    std::size_t apply(std::span<const std::byte> in, std::span<std::byte> out) noexcept {
+        const auto size = std::min(in.size(), out.size());
+        in = in.first(size);
+        out = out.first(size);
+
+        // 补齐上一次调用留下的半个块
+        if (const auto skip = static_cast<std::size_t>(position % 16); skip != 0 && !in.empty()) {
+            const auto n = std::min<std::size_t>(16 - skip, in.size());
+            xor_partial(position / 16, skip, in.first(n), out.first(n));
+            advance(in, out, n);
+        }
+
+        std::array<std::byte, 16 * batch_blocks> keystream;
+        while (in.size() >= keystream.size()) {
+            generate(position / 16, keystream);
+            xor_bytes(in.data(), keystream.data(), out.data(), keystream.size());
+            advance(in, out, keystream.size());
+        }
+
+        const auto whole = in.size() / 16 * 16;
+        if (whole != 0) {
+            const auto part = std::span{keystream}.first(whole);
+            generate(position / 16, part);
+            xor_bytes(in.data(), part.data(), out.data(), whole);
+            advance(in, out, whole);
+        }
+
+        if (!in.empty()) {
+            xor_partial(position / 16, 0, in, out);
+            position += in.size();
+        }
+        return size;
+    }
+
+    /// @brief 原地用密钥流异或数据
+    std::size_t apply(const std::span<std::byte> data) noexcept {
+        return apply(data, data);
+    }
+
+    /// @brief 用密钥流异或一串分段(如分片的报文)，不先拼接成连续的缓冲区
+    /// @details 跨越分段边界的块由上一次调用留下的半个块接续，任何数据都不会被复制
+    /// @param in 输入分段
+    /// @param out 输出分段，切分方式可以与 in 不同，但不能与 in 部分重叠
+    /// @return 处理的字节数，即两串分段总长度的较小值
+    std::size_t apply_segments(const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+        return details::for_each_run(in, out, [this](const auto source, const auto target) { apply(source, target); });
+    }
+
+    /// @brief 原地用密钥流异或一串分段
+    std::size_t apply_segments(const std::span<const std::span<std::byte>> data) noexcept {
+        return details::for_each_run(data, data, [this](const auto source, const auto target) { apply(source, target); });
+    }
+
+    /// @brief 与 apply 相同，但把数据按计数器偏移切分给多个线程
+    /// @param threads 线程数，为 0 时使用硬件并发数；数据较少时自动减少线程数
+    std::size_t apply_parallel(const std::span<const std::byte> in, const std::span<std::byte> out, const std::size_t threads = 0) {
+        const auto blocks = (std::min(in.size(), out.size()) + 15) / 16;
+        return apply_chunks(in, out, details::plan_chunks(blocks, threads, min_bytes_per_thread / 16),
+                            [](const auto&... args) { details::run_chunks(args...); });
+    }
+
+    /// @brief 原地并行处理数据
+    std::size_t apply_parallel(const std::span<std::byte> data, const std::size_t threads = 0) {
+        return apply_parallel(data, data, threads);
+    }
+
+    /// @brief 与 apply 相同，但交给线程池处理，数据量低于线程池的阈值时直接在调用线程上处理
+    std::size_t apply_parallel(const std::span<const std::byte> in, const std::span<std::byte> out, Executor& executor) {
+        const auto blocks = (std::min(in.size(), out.size()) + 15) / 16;
+        return apply_chunks(in, out, executor.plan(blocks, 16), [&executor](const auto&... args) { executor.run(args...); });
+    }
+
+    /// @brief 用线程池原地处理数据
+    std::size_t apply_parallel(const std::span<std::byte> data, Executor& executor) {
+        return apply_parallel(data, data, executor);
+    }
+
+private:
+    /// @brief 按块切分后分段处理，每段复制一份对象并 seek 到该段的偏移，轮密钥仍通过指针共享
+    template<typename TRun>
+    std::size_t apply_chunks(const std::span<const std::byte> in, const std::span<std::byte> out, const details::ChunkPlan& plan, const TRun& run) {
+        if (plan.count <= 1) return apply(in, out);
+        const auto size = std::min(in.size(), out.size());
+        run(plan, (size + 15) / 16, [&](std::size_t, const std::size_t begin, const std::size_t n) {
+            const auto first = begin * 16;
+            const auto bytes = std::min(n * 16, size - first);
+            auto worker = *this;
+            worker.seek(position + first);
+            worker.apply(in.subspan(first, bytes), out.subspan(first, bytes));
+        });
+        position += size;
+        return size;
+    }
+
+    void advance(std::span<const std::byte>& in, std::span<std::byte>& out, const std::size_t n) noexcept {
+        in = in.subspan(n);
+        out = out.subspan(n);
+        position += n;
+    }
+
+    /// @brief 生成从 block 开始的连续密钥流块
+    void generate(const std::uint64_t block, const std::span<std::byte> keystream) const noexcept {
+        details::fill_counters<NCounterBits>(
+            counter_at(block),
+            reinterpret_cast<std::uint8_t*>(keystream.data()),
+            keystream.size() / 16);
+        cryptor->encrypt_blocks(keystream);
+    }
+
+    /// @brief 用第 block 块密钥流中从 skip 开始的字节异或数据
+    void xor_partial(const std::uint64_t block, const std::size_t skip, const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        if (cached_block != block) {
+            cached_keystream = cryptor->encrypt(counter_at(block));
+            cached_block = block;
+        }
+        xor_bytes(in.data(), reinterpret_cast<const std::byte*>(cached_keystream.data()) + skip, out.data(), in.size());
+    }
+
+    /// @brief 按 8 字节一组异或，不要求对齐
+    static void xor_bytes(const std::byte* in, const std::byte* keystream, std::byte* out, const std::size_t n) noexcept {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            std::uint64_t a, b;
+            std::memcpy(&a, in + i, 8);
+            std::memcpy(&b, keystream + i, 8);
+            a ^= b;
+            std::memcpy(out + i, &a, 8);
+        }
+        for (; i < n; ++i) out[i] = in[i] ^ keystream[i];
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_CTR
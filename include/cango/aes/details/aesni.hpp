@@ -0,0 +1,338 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_AESNI
+#define INCLUDE_CANGO_AES_DETAILS_AESNI
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu.hpp"
+
+#if CANGO_AES_X86
+
+namespace cango::aes::details::aesni {
+
+/// @brief 把上一组 4 个字做前缀异或，即 w[i] ^= w[i-1] ^ ... ^ w[0]
+CANGO_AES_TARGET("sse2")
+inline __m128i prefix_xor(__m128i key) noexcept {
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 8));
+    return key;
+}
+
+/// @brief AES-128 的一步扩展
+template<int Rcon>
+CANGO_AES_TARGET("aes,sse2")
+inline __m128i expand_step_128(const __m128i key) noexcept {
+    const auto assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xff);
+    return _mm_xor_si128(prefix_xor(key), assist);
+}
+
+/// @brief AES-192 的一步扩展，生成 6 个新字
+/// @param low 前 4 个字，原地更新
+/// @param high 后 2 个字位于低 64 位，原地更新
+template<int Rcon>
+CANGO_AES_TARGET("aes,sse2")
+inline void expand_step_192(__m128i& low, __m128i& high) noexcept {
+    const auto assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(high, Rcon), 0x55);
+    low = _mm_xor_si128(prefix_xor(low), assist);
+    const auto last = _mm_shuffle_epi32(low, 0xff);
+    high = _mm_xor_si128(_mm_xor_si128(high, _mm_slli_si128(high, 4)), last);
+}
+
+/// @brief 把 AES-192 两步扩展产生的字重新排列为两组轮密钥
+/// @param previous 上一步的后 2 个字
+/// @param low 本步的前 4 个字
+/// @param high 本步的后 2 个字
+/// @param out 输出的两组轮密钥
+CANGO_AES_TARGET("sse2")
+inline void combine_192(const __m128i previous, const __m128i low, const __m128i high, __m128i* out) noexcept {
+    out[0] = _mm_unpacklo_epi64(previous, low);
+    out[1] = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(low), _mm_castsi128_pd(high), 1));
+}
+
+/// @brief AES-256 的一步扩展，生成偶数组的 4 个字
+template<int Rcon>
+CANGO_AES_TARGET("aes,sse2")
+inline __m128i expand_step_256_even(const __m128i even, const __m128i odd) noexcept {
+    const auto assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(odd, Rcon), 0xff);
+    return _mm_xor_si128(prefix_xor(even), assist);
+}
+
+/// @brief AES-256 的一步扩展，生成奇数组的 4 个字，只做字节替换不旋转
+CANGO_AES_TARGET("aes,sse2")
+inline __m128i expand_step_256_odd(const __m128i even, const __m128i odd) noexcept {
+    const auto assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(even, 0), 0xaa);
+    return _mm_xor_si128(prefix_xor(odd), assist);
+}
+
+/// @brief 使用 AESKEYGENASSIST 扩展加密轮密钥
+/// @param mainKey 主密钥，长度为 NBytes
+/// @param enc 加密轮密钥，需要 16 字节对齐
+template<std::size_t NBytes>
+CANGO_AES_TARGET("aes,sse2")
+inline void expand_encrypt_keys(const std::uint8_t* mainKey, __m128i* enc) noexcept {
+    if constexpr (NBytes == 16) {
+        auto key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKey));
+        enc[0] = key;
+        enc[1] = key = expand_step_128<0x01>(key);
+        enc[2] = key = expand_step_128<0x02>(key);
+        enc[3] = key = expand_step_128<0x04>(key);
+        enc[4] = key = expand_step_128<0x08>(key);
+        enc[5] = key = expand_step_128<0x10>(key);
+        enc[6] = key = expand_step_128<0x20>(key);
+        enc[7] = key = expand_step_128<0x40>(key);
+        enc[8] = key = expand_step_128<0x80>(key);
+        enc[9] = key = expand_step_128<0x1b>(key);
+        enc[10] = expand_step_128<0x36>(key);
+    }
+    else if constexpr (NBytes == 24) {
+        // 每步生成 6 个字，与 4 字一组的轮密钥交错，每 3 组轮密钥对应 2 步
+        auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKey));
+        auto high = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mainKey + 16));
+        enc[0] = low;
+        auto previous_high = high;
+        expand_step_192<0x01>(low, high);
+        combine_192(previous_high, low, high, enc + 1);
+        expand_step_192<0x02>(low, high);
+        enc[3] = low;
+        previous_high = high;
+        expand_step_192<0x04>(low, high);
+        combine_192(previous_high, low, high, enc + 4);
+        expand_step_192<0x08>(low, high);
+        enc[6] = low;
+        previous_high = high;
+        expand_step_192<0x10>(low, high);
+        combine_192(previous_high, low, high, enc + 7);
+        expand_step_192<0x20>(low, high);
+        enc[9] = low;
+        previous_high = high;
+        expand_step_192<0x40>(low, high);
+        combine_192(previous_high, low, high, enc + 10);
+        expand_step_192<0x80>(low, high);
+        enc[12] = low;
+    }
+    else {
+        static_assert(NBytes == 32, "主密钥长度必须为 16, 24 或 32 字节");
+        auto even = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKey));
+        auto odd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKey + 16));
+        enc[0] = even;
+        enc[1] = odd;
+        enc[2] = even = expand_step_256_even<0x01>(even, odd);
+        enc[3] = odd = expand_step_256_odd(even, odd);
+        enc[4] = even = expand_step_256_even<0x02>(even, odd);
+        enc[5] = odd = expand_step_256_odd(even, odd);
+        enc[6] = even = expand_step_256_even<0x04>(even, odd);
+        enc[7] = odd = expand_step_256_odd(even, odd);
+        enc[8] = even = expand_step_256_even<0x08>(even, odd);
+        enc[9] = odd = expand_step_256_odd(even, odd);
+        enc[10] = even = expand_step_256_even<0x10>(even, odd);
+        enc[11] = odd = expand_step_256_odd(even, odd);
+        enc[12] = even = expand_step_256_even<0x20>(even, odd);
+        enc[13] = odd = expand_step_256_odd(even, odd);
+        enc[14] = expand_step_256_even<0x40>(even, odd);
+    }
+}
+
+/// @brief 由加密轮密钥生成等价逆密码的解密轮密钥
+/// @param enc 加密轮密钥，需要 16 字节对齐
+/// @param dec 解密轮密钥，需要 16 字节对齐
+template<std::size_t NRound>
+CANGO_AES_TARGET("aes,sse2")
+inline void derive_decrypt_keys(const __m128i* enc, __m128i* dec) noexcept {
+    dec[0] = enc[NRound];
+    for (std::size_t round = 1; round < NRound; ++round)
+        dec[round] = _mm_aesimc_si128(enc[NRound - round]);
+    dec[NRound] = enc[0];
+}
+
+/// @brief 扩展加密和解密轮密钥
+/// @param mainKey 主密钥，长度为 NBytes
+/// @param enc 加密轮密钥，需要 16 字节对齐
+/// @param dec 解密轮密钥，需要 16 字节对齐
+template<std::size_t NRound, std::size_t NBytes>
+inline void expand(const std::uint8_t* mainKey, void* enc, void* dec) noexcept {
+    const auto enc_keys = static_cast<__m128i*>(enc);
+    expand_encrypt_keys<NBytes>(mainKey, enc_keys);
+    derive_decrypt_keys<NRound>(enc_keys, static_cast<__m128i*>(dec));
+}
+
+/// @brief 批量扩展时每次交错处理的密钥数
+inline constexpr std::size_t expand_interleave = 8;
+
+/// @brief 扩展各步的轮常数
+inline constexpr std::uint8_t round_constants[10]{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+/// @brief 把一个字的 RotWord 或原字广播到 4 个字后做 AESENCLAST ，得到 4 份 SubWord 结果并异或轮常数
+/// @details 4 列相同时 ShiftRows 不改变状态，AESENCLAST 只剩 SubBytes 和与轮密钥的异或；
+/// 比 AESKEYGENASSIST 的吞吐量高得多，适合多个密钥交错扩展。
+/// @param pick 选出字节的 PSHUFB 掩码
+CANGO_AES_TARGET("aes,ssse3")
+inline __m128i sub_word(const __m128i words, const __m128i pick, const __m128i constant) noexcept {
+    return _mm_aesenclast_si128(_mm_shuffle_epi8(words, pick), constant);
+}
+
+/// @brief 同时扩展 NLanes 个密钥的加密和解密轮密钥，各密钥的扩展步骤交错执行以隐藏指令延迟
+/// @param mainKeys 各主密钥，长度为 NBytes
+/// @param enc 各加密轮密钥，需要 16 字节对齐
+/// @param dec 各解密轮密钥，需要 16 字节对齐
+template<std::size_t NRound, std::size_t NBytes, std::size_t NLanes>
+CANGO_AES_TARGET("aes,ssse3")
+inline void expand_lanes(const std::uint8_t* const* mainKeys, void* const* enc, void* const* dec) noexcept {
+    // 第 3 个字的 RotWord 、第 3 个字、第 1 个字的 RotWord ，广播到 4 个字
+    const auto rot_word3 = _mm_set1_epi32(0x0c0f0e0d);
+    const auto word3 = _mm_set1_epi32(0x0f0e0d0c);
+    const auto rot_word1 = _mm_set1_epi32(0x04070605);
+    __m128i* rk[NLanes];
+    CANGO_AES_UNROLL
+    for (std::size_t lane = 0; lane < NLanes; ++lane) rk[lane] = static_cast<__m128i*>(enc[lane]);
+
+    if constexpr (NBytes == 16) {
+        __m128i key[NLanes];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) rk[lane][0] = key[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKeys[lane]));
+        CANGO_AES_UNROLL
+        for (std::size_t step = 1; step <= 10; ++step) {
+            const auto constant = _mm_set1_epi32(round_constants[step - 1]);
+            CANGO_AES_UNROLL
+            for (std::size_t lane = 0; lane < NLanes; ++lane)
+                rk[lane][step] = key[lane] = _mm_xor_si128(prefix_xor(key[lane]), sub_word(key[lane], rot_word3, constant));
+        }
+    }
+    else if constexpr (NBytes == 24) {
+        // 与 expand_encrypt_keys 相同，每步生成 6 个字，每 3 组轮密钥对应 2 步
+        __m128i low[NLanes];
+        __m128i high[NLanes];
+        __m128i previous_high[NLanes];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            rk[lane][0] = low[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKeys[lane]));
+            high[lane] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mainKeys[lane] + 16));
+        }
+        CANGO_AES_UNROLL
+        for (std::size_t step = 0; step < 8; ++step) {
+            const auto constant = _mm_set1_epi32(round_constants[step]);
+            CANGO_AES_UNROLL
+            for (std::size_t lane = 0; lane < NLanes; ++lane) {
+                previous_high[lane] = high[lane];
+                low[lane] = _mm_xor_si128(prefix_xor(low[lane]), sub_word(high[lane], rot_word1, constant));
+                high[lane] = _mm_xor_si128(_mm_xor_si128(high[lane], _mm_slli_si128(high[lane], 4)), _mm_shuffle_epi32(low[lane], 0xff));
+                if (step % 2 == 0) combine_192(previous_high[lane], low[lane], high[lane], rk[lane] + 1 + step / 2 * 3);
+                else rk[lane][(step + 1) / 2 * 3] = low[lane];
+            }
+        }
+    }
+    else {
+        static_assert(NBytes == 32, "主密钥长度必须为 16, 24 或 32 字节");
+        __m128i even[NLanes];
+        __m128i odd[NLanes];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            rk[lane][0] = even[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKeys[lane]));
+            rk[lane][1] = odd[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mainKeys[lane] + 16));
+        }
+        CANGO_AES_UNROLL
+        for (std::size_t step = 1; step <= 7; ++step) {
+            const auto constant = _mm_set1_epi32(round_constants[step - 1]);
+            CANGO_AES_UNROLL
+            for (std::size_t lane = 0; lane < NLanes; ++lane) {
+                rk[lane][2 * step] = even[lane] = _mm_xor_si128(prefix_xor(even[lane]), sub_word(odd[lane], rot_word3, constant));
+                if (step < 7)
+                    rk[lane][2 * step + 1] = odd[lane] = _mm_xor_si128(prefix_xor(odd[lane]), sub_word(even[lane], word3, _mm_setzero_si128()));
+            }
+        }
+    }
+
+    CANGO_AES_UNROLL
+    for (std::size_t lane = 0; lane < NLanes; ++lane) derive_decrypt_keys<NRound>(rk[lane], static_cast<__m128i*>(dec[lane]));
+}
+
+/// @brief 加密一个数据块
+/// @param keys 加密轮密钥，需要 16 字节对齐
+/// @param block 16 字节数据，不要求对齐
+template<std::size_t NRound>
+CANGO_AES_TARGET("aes,sse2")
+inline void encrypt(const void* keys, std::uint8_t* block) noexcept {
+    const auto rk = static_cast<const __m128i*>(keys);
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), rk[0]);
+    for (std::size_t round = 1; round < NRound; ++round)
+        state = _mm_aesenc_si128(state, rk[round]);
+    state = _mm_aesenclast_si128(state, rk[NRound]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(block), state);
+}
+
+/// @brief 解密一个数据块
+/// @param keys 等价逆密码的解密轮密钥，需要 16 字节对齐
+/// @param block 16 字节数据，不要求对齐
+template<std::size_t NRound>
+CANGO_AES_TARGET("aes,sse2")
+inline void decrypt(const void* keys, std::uint8_t* block) noexcept {
+    const auto rk = static_cast<const __m128i*>(keys);
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), rk[0]);
+    for (std::size_t round = 1; round < NRound; ++round)
+        state = _mm_aesdec_si128(state, rk[round]);
+    state = _mm_aesdeclast_si128(state, rk[NRound]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(block), state);
+}
+
+/// @brief 每次交错处理的块数，AESENC 的延迟约为吞吐间隔的 4 到 8 倍
+inline constexpr std::size_t interleave = 8;
+
+/// @brief 同时处理 NLanes 个数据块，每轮的轮密钥只载入一次
+/// @param keys 轮密钥，需要 16 字节对齐
+/// @param in 输入数据，NLanes * 16 字节，不要求对齐
+/// @param out 输出数据，NLanes * 16 字节，不要求对齐，可以与输入相同
+template<std::size_t NRound, bool Encrypt, std::size_t NLanes>
+CANGO_AES_TARGET("aes,sse2")
+inline void process_lanes(const __m128i* rk, const std::uint8_t* in, std::uint8_t* out) noexcept {
+    __m128i state[NLanes];
+    CANGO_AES_UNROLL
+    for (std::size_t lane = 0; lane < NLanes; ++lane)
+        state[lane] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + lane), rk[0]);
+    for (std::size_t round = 1; round < NRound; ++round) {
+        const auto key = rk[round];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane)
+            state[lane] = Encrypt ? _mm_aesenc_si128(state[lane], key) : _mm_aesdec_si128(state[lane], key);
+    }
+    CANGO_AES_UNROLL
+    for (std::size_t lane = 0; lane < NLanes; ++lane) {
+        const auto block = Encrypt
+            ? _mm_aesenclast_si128(state[lane], rk[NRound])
+            : _mm_aesdeclast_si128(state[lane], rk[NRound]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + lane, block);
+    }
+}
+
+/// @brief 处理连续的多个数据块，每 interleave 块交错执行，剩余部分逐块处理
+template<std::size_t NRound, bool Encrypt>
+CANGO_AES_TARGET("aes,sse2")
+inline void process_blocks(const void* keys, const std::uint8_t* in, std::uint8_t* out, std::size_t count) noexcept {
+    const auto rk = static_cast<const __m128i*>(keys);
+    for (; count >= interleave; count -= interleave, in += 16 * interleave, out += 16 * interleave)
+        process_lanes<NRound, Encrypt, interleave>(rk, in, out);
+    for (; count > 0; --count, in += 16, out += 16)
+        process_lanes<NRound, Encrypt, 1>(rk, in, out);
+}
+
+/// @brief 加密连续的多个数据块
+/// @param keys 加密轮密钥，需要 16 字节对齐
+/// @param in 输入数据，count * 16 字节
+/// @param out 输出数据，count * 16 字节，可以与输入相同
+template<std::size_t NRound>
+inline void encrypt_blocks(const void* keys, const std::uint8_t* in, std::uint8_t* out, const std::size_t count) noexcept {
+    process_blocks<NRound, true>(keys, in, out, count);
+}
+
+/// @brief 解密连续的多个数据块
+/// @param keys 等价逆密码的解密轮密钥，需要 16 字节对齐
+/// @param in 输入数据，count * 16 字节
+/// @param out 输出数据，count * 16 字节，可以与输入相同
+template<std::size_t NRound>
+inline void decrypt_blocks(const void* keys, const std::uint8_t* in, std::uint8_t* out, const std::size_t count) noexcept {
+    process_blocks<NRound, false>(keys, in, out, count);
+}
+
+}
+
+#endif
+
+#endif//INCLUDE_CANGO_AES_DETAILS_AESNI
@@ -0,0 +1,589 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_BITSLICE
+#define INCLUDE_CANGO_AES_DETAILS_BITSLICE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils.hpp"
+#include "word.hpp"
+
+namespace cango::aes::details {
+
+namespace bitslice {
+
+#if defined(__GNUC__) || defined(__clang__)
+#if defined(__AVX2__)
+/// @brief 位切片使用的向量类型，每个 64 位通道处理 4 个数据块
+typedef std::uint64_t vector_t __attribute__((vector_size(32)));
+#else
+/// @brief 位切片使用的向量类型，每个 64 位通道处理 4 个数据块
+typedef std::uint64_t vector_t __attribute__((vector_size(16)));
+#endif
+#else
+/// @brief 位切片使用的向量类型，编译器不支持向量扩展时退化为单个 64 位整数
+using vector_t = std::uint64_t;
+#endif
+
+/// @brief 一个 64 位通道同时处理的数据块数
+inline constexpr std::size_t blocks_per_lane = 4;
+
+/// @brief 向量类型同时处理的数据块数
+inline constexpr std::size_t blocks_per_vector = blocks_per_lane * (sizeof(vector_t) / sizeof(std::uint64_t));
+
+/// @brief 位切片状态，q[i] 保存所有字节的第 i 位
+template<typename W>
+using State = std::array<W, 8>;
+
+/// @brief S 盒的布尔电路(Boyar–Peralta)，只使用与、异或和取反，不访问内存
+/// @details 对 W 的每一位独立计算，因此既可用于 64 位整数和向量，也可用于打包在 32 位整数中的单个字
+template<typename W>
+constexpr void sbox(State<W>& q) noexcept {
+    const W x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4];
+    const W x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // 顶部线性变换
+    const W y14 = x3 ^ x5;
+    const W y13 = x0 ^ x6;
+    const W y9 = x0 ^ x3;
+    const W y8 = x0 ^ x5;
+    const W t0 = x1 ^ x2;
+    const W y1 = t0 ^ x7;
+    const W y4 = y1 ^ x3;
+    const W y12 = y13 ^ y14;
+    const W y2 = y1 ^ x0;
+    const W y5 = y1 ^ x6;
+    const W y3 = y5 ^ y8;
+    const W t1 = x4 ^ y12;
+    const W y15 = t1 ^ x5;
+    const W y20 = t1 ^ x1;
+    const W y6 = y15 ^ x7;
+    const W y10 = y15 ^ t0;
+    const W y11 = y20 ^ y9;
+    const W y7 = x7 ^ y11;
+    const W y17 = y10 ^ y11;
+    const W y19 = y10 ^ y8;
+    const W y16 = t0 ^ y11;
+    const W y21 = y13 ^ y16;
+    const W y18 = x0 ^ y16;
+
+    // 中间非线性部分
+    const W t2 = y12 & y15;
+    const W t3 = y3 & y6;
+    const W t4 = t3 ^ t2;
+    const W t5 = y4 & x7;
+    const W t6 = t5 ^ t2;
+    const W t7 = y13 & y16;
+    const W t8 = y5 & y1;
+    const W t9 = t8 ^ t7;
+    const W t10 = y2 & y7;
+    const W t11 = t10 ^ t7;
+    const W t12 = y9 & y11;
+    const W t13 = y14 & y17;
+    const W t14 = t13 ^ t12;
+    const W t15 = y8 & y10;
+    const W t16 = t15 ^ t12;
+    const W t17 = t4 ^ t14;
+    const W t18 = t6 ^ t16;
+    const W t19 = t9 ^ t14;
+    const W t20 = t11 ^ t16;
+    const W t21 = t17 ^ y20;
+    const W t22 = t18 ^ y19;
+    const W t23 = t19 ^ y21;
+    const W t24 = t20 ^ y18;
+
+    const W t25 = t21 ^ t22;
+    const W t26 = t21 & t23;
+    const W t27 = t24 ^ t26;
+    const W t28 = t25 & t27;
+    const W t29 = t28 ^ t22;
+    const W t30 = t23 ^ t24;
+    const W t31 = t22 ^ t26;
+    const W t32 = t31 & t30;
+    const W t33 = t32 ^ t24;
+    const W t34 = t23 ^ t33;
+    const W t35 = t27 ^ t33;
+    const W t36 = t24 & t35;
+    const W t37 = t36 ^ t34;
+    const W t38 = t27 ^ t36;
+    const W t39 = t29 & t38;
+    const W t40 = t25 ^ t39;
+
+    const W t41 = t40 ^ t37;
+    const W t42 = t29 ^ t33;
+    const W t43 = t29 ^ t40;
+    const W t44 = t33 ^ t37;
+    const W t45 = t42 ^ t41;
+    const W z0 = t44 & y15;
+    const W z1 = t37 & y6;
+    const W z2 = t33 & x7;
+    const W z3 = t43 & y16;
+    const W z4 = t40 & y1;
+    const W z5 = t29 & y7;
+    const W z6 = t42 & y11;
+    const W z7 = t45 & y17;
+    const W z8 = t41 & y10;
+    const W z9 = t44 & y12;
+    const W z10 = t37 & y3;
+    const W z11 = t33 & y4;
+    const W z12 = t43 & y13;
+    const W z13 = t40 & y5;
+    const W z14 = t29 & y2;
+    const W z15 = t42 & y9;
+    const W z16 = t45 & y14;
+    const W z17 = t41 & y8;
+
+    // 底部线性变换
+    const W t46 = z15 ^ z16;
+    const W t47 = z10 ^ z11;
+    const W t48 = z5 ^ z13;
+    const W t49 = z9 ^ z10;
+    const W t50 = z2 ^ z12;
+    const W t51 = z2 ^ z5;
+    const W t52 = z7 ^ z8;
+    const W t53 = z0 ^ z3;
+    const W t54 = z6 ^ z7;
+    const W t55 = z16 ^ z17;
+    const W t56 = z12 ^ t48;
+    const W t57 = t50 ^ t53;
+    const W t58 = z4 ^ t46;
+    const W t59 = z3 ^ t54;
+    const W t60 = t46 ^ t57;
+    const W t61 = z14 ^ t57;
+    const W t62 = t52 ^ t58;
+    const W t63 = t49 ^ t58;
+    const W t64 = z4 ^ t59;
+    const W t65 = t61 ^ t62;
+    const W t66 = z1 ^ t63;
+    const W s0 = t59 ^ t63;
+    const W s6 = t56 ^ ~t62;
+    const W s7 = t48 ^ ~t60;
+    const W t67 = t64 ^ t65;
+    const W s3 = t53 ^ t66;
+    const W s4 = t51 ^ t66;
+    const W s5 = t47 ^ t65;
+    const W s1 = t64 ^ ~s3;
+    const W s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/// @brief 逆仿射变换，即 S 盒仿射变换的逆，包含常数 0x63
+template<typename W>
+constexpr void inv_affine(State<W>& q) noexcept {
+    const W q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3];
+    const W q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+/// @brief 逆 S 盒，由逆仿射变换夹住正向 S 盒得到
+template<typename W>
+constexpr void inv_sbox(State<W>& q) noexcept {
+    inv_affine(q);
+    sbox(q);
+    inv_affine(q);
+}
+
+/// @brief 在两个字之间交换由掩码选出的位
+template<std::uint64_t Low, std::uint64_t High, int Shift, typename W>
+constexpr void swap_bits(W& x, W& y) noexcept {
+    const W a = x;
+    const W b = y;
+    x = (a & Low) | ((b & Low) << Shift);
+    y = ((a & High) >> Shift) | (b & High);
+}
+
+/// @brief 正交化，在按字节排列和按位排列之间转换，自身是自己的逆
+template<typename W>
+constexpr void ortho(State<W>& q) noexcept {
+    constexpr auto m1l = 0x5555555555555555ull, m1h = 0xAAAAAAAAAAAAAAAAull;
+    constexpr auto m2l = 0x3333333333333333ull, m2h = 0xCCCCCCCCCCCCCCCCull;
+    constexpr auto m4l = 0x0F0F0F0F0F0F0F0Full, m4h = 0xF0F0F0F0F0F0F0F0ull;
+    swap_bits<m1l, m1h, 1>(q[0], q[1]);
+    swap_bits<m1l, m1h, 1>(q[2], q[3]);
+    swap_bits<m1l, m1h, 1>(q[4], q[5]);
+    swap_bits<m1l, m1h, 1>(q[6], q[7]);
+
+    swap_bits<m2l, m2h, 2>(q[0], q[2]);
+    swap_bits<m2l, m2h, 2>(q[1], q[3]);
+    swap_bits<m2l, m2h, 2>(q[4], q[6]);
+    swap_bits<m2l, m2h, 2>(q[5], q[7]);
+
+    swap_bits<m4l, m4h, 4>(q[0], q[4]);
+    swap_bits<m4l, m4h, 4>(q[1], q[5]);
+    swap_bits<m4l, m4h, 4>(q[2], q[6]);
+    swap_bits<m4l, m4h, 4>(q[3], q[7]);
+}
+
+/// @brief 把一个数据块的 4 列交错存入两个 64 位字
+constexpr void interleave_in(std::uint64_t& q0, std::uint64_t& q1, const std::uint32_t* w) noexcept {
+    std::uint64_t x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+    x0 |= x0 << 16;
+    x1 |= x1 << 16;
+    x2 |= x2 << 16;
+    x3 |= x3 << 16;
+    x0 &= 0x0000FFFF0000FFFFull;
+    x1 &= 0x0000FFFF0000FFFFull;
+    x2 &= 0x0000FFFF0000FFFFull;
+    x3 &= 0x0000FFFF0000FFFFull;
+    x0 |= x0 << 8;
+    x1 |= x1 << 8;
+    x2 |= x2 << 8;
+    x3 |= x3 << 8;
+    x0 &= 0x00FF00FF00FF00FFull;
+    x1 &= 0x00FF00FF00FF00FFull;
+    x2 &= 0x00FF00FF00FF00FFull;
+    x3 &= 0x00FF00FF00FF00FFull;
+    q0 = x0 | (x2 << 8);
+    q1 = x1 | (x3 << 8);
+}
+
+/// @brief interleave_in 的逆操作
+constexpr void interleave_out(std::uint32_t* w, const std::uint64_t q0, const std::uint64_t q1) noexcept {
+    auto x0 = q0 & 0x00FF00FF00FF00FFull;
+    auto x1 = q1 & 0x00FF00FF00FF00FFull;
+    auto x2 = (q0 >> 8) & 0x00FF00FF00FF00FFull;
+    auto x3 = (q1 >> 8) & 0x00FF00FF00FF00FFull;
+    x0 |= x0 >> 8;
+    x1 |= x1 >> 8;
+    x2 |= x2 >> 8;
+    x3 |= x3 >> 8;
+    x0 &= 0x0000FFFF0000FFFFull;
+    x1 &= 0x0000FFFF0000FFFFull;
+    x2 &= 0x0000FFFF0000FFFFull;
+    x3 &= 0x0000FFFF0000FFFFull;
+    w[0] = static_cast<std::uint32_t>(x0 | (x0 >> 16));
+    w[1] = static_cast<std::uint32_t>(x1 | (x1 >> 16));
+    w[2] = static_cast<std::uint32_t>(x2 | (x2 >> 16));
+    w[3] = static_cast<std::uint32_t>(x3 | (x3 >> 16));
+}
+
+/// @brief 行移位
+template<typename W>
+constexpr void shift_rows(State<W>& q) noexcept {
+    for (auto& x: q) {
+        x = (x & 0x000000000000FFFFull)
+            | ((x & 0x00000000FFF00000ull) >> 4)
+            | ((x & 0x00000000000F0000ull) << 12)
+            | ((x & 0x0000FF0000000000ull) >> 8)
+            | ((x & 0x000000FF00000000ull) << 8)
+            | ((x & 0xF000000000000000ull) >> 12)
+            | ((x & 0x0FFF000000000000ull) << 4);
+    }
+}
+
+/// @brief 逆行移位
+template<typename W>
+constexpr void inv_shift_rows(State<W>& q) noexcept {
+    for (auto& x: q) {
+        x = (x & 0x000000000000FFFFull)
+            | ((x & 0x000000000FFF0000ull) << 4)
+            | ((x & 0x00000000F0000000ull) >> 12)
+            | ((x & 0x000000FF00000000ull) << 8)
+            | ((x & 0x0000FF0000000000ull) >> 8)
+            | ((x & 0x000F000000000000ull) << 12)
+            | ((x & 0xFFF0000000000000ull) >> 4);
+    }
+}
+
+/// @brief 每个 64 位通道内循环移动 32 位
+template<typename W>
+constexpr W rotr32(const W x) noexcept {
+    return (x << 32) | (x >> 32);
+}
+
+/// @brief 每个 64 位通道内循环移动 16 位，即把每列移动一行
+template<typename W>
+constexpr W rotr16(const W x) noexcept {
+    return (x >> 16) | (x << 48);
+}
+
+/// @brief 列混合
+template<typename W>
+constexpr void mix_columns(State<W>& q) noexcept {
+    const W q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    const W q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    const W r0 = rotr16(q0), r1 = rotr16(q1), r2 = rotr16(q2), r3 = rotr16(q3);
+    const W r4 = rotr16(q4), r5 = rotr16(q5), r6 = rotr16(q6), r7 = rotr16(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ rotr32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ rotr32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ rotr32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ rotr32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ rotr32(q7 ^ r7);
+}
+
+/// @brief 逆列混合
+template<typename W>
+constexpr void inv_mix_columns(State<W>& q) noexcept {
+    const W q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    const W q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    const W r0 = rotr16(q0), r1 = rotr16(q1), r2 = rotr16(q2), r3 = rotr16(q3);
+    const W r4 = rotr16(q4), r5 = rotr16(q5), r6 = rotr16(q6), r7 = rotr16(q7);
+
+    q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^ rotr32(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+    q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+    q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^ rotr32(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+    q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5 ^ rotr32(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+    q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+    q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7 ^ rotr32(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+    q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7 ^ rotr32(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+    q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7 ^ rotr32(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+}
+
+/// @brief 轮密钥异或，轮密钥在每个通道中相同
+template<typename W>
+constexpr void add_round_key(State<W>& q, const std::uint64_t* key) noexcept {
+    for (std::size_t i = 0; i < 8; ++i) q[i] ^= key[i];
+}
+
+/// @brief 位切片加密
+/// @param keys 位切片轮密钥，每轮 8 个字
+template<std::size_t NRound, typename W>
+constexpr void encrypt(State<W>& q, const std::uint64_t* keys) noexcept {
+    add_round_key(q, keys);
+    for (std::size_t round = 1; round < NRound; ++round) {
+        sbox(q);
+        shift_rows(q);
+        mix_columns(q);
+        add_round_key(q, keys + round * 8);
+    }
+    sbox(q);
+    shift_rows(q);
+    add_round_key(q, keys + NRound * 8);
+}
+
+/// @brief 位切片解密，使用与加密相同的轮密钥
+/// @param keys 位切片轮密钥，每轮 8 个字
+template<std::size_t NRound, typename W>
+constexpr void decrypt(State<W>& q, const std::uint64_t* keys) noexcept {
+    add_round_key(q, keys + NRound * 8);
+    for (auto round = NRound - 1; round > 0; --round) {
+        inv_shift_rows(q);
+        inv_sbox(q);
+        add_round_key(q, keys + round * 8);
+        inv_mix_columns(q);
+    }
+    inv_shift_rows(q);
+    inv_sbox(q);
+    add_round_key(q, keys);
+}
+
+/// @brief 把 4 个连续数据块交错存入 8 个字，尚未正交化
+/// @param blocks 4 * 16 字节数据，不要求对齐
+constexpr State<std::uint64_t> interleave_lane(const std::uint8_t* blocks) noexcept {
+    State<std::uint64_t> q{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        std::array<std::uint32_t, 4> w{};
+        for (std::size_t col = 0; col < 4; ++col) w[col] = load_u32le(blocks + i * 16 + col * 4);
+        interleave_in(q[i], q[i + 4], w.data());
+    }
+    return q;
+}
+
+/// @brief interleave_lane 的逆操作
+/// @param blocks 4 * 16 字节数据，不要求对齐
+constexpr void deinterleave_lane(const State<std::uint64_t>& q, std::uint8_t* blocks) noexcept {
+    for (std::size_t i = 0; i < 4; ++i) {
+        std::array<std::uint32_t, 4> w{};
+        interleave_out(w.data(), q[i], q[i + 4]);
+        for (std::size_t col = 0; col < 4; ++col) store_u32le(blocks + i * 16 + col * 4, w[col]);
+    }
+}
+
+/// @brief 把 4 个连续数据块载入位切片状态
+/// @param blocks 4 * 16 字节数据，不要求对齐
+constexpr State<std::uint64_t> load_lane(const std::uint8_t* blocks) noexcept {
+    auto q = interleave_lane(blocks);
+    ortho(q);
+    return q;
+}
+
+/// @brief 把位切片状态写回 4 个连续数据块
+/// @param blocks 4 * 16 字节数据，不要求对齐
+constexpr void store_lane(State<std::uint64_t> q, std::uint8_t* blocks) noexcept {
+    ortho(q);
+    deinterleave_lane(q, blocks);
+}
+
+/// @brief 常数时间的字节替换，不查表
+/// @details 把 4 个字节的第 i 位收集到同一个 32 位整数里，复用 S 盒电路
+[[nodiscard]] constexpr std::uint32_t sub_word(const std::uint32_t word) noexcept {
+    State<std::uint32_t> planes{};
+    for (std::size_t i = 0; i < 8; ++i) planes[i] = (word >> i) & 0x01010101u;
+    sbox(planes);
+    std::uint32_t result = 0;
+    for (std::size_t i = 0; i < 8; ++i) result |= (planes[i] & 0x01010101u) << i;
+    return result;
+}
+
+/// @brief 常数时间地扩展加密轮密钥
+/// @param mainKey 主密钥
+/// @param words 输出的轮密钥字，小端序，一列一个字
+template<std::size_t NBytes, std::size_t NWordCount>
+constexpr void expand_words(const std::array<std::uint8_t, NBytes>& mainKey, std::array<std::uint32_t, NWordCount>& words) noexcept {
+    constexpr auto NWord = NBytes / 4;
+    for (std::size_t i = 0; i < NWord; ++i)
+        words[i] = load_u32le(mainKey.data() + i * 4);
+
+    RoundConstant round_constant{};
+    for (auto i = NWord; i < NWordCount; ++i) {
+        auto temp = words[i - 1];
+        if (i % NWord == 0)
+            temp = sub_word(temp >> 8 | temp << 24) ^ round_constant.step();
+        else if (NWord > 6 && i % NWord == 4)
+            temp = sub_word(temp);
+        words[i] = words[i - NWord] ^ temp;
+    }
+}
+
+}
+
+/// @brief 位切片轮密钥，常数时间实现，没有依赖秘密数据的内存访问和分支
+/// @details 64 位字中保存 4 个数据块同一位置的位，向量实现每次处理 bitslice::blocks_per_vector 个数据块。
+/// 单个数据块补齐为 4 个数据块后计算。
+template<std::size_t NRound>
+struct BitsliceRoundKeys {
+    /// @brief 标准定义的轮数
+    static constexpr auto round_count = NRound;
+
+    /// @brief 轮密钥数
+    static constexpr auto key_count = round_count + 1;
+
+    /// @brief 位切片轮密钥，每轮 8 个字，加密和解密共用
+    alignas(64) std::array<std::uint64_t, 8 * key_count> sliced;
+
+    /// @brief 从字节列表主钥展开轮钥
+    /// @param mainKey 主钥
+    /// @return 轮钥
+    static constexpr BitsliceRoundKeys from_array(const auto& mainKey) {
+        BitsliceRoundKeys result;
+        result.expand_from(mainKey);
+        return result;
+    }
+
+    /// @brief 从主密钥扩展得到轮密钥
+    /// @tparam NBytes 主密钥字节数
+    /// @param mainKey 主密钥数据
+    template<std::size_t NBytes>
+    constexpr void expand_from(const std::array<std::uint8_t, NBytes>& mainKey) {
+        std::array<std::uint32_t, 4 * key_count> words{};
+        bitslice::expand_words(mainKey, words);
+        for (std::size_t round = 0; round < key_count; ++round) {
+            bitslice::State<std::uint64_t> q{};
+            for (std::size_t i = 0; i < 4; ++i)
+                bitslice::interleave_in(q[i], q[i + 4], words.data() + round * 4);
+            bitslice::ortho(q);
+            for (std::size_t i = 0; i < 8; ++i) sliced[round * 8 + i] = q[i];
+        }
+    }
+
+    /// @brief 加密数据，直接在原数据上操作
+    constexpr void encrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+        std::array<std::uint8_t, 16 * bitslice::blocks_per_lane> padded{};
+        for (std::size_t i = 0; i < 16; ++i) padded[i] = origin[i];
+        auto q = bitslice::load_lane(padded.data());
+        bitslice::encrypt<NRound>(q, sliced.data());
+        bitslice::store_lane(q, padded.data());
+        for (std::size_t i = 0; i < 16; ++i) origin[i] = padded[i];
+    }
+
+    /// @brief 解密数据，直接在原数据上操作
+    constexpr void decrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+        std::array<std::uint8_t, 16 * bitslice::blocks_per_lane> padded{};
+        for (std::size_t i = 0; i < 16; ++i) padded[i] = origin[i];
+        auto q = bitslice::load_lane(padded.data());
+        bitslice::decrypt<NRound>(q, sliced.data());
+        bitslice::store_lane(q, padded.data());
+        for (std::size_t i = 0; i < 16; ++i) origin[i] = padded[i];
+    }
+
+    /// @brief 加密连续的多个数据块
+    /// @param in 输入数据，count * 16 字节
+    /// @param out 输出数据，count * 16 字节，可以与输入相同
+    void encrypt_blocks(const std::uint8_t* in, std::uint8_t* out, const std::size_t count) const noexcept {
+        process_blocks<true>(in, out, count);
+    }
+
+    /// @brief 解密连续的多个数据块
+    /// @param in 输入数据，count * 16 字节
+    /// @param out 输出数据，count * 16 字节，可以与输入相同
+    void decrypt_blocks(const std::uint8_t* in, std::uint8_t* out, const std::size_t count) const noexcept {
+        process_blocks<false>(in, out, count);
+    }
+
+private:
+    template<bool Encrypt>
+    void process_blocks(const std::uint8_t* in, std::uint8_t* out, std::size_t count) const noexcept {
+        using bitslice::vector_t;
+        constexpr auto lanes = sizeof(vector_t) / sizeof(std::uint64_t);
+        constexpr auto lane_bytes = 16 * bitslice::blocks_per_lane;
+
+        while (count >= bitslice::blocks_per_vector) {
+            bitslice::State<vector_t> q{};
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                const auto part = bitslice::interleave_lane(in + lane * lane_bytes);
+                for (std::size_t i = 0; i < 8; ++i) set_lane(q[i], lane, part[i]);
+            }
+            bitslice::ortho(q);
+            if constexpr (Encrypt) bitslice::encrypt<NRound>(q, sliced.data());
+            else bitslice::decrypt<NRound>(q, sliced.data());
+            bitslice::ortho(q);
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                bitslice::State<std::uint64_t> part{};
+                for (std::size_t i = 0; i < 8; ++i) part[i] = get_lane(q[i], lane);
+                bitslice::deinterleave_lane(part, out + lane * lane_bytes);
+            }
+            in += bitslice::blocks_per_vector * 16;
+            out += bitslice::blocks_per_vector * 16;
+            count -= bitslice::blocks_per_vector;
+        }
+
+        while (count > 0) {
+            const auto n = count < bitslice::blocks_per_lane ? count : bitslice::blocks_per_lane;
+            std::array<std::uint8_t, lane_bytes> padded{};
+            for (std::size_t i = 0; i < n * 16; ++i) padded[i] = in[i];
+            auto q = bitslice::load_lane(padded.data());
+            if constexpr (Encrypt) bitslice::encrypt<NRound>(q, sliced.data());
+            else bitslice::decrypt<NRound>(q, sliced.data());
+            bitslice::store_lane(q, padded.data());
+            for (std::size_t i = 0; i < n * 16; ++i) out[i] = padded[i];
+            in += n * 16;
+            out += n * 16;
+            count -= n;
+        }
+    }
+
+    template<typename V>
+    static void set_lane(V& v, [[maybe_unused]] const std::size_t lane, const std::uint64_t x) noexcept {
+        if constexpr (sizeof(V) == sizeof(std::uint64_t)) v = x;
+        else v[lane] = x;
+    }
+
+    template<typename V>
+    static std::uint64_t get_lane(const V& v, [[maybe_unused]] const std::size_t lane) noexcept {
+        if constexpr (sizeof(V) == sizeof(std::uint64_t)) return v;
+        else return v[lane];
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_BITSLICE
@@ -0,0 +1,63 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_BLOCKS
+#define INCLUDE_CANGO_AES_DETAILS_BLOCKS
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace cango::aes::details {
+
+/// @brief 提供多块接口的轮密钥，多块接口内部会交错处理多个数据块
+template<typename TRoundKeys>
+concept BulkRoundKeys = requires(const TRoundKeys& keys, const std::uint8_t* in, std::uint8_t* out, std::size_t count) {
+    keys.encrypt_blocks(in, out, count);
+    keys.decrypt_blocks(in, out, count);
+};
+
+/// @brief 处理连续的多个数据块，轮密钥没有多块接口时逐块处理
+/// @param in 输入数据，count * 16 字节，不要求对齐
+/// @param out 输出数据，count * 16 字节，不要求对齐，可以与输入相同，否则不能与输入重叠
+template<bool Encrypt, typename TRoundKeys>
+void process_blocks(const TRoundKeys& keys, const std::uint8_t* in, std::uint8_t* out, std::size_t count) noexcept {
+    if constexpr (BulkRoundKeys<TRoundKeys>) {
+        if constexpr (Encrypt) keys.encrypt_blocks(in, out, count);
+        else keys.decrypt_blocks(in, out, count);
+    }
+    else {
+        for (; count > 0; --count, in += 16, out += 16) {
+            std::array<std::uint8_t, 16> block;
+            std::memcpy(block.data(), in, 16);
+            if constexpr (Encrypt) keys.encrypt(block);
+            else keys.decrypt(block);
+            std::memcpy(out, block.data(), 16);
+        }
+    }
+}
+
+/// @brief 直接在调用方的内存上处理一个块，轮密钥有 span 接口时直接调用，否则经由多块接口读写，不复制到临时的块
+/// @details 编译期求值不能重新解释内存，逐字节复制到临时的块中处理
+/// @param out 可以与 in 是同一段内存，否则不能与 in 重叠
+template<bool Encrypt, typename TRoundKeys>
+constexpr void process_block(const TRoundKeys& keys, const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) noexcept {
+    if constexpr (requires { keys.encrypt(in, out); keys.decrypt(in, out); }) {
+        if constexpr (Encrypt) keys.encrypt(in, out);
+        else keys.decrypt(in, out);
+    }
+    else if (std::is_constant_evaluated()) {
+        std::array<std::uint8_t, 16> block{};
+        for (std::size_t i = 0; i < 16; ++i) block[i] = static_cast<std::uint8_t>(in[i]);
+        if constexpr (Encrypt) keys.encrypt(block);
+        else keys.decrypt(block);
+        for (std::size_t i = 0; i < 16; ++i) out[i] = static_cast<std::byte>(block[i]);
+    }
+    else {
+        process_blocks<Encrypt>(keys, reinterpret_cast<const std::uint8_t*>(in.data()), reinterpret_cast<std::uint8_t*>(out.data()), 1);
+    }
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_BLOCKS
@@ -0,0 +1,79 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_COUNTER
+#define INCLUDE_CANGO_AES_DETAILS_COUNTER
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "word.hpp"
+
+namespace cango::aes::details {
+
+/// @brief 计数器块末尾的计数器位数是否受支持
+template<std::size_t NBits>
+concept CounterBits = NBits == 32 || NBits == 64 || NBits == 128;
+
+/// @brief 计数器块加上 n
+/// @details 计数器块末尾 NBits 位视为大端整数，只在这 NBits 位内进位和回绕，前面的 nonce 保持不变。
+/// @tparam NBits 计数器位数，32, 64 或 128
+template<std::size_t NBits> requires CounterBits<NBits>
+constexpr void add_counter(std::array<std::uint8_t, 16>& block, std::uint64_t n) noexcept {
+    unsigned carry = 0;
+    for (std::size_t i = 16; i-- > 16 - NBits / 8;) {
+        const unsigned sum = block[i] + static_cast<unsigned>(n & 0xff) + carry;
+        block[i] = static_cast<std::uint8_t>(sum);
+        carry = sum >> 8;
+        n >>= 8;
+    }
+}
+
+/// @brief 计数器块加一
+template<std::size_t NBits> requires CounterBits<NBits>
+constexpr void increment_counter(std::array<std::uint8_t, 16>& block) noexcept {
+    for (std::size_t i = 16; i-- > 16 - NBits / 8;)
+        if (++block[i] != 0) break;
+}
+
+/// @brief 从同一个初始计数器开始处理 size 字节是否超出 NCounterBits 位计数器的范围，超出时计数器回绕，重复使用密钥流
+/// @param reserved 同一个计数器空间中另作他用的计数器值个数，如 GCM 用于标签的 J0
+template<std::size_t NCounterBits>
+[[nodiscard]] constexpr bool exceeds_counter(const std::uint64_t size, const std::uint64_t reserved = 0) noexcept {
+    // 64 位字节数最多 2^60 块，64 位以上的计数器不会回绕
+    if constexpr (NCounterBits >= 64) return false;
+    else return size / 16 + (size % 16 != 0) + reserved > std::uint64_t{1} << NCounterBits;
+}
+
+/// @brief 从 start 开始连续写出 count 个计数器块
+/// @details 计数值保存在整数寄存器中递增，每块只整体写一次，
+/// 避免逐字节修改后再整块读回时的存储转发失败。
+template<std::size_t NBits> requires CounterBits<NBits>
+void fill_counters(const std::array<std::uint8_t, 16>& start, std::uint8_t* out, const std::size_t count) noexcept {
+    if constexpr (NBits == 32) {
+        auto counter = load_u32be(start.data() + 12);
+        for (std::size_t i = 0; i < count; ++i, out += 16, ++counter) {
+            std::memcpy(out, start.data(), 12);
+            store_u32be(out + 12, counter);
+        }
+    }
+    else if constexpr (NBits == 64) {
+        auto counter = load_u64be(start.data() + 8);
+        for (std::size_t i = 0; i < count; ++i, out += 16, ++counter) {
+            std::memcpy(out, start.data(), 8);
+            store_u64be(out + 8, counter);
+        }
+    }
+    else {
+        auto hi = load_u64be(start.data());
+        auto lo = load_u64be(start.data() + 8);
+        for (std::size_t i = 0; i < count; ++i, out += 16) {
+            store_u64be(out, hi);
+            store_u64be(out + 8, lo);
+            hi += ++lo == 0;
+        }
+    }
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_COUNTER
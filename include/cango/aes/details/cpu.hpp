@@ -0,0 +1,115 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_CPU
+#define INCLUDE_CANGO_AES_DETAILS_CPU
+
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(CANGO_AES_PORTABLE)
+/// @brief 是否编译 x86 专用的硬件加速实现，定义 CANGO_AES_PORTABLE 可强制只使用可移植实现
+#define CANGO_AES_X86 1
+#else
+#define CANGO_AES_X86 0
+#endif
+
+#if CANGO_AES_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+/// @brief 为单个函数开启指令集扩展，使同一个二进制文件可以在不支持该扩展的机器上运行
+#define CANGO_AES_TARGET(features) __attribute__((target(features)))
+#else
+#define CANGO_AES_TARGET(features)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+/// @brief 要求编译器完全展开紧随其后的定长循环，使交错处理的各块状态留在寄存器中
+#define CANGO_AES_UNROLL _Pragma("GCC unroll 16")
+#else
+#define CANGO_AES_UNROLL
+#endif
+
+namespace cango::aes::details {
+
+/// @brief 运行时检测到的 CPU 特性
+struct CpuFeatures {
+    bool sse2;
+    bool ssse3;
+    bool sse41;
+    bool aes;
+    bool pclmul;
+    bool avx;
+    bool avx2;
+    bool avx512f;
+    bool avx512bw;
+    bool sha;
+};
+
+#if CANGO_AES_X86
+/// @brief 执行 cpuid 指令
+/// @return eax, ebx, ecx, edx
+inline void cpuid(const unsigned leaf, const unsigned subleaf, unsigned (&regs)[4]) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int result[4];
+    __cpuidex(result, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(result[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/// @brief 读取 XCR0 ，判断操作系统是否保存了扩展寄存器
+inline unsigned long long read_xcr0() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return static_cast<unsigned long long>(edx) << 32 | eax;
+#endif
+}
+#endif
+
+/// @brief 检测当前 CPU 支持的特性
+[[nodiscard]] inline CpuFeatures detect_cpu_features() noexcept {
+    CpuFeatures features{};
+#if CANGO_AES_X86
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    const auto max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    const auto ecx = regs[2];
+    const auto edx = regs[3];
+    features.sse2 = (edx >> 26) & 1;
+    features.pclmul = (ecx >> 1) & 1;
+    features.ssse3 = (ecx >> 9) & 1;
+    features.sse41 = (ecx >> 19) & 1;
+    features.aes = (ecx >> 25) & 1;
+
+    const bool os_saves_ymm = ((ecx >> 27) & 1) && (read_xcr0() & 0x6) == 0x6;
+    const bool os_saves_zmm = os_saves_ymm && (read_xcr0() & 0xe0) == 0xe0;
+    features.avx = os_saves_ymm && ((ecx >> 28) & 1);
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        const auto ebx = regs[1];
+        features.avx2 = features.avx && ((ebx >> 5) & 1);
+        features.avx512f = os_saves_zmm && ((ebx >> 16) & 1);
+        features.avx512bw = features.avx512f && ((ebx >> 30) & 1);
+        features.sha = (ebx >> 29) & 1;
+    }
+#endif
+    return features;
+}
+
+/// @brief 当前 CPU 的特性，首次调用时检测，之后直接返回缓存结果
+[[nodiscard]] inline const CpuFeatures& cpu_features() noexcept {
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_CPU
@@ -0,0 +1,205 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_DISPATCH
+#define INCLUDE_CANGO_AES_DETAILS_DISPATCH
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "aesni.hpp"
+#include "bitslice.hpp"
+#include "cpu.hpp"
+#include "ttable.hpp"
+#include "vperm.hpp"
+
+namespace cango::aes::details {
+
+/// @brief 加密解密实际使用的实现
+enum class Engine {
+    /// @brief T 表实现
+    table,
+
+    /// @brief AES-NI 指令实现
+    aesni,
+
+    /// @brief 位切片常数时间实现
+    bitslice,
+
+    /// @brief 向量置换(SSSE3)常数时间实现
+    vperm,
+};
+
+/// @brief 当前 CPU 上运行时会选择的实现
+[[nodiscard]] inline Engine active_engine() noexcept {
+#if CANGO_AES_X86
+    if (cpu_features().aes) return Engine::aesni;
+    if (cpu_features().ssse3) return Engine::vperm;
+#endif
+    return Engine::bitslice;
+}
+
+/// @brief 实现的名称，用于日志和测试输出
+[[nodiscard]] constexpr const char* engine_name(const Engine engine) noexcept {
+    switch (engine) {
+        case Engine::aesni: return "aesni";
+        case Engine::table: return "table";
+        case Engine::bitslice: return "bitslice";
+        case Engine::vperm: return "vperm";
+    }
+    return "unknown";
+}
+
+/// @brief 按运行时 CPU 特性选择实现的轮密钥
+/// @details 轮密钥与 TableRoundKeys 的布局相同，在 x86 上即为标准字节顺序，
+/// 因此 AES-NI 可以直接载入，不需要经过 StateMatrix 转换。
+/// CPU 不支持 AES-NI 时优先使用常数时间的向量置换实现，连 SSSE3 也不支持时使用位切片实现，
+/// 编译期求值使用 T 表实现。
+/// 运行时扩展密钥只生成所选实现需要的轮密钥；编译期扩展时无法得知运行的 CPU ，
+/// 因此 T 表、位切片和向量置换三份轮密钥都会生成，AES-NI 直接使用 T 表轮密钥。
+template<std::size_t NRound>
+struct DispatchRoundKeys {
+    /// @brief 标准定义的轮数
+    static constexpr auto round_count = NRound;
+
+    /// @brief 轮密钥数
+    static constexpr auto key_count = round_count + 1;
+
+    /// @brief 轮密钥，同时也是 T 表实现
+    TableRoundKeys<NRound> table;
+
+    /// @brief 位切片轮密钥
+    BitsliceRoundKeys<NRound> sliced;
+
+    /// @brief 向量置换轮密钥
+    VpermRoundKeys<NRound> vperm;
+
+    /// @brief 从字节列表主钥展开轮钥
+    /// @param mainKey 主钥
+    /// @return 轮钥
+    static constexpr DispatchRoundKeys from_array(const auto& mainKey) {
+        DispatchRoundKeys result;
+        result.expand_from(mainKey);
+        return result;
+    }
+
+    /// @brief 从主密钥扩展得到轮密钥
+    /// @tparam NBytes 主密钥字节数
+    /// @param mainKey 主密钥数据
+    template<std::size_t NBytes>
+    constexpr void expand_from(const std::array<std::uint8_t, NBytes>& mainKey) {
+#if CANGO_AES_X86
+        if (!std::is_constant_evaluated() && cpu_features().aes) {
+            aesni::expand<NRound, NBytes>(mainKey.data(), table.enc.data(), table.dec.data());
+            return;
+        }
+        if (!std::is_constant_evaluated() && cpu_features().ssse3) {
+            vperm.expand_from(mainKey);
+            return;
+        }
+#endif
+        sliced.expand_from(mainKey);
+        if (std::is_constant_evaluated()) {
+            table.expand_from(mainKey);
+            vperm.expand_from(mainKey);
+        }
+    }
+
+    /// @brief 批量扩展多个主密钥
+    /// @details 支持 AES-NI 时每 aesni::expand_interleave 个密钥交错扩展，字节替换用 AESENCLAST 完成，
+    /// 不使用吞吐量很低的 AESKEYGENASSIST ；否则逐个调用 expand_from 。
+    /// @param keys_of 以序号 i 调用，返回第 i 个主密钥对应的轮密钥对象的引用
+    template<std::size_t NBytes, typename TKeysOf>
+    static void expand_many(const std::array<std::uint8_t, NBytes>* mainKeys, const std::size_t count, const TKeysOf& keys_of) noexcept {
+        std::size_t i = 0;
+#if CANGO_AES_X86
+        if (cpu_features().aes && cpu_features().ssse3) {
+            const auto expand_group = [&]<std::size_t NLanes>(std::integral_constant<std::size_t, NLanes>) {
+                const std::uint8_t* keys[NLanes];
+                void* enc[NLanes];
+                void* dec[NLanes];
+                for (std::size_t lane = 0; lane < NLanes; ++lane) {
+                    auto& target = keys_of(i + lane);
+                    keys[lane] = mainKeys[i + lane].data();
+                    enc[lane] = target.table.enc.data();
+                    dec[lane] = target.table.dec.data();
+                }
+                aesni::expand_lanes<NRound, NBytes, NLanes>(keys, enc, dec);
+                i += NLanes;
+            };
+            while (i + aesni::expand_interleave <= count) expand_group(std::integral_constant<std::size_t, aesni::expand_interleave>{});
+            while (i < count) expand_group(std::integral_constant<std::size_t, 1>{});
+            return;
+        }
+#endif
+        for (; i < count; ++i) keys_of(i).expand_from(mainKeys[i]);
+    }
+
+    /// @brief 加密数据，直接在原数据上操作
+    constexpr void encrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+#if CANGO_AES_X86
+        if (!std::is_constant_evaluated() && cpu_features().aes) {
+            aesni::encrypt<NRound>(table.enc.data(), origin.data());
+            return;
+        }
+        if (!std::is_constant_evaluated() && cpu_features().ssse3) {
+            vperm.encrypt(origin);
+            return;
+        }
+#endif
+        if (std::is_constant_evaluated()) table.encrypt(origin);
+        else sliced.encrypt(origin);
+    }
+
+    /// @brief 解密数据，直接在原数据上操作
+    constexpr void decrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+#if CANGO_AES_X86
+        if (!std::is_constant_evaluated() && cpu_features().aes) {
+            aesni::decrypt<NRound>(table.dec.data(), origin.data());
+            return;
+        }
+        if (!std::is_constant_evaluated() && cpu_features().ssse3) {
+            vperm.decrypt(origin);
+            return;
+        }
+#endif
+        if (std::is_constant_evaluated()) table.decrypt(origin);
+        else sliced.decrypt(origin);
+    }
+
+    /// @brief 加密连续的多个数据块
+    /// @param in 输入数据，count * 16 字节
+    /// @param out 输出数据，count * 16 字节，可以与输入相同
+    void encrypt_blocks(const std::uint8_t* in, std::uint8_t* out, const std::size_t count) const noexcept {
+#if CANGO_AES_X86
+        if (cpu_features().aes) {
+            aesni::encrypt_blocks<NRound>(table.enc.data(), in, out, count);
+            return;
+        }
+        if (cpu_features().ssse3) {
+            vperm.encrypt_blocks(in, out, count);
+            return;
+        }
+#endif
+        sliced.encrypt_blocks(in, out, count);
+    }
+
+    /// @brief 解密连续的多个数据块
+    /// @param in 输入数据，count * 16 字节
+    /// @param out 输出数据，count * 16 字节，可以与输入相同
+    void decrypt_blocks(const std::uint8_t* in, std::uint8_t* out, const std::size_t count) const noexcept {
+#if CANGO_AES_X86
+        if (cpu_features().aes) {
+            aesni::decrypt_blocks<NRound>(table.dec.data(), in, out, count);
+            return;
+        }
+        if (cpu_features().ssse3) {
+            vperm.decrypt_blocks(in, out, count);
+            return;
+        }
+#endif
+        sliced.decrypt_blocks(in, out, count);
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_DISPATCH
@@ -0,0 +1,235 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_GHASH
+#define INCLUDE_CANGO_AES_DETAILS_GHASH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu.hpp"
+
+namespace cango::aes::details::ghash {
+
+/// @brief GF(2^128) 中的元素，按 GCM 的位序，hi 为字节 0..7 的大端整数，lo 为字节 8..15
+struct Element {
+    std::uint64_t hi;
+    std::uint64_t lo;
+
+    friend constexpr bool operator==(const Element&, const Element&) noexcept = default;
+};
+
+/// @brief 从 16 字节载入元素
+[[nodiscard]] constexpr Element load(const std::uint8_t* bytes) noexcept {
+    Element result{};
+    for (std::size_t i = 0; i < 8; ++i) {
+        result.hi = result.hi << 8 | bytes[i];
+        result.lo = result.lo << 8 | bytes[i + 8];
+    }
+    return result;
+}
+
+/// @brief 把元素存为 16 字节
+constexpr void store(const Element& x, std::uint8_t* bytes) noexcept {
+    for (std::size_t i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(x.hi >> (56 - 8 * i));
+        bytes[i + 8] = static_cast<std::uint8_t>(x.lo >> (56 - 8 * i));
+    }
+}
+
+/// @brief 逐位乘法，按 SP 800-38D 算法 1 ，只用于生成表和测试
+[[nodiscard]] constexpr Element multiply_bitwise(const Element& x, Element v) noexcept {
+    Element z{};
+    for (std::size_t i = 0; i < 128; ++i) {
+        const auto bit = i < 64 ? (x.hi >> (63 - i)) & 1 : (x.lo >> (127 - i)) & 1;
+        const auto mask = 0 - bit;
+        z.hi ^= v.hi & mask;
+        z.lo ^= v.lo & mask;
+        const auto carry = v.lo & 1;
+        v.lo = v.lo >> 1 | v.hi << 63;
+        v.hi = v.hi >> 1 ^ (0xe100000000000000ull & (0 - carry));
+    }
+    return z;
+}
+
+/// @brief 4 位表乘法中右移 4 位时移出部分的约简值
+inline constexpr std::array<std::uint64_t, 16> last4 = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0,
+};
+
+/// @brief Shoup 4 位表，第 i 项为 i * H ，用于没有 PCLMULQDQ 的 CPU
+/// @note 查表下标依赖数据，不是常数时间
+struct Table {
+    std::array<Element, 16> entries;
+
+    /// @brief 由 H 生成表
+    static constexpr Table from(const Element& h) noexcept {
+        Table result{};
+        auto& m = result.entries;
+        m[8] = h;
+        for (std::size_t i = 4; i > 0; i >>= 1) {
+            auto v = m[i * 2];
+            const auto carry = v.lo & 1;
+            v.lo = v.lo >> 1 | v.hi << 63;
+            v.hi = v.hi >> 1 ^ (0xe100000000000000ull & (0 - carry));
+            m[i] = v;
+        }
+        for (std::size_t i = 2; i <= 8; i *= 2)
+            for (std::size_t j = 1; j < i; ++j)
+                m[i + j] = {m[i].hi ^ m[j].hi, m[i].lo ^ m[j].lo};
+        return result;
+    }
+
+    /// @brief 计算 x * H
+    [[nodiscard]] constexpr Element multiply(const Element& x) const noexcept {
+        std::array<std::uint8_t, 16> bytes{};
+        store(x, bytes.data());
+        Element z = entries[bytes[15] & 0x0f];
+        for (std::size_t i = 16; i-- > 0;) {
+            if (i != 15) {
+                shift4(z);
+                z.hi ^= entries[bytes[i] & 0x0f].hi;
+                z.lo ^= entries[bytes[i] & 0x0f].lo;
+            }
+            shift4(z);
+            z.hi ^= entries[bytes[i] >> 4].hi;
+            z.lo ^= entries[bytes[i] >> 4].lo;
+        }
+        return z;
+    }
+
+private:
+    static constexpr void shift4(Element& z) noexcept {
+        const auto rem = z.lo & 0x0f;
+        z.lo = z.hi << 60 | z.lo >> 4;
+        z.hi = z.hi >> 4 ^ last4[rem] << 48;
+    }
+};
+
+#if CANGO_AES_X86
+/// @brief PCLMULQDQ 实现，元素按字节反序存放在 __m128i 中
+namespace clmul {
+
+/// @brief 每次聚合约简的块数
+inline constexpr std::size_t aggregate = 4;
+
+CANGO_AES_TARGET("ssse3")
+inline __m128i byte_swap(const __m128i x) noexcept {
+    return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+/// @brief 不约简的 256 位无进位乘积，用 4 次 64 位无进位乘法
+CANGO_AES_TARGET("pclmul,sse2")
+inline void multiply_wide(const __m128i a, const __m128i b, __m128i& lo, __m128i& hi) noexcept {
+    const auto mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    lo = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x00), _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x11), _mm_srli_si128(mid, 8));
+}
+
+/// @brief 把 256 位乘积约简为 128 位
+/// @details GCM 的位序是反射的，先整体左移 1 位，再按 x^128 + x^7 + x^2 + x + 1 约简
+CANGO_AES_TARGET("sse2")
+inline __m128i reduce(__m128i lo, __m128i hi) noexcept {
+    const auto lo_carry = _mm_srli_epi32(lo, 31);
+    const auto hi_carry = _mm_srli_epi32(hi, 31);
+    lo = _mm_or_si128(_mm_slli_epi32(lo, 1), _mm_slli_si128(lo_carry, 4));
+    hi = _mm_or_si128(_mm_slli_epi32(hi, 1), _mm_slli_si128(hi_carry, 4));
+    hi = _mm_or_si128(hi, _mm_srli_si128(lo_carry, 12));
+
+    auto t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    const auto spill = _mm_srli_si128(t, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+    t = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    t = _mm_xor_si128(t, spill);
+    return _mm_xor_si128(hi, _mm_xor_si128(lo, t));
+}
+
+/// @brief 计算 a * b
+CANGO_AES_TARGET("pclmul,sse2")
+inline __m128i multiply(const __m128i a, const __m128i b) noexcept {
+    __m128i lo, hi;
+    multiply_wide(a, b, lo, hi);
+    return reduce(lo, hi);
+}
+
+/// @brief 由 H 计算 H, H^2, ..., H^aggregate ，按字节反序存放
+CANGO_AES_TARGET("pclmul,ssse3")
+inline void make_powers(const std::uint8_t* h, std::uint8_t* powers) noexcept {
+    const auto h1 = byte_swap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h)));
+    auto power = h1;
+    for (std::size_t i = 0; i < aggregate; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(powers) + i, power);
+        power = multiply(power, h1);
+    }
+}
+
+/// @brief 吸收 count 个完整块，每 aggregate 块只做一次约简
+/// @param state GHASH 状态，按标准字节顺序
+/// @param powers make_powers 的结果
+CANGO_AES_TARGET("pclmul,ssse3")
+inline void absorb(std::uint8_t* state, const std::uint8_t* powers, const std::uint8_t* data, std::size_t count) noexcept {
+    const auto h = reinterpret_cast<const __m128i*>(powers);
+    auto in = reinterpret_cast<const __m128i*>(data);
+    auto x = byte_swap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)));
+    for (; count >= aggregate; count -= aggregate, in += aggregate) {
+        // (x + c0) H^4 + c1 H^3 + c2 H^2 + c3 H
+        __m128i lo, hi;
+        multiply_wide(_mm_xor_si128(x, byte_swap(_mm_loadu_si128(in))), _mm_loadu_si128(h + aggregate - 1), lo, hi);
+        CANGO_AES_UNROLL
+        for (std::size_t i = 1; i < aggregate; ++i) {
+            __m128i part_lo, part_hi;
+            multiply_wide(byte_swap(_mm_loadu_si128(in + i)), _mm_loadu_si128(h + aggregate - 1 - i), part_lo, part_hi);
+            lo = _mm_xor_si128(lo, part_lo);
+            hi = _mm_xor_si128(hi, part_hi);
+        }
+        x = reduce(lo, hi);
+    }
+    for (; count > 0; --count, ++in)
+        x = multiply(_mm_xor_si128(x, byte_swap(_mm_loadu_si128(in))), _mm_loadu_si128(h));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), byte_swap(x));
+}
+
+}
+#endif
+
+/// @brief GHASH 的密钥部分，由 H 生成，同一个主密钥下的所有消息共用
+struct Key {
+    /// @brief 4 位表，软件实现使用
+    Table table;
+
+    /// @brief H 的幂，PCLMULQDQ 实现使用
+    alignas(16) std::array<std::uint8_t, 16 * 4> powers;
+
+    /// @brief 是否使用 PCLMULQDQ
+    bool use_clmul;
+
+    /// @brief 由 H = E(0) 生成
+    static Key from(const std::array<std::uint8_t, 16>& h) noexcept {
+        Key result{};
+        result.table = Table::from(load(h.data()));
+#if CANGO_AES_X86
+        result.use_clmul = cpu_features().pclmul && cpu_features().ssse3;
+        if (result.use_clmul) clmul::make_powers(h.data(), result.powers.data());
+#endif
+        return result;
+    }
+
+    /// @brief 把 count 个完整块吸收进状态
+    void absorb(std::array<std::uint8_t, 16>& state, const std::uint8_t* data, std::size_t count) const noexcept {
+#if CANGO_AES_X86
+        if (use_clmul) {
+            clmul::absorb(state.data(), powers.data(), data, count);
+            return;
+        }
+#endif
+        auto x = load(state.data());
+        for (; count > 0; --count, data += 16) {
+            const auto block = load(data);
+            x = table.multiply({x.hi ^ block.hi, x.lo ^ block.lo});
+        }
+        store(x, state.data());
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_GHASH
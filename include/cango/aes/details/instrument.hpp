@@ -0,0 +1,215 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_INSTRUMENT
+#define INCLUDE_CANGO_AES_DETAILS_INSTRUMENT
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "cpu.hpp"
+
+#if defined(CANGO_AES_PROFILE_STAGES) && !defined(CANGO_AES_INSTRUMENT)
+/// @brief 分阶段计时依赖计数器
+#define CANGO_AES_INSTRUMENT
+#endif
+
+namespace cango::aes {
+
+/// @brief 参考实现中一个阶段的调用次数和总周期数
+struct StageProfile {
+    std::uint64_t calls = 0;
+    std::uint64_t cycles = 0;
+};
+
+/// @brief 所有线程的计数之和
+/// @details 定义宏 CANGO_AES_INSTRUMENT 时统计块数和密钥扩展次数；再定义 CANGO_AES_PROFILE_STAGES 时，
+/// 参考实现(RoundKeys)的每个阶段前后读取时间戳计数器，非 x86 平台上以纳秒代替周期数。都未定义时所有计数为 0 。
+struct InstrumentCounters {
+    std::uint64_t encrypted_blocks = 0;
+    std::uint64_t decrypted_blocks = 0;
+    std::uint64_t key_expansions = 0;
+
+    StageProfile sub_bytes{};
+    StageProfile shift_rows{};
+    StageProfile mix_columns{};
+    StageProfile add_round_key{};
+
+    /// @brief 加密和解密的字节数
+    [[nodiscard]] constexpr std::uint64_t bytes() const noexcept {
+        return 16 * (encrypted_blocks + decrypted_blocks);
+    }
+
+    /// @brief 两次快照之差，即期间的计数
+    friend constexpr InstrumentCounters operator-(const InstrumentCounters& lhs, const InstrumentCounters& rhs) noexcept {
+        const auto stage = [](const StageProfile& l, const StageProfile& r) { return StageProfile{l.calls - r.calls, l.cycles - r.cycles}; };
+        return {
+            lhs.encrypted_blocks - rhs.encrypted_blocks,
+            lhs.decrypted_blocks - rhs.decrypted_blocks,
+            lhs.key_expansions - rhs.key_expansions,
+            stage(lhs.sub_bytes, rhs.sub_bytes),
+            stage(lhs.shift_rows, rhs.shift_rows),
+            stage(lhs.mix_columns, rhs.mix_columns),
+            stage(lhs.add_round_key, rhs.add_round_key),
+        };
+    }
+};
+
+/// @brief 是否编译了计数器
+inline constexpr bool instrument_enabled =
+#ifdef CANGO_AES_INSTRUMENT
+    true;
+#else
+    false;
+#endif
+
+namespace details::instrument {
+
+enum class Counter : std::size_t {
+    encrypted_blocks,
+    decrypted_blocks,
+    key_expansions,
+    sub_bytes_calls,
+    sub_bytes_cycles,
+    shift_rows_calls,
+    shift_rows_cycles,
+    mix_columns_calls,
+    mix_columns_cycles,
+    add_round_key_calls,
+    add_round_key_cycles,
+    count
+};
+
+inline constexpr auto counter_count = static_cast<std::size_t>(Counter::count);
+
+using values_t = std::array<std::uint64_t, counter_count>;
+
+struct ThreadCounters;
+
+/// @brief 所有存活线程的计数器，以及已退出线程的计数之和
+struct Registry {
+    std::mutex mutex;
+    std::vector<const ThreadCounters*> live;
+    values_t retired{};
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+/// @brief 一个线程的计数器
+/// @details 只有所属线程写入，写入是宽松的读取加存储，不需要带锁前缀的原子加法；
+/// 快照由其他线程以宽松读取汇总。线程退出时把计数并入 retired 。
+struct ThreadCounters {
+    std::array<std::atomic<std::uint64_t>, counter_count> values{};
+
+    ThreadCounters() {
+        auto& shared = registry();
+        const std::lock_guard lock{shared.mutex};
+        shared.live.push_back(this);
+    }
+
+    ThreadCounters(const ThreadCounters&) = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    ~ThreadCounters() {
+        auto& shared = registry();
+        const std::lock_guard lock{shared.mutex};
+        for (std::size_t i = 0; i < counter_count; ++i) shared.retired[i] += values[i].load(std::memory_order_relaxed);
+        std::erase(shared.live, this);
+    }
+};
+
+inline ThreadCounters& local() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+/// @brief 增加当前线程的计数，编译期求值时不计数
+constexpr void add(const Counter counter, const std::uint64_t n) noexcept {
+    if (std::is_constant_evaluated()) return;
+    auto& value = local().values[static_cast<std::size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/// @brief 记录一个阶段的一次调用
+inline void record(const Counter calls, const std::uint64_t cycles) noexcept {
+    add(calls, 1);
+    add(static_cast<Counter>(static_cast<std::size_t>(calls) + 1), cycles);
+}
+
+/// @brief 周期计数，x86 上读取时间戳计数器，其他平台以纳秒代替
+inline std::uint64_t read_cycles() noexcept {
+#if CANGO_AES_X86
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline values_t sum() {
+    auto& shared = registry();
+    const std::lock_guard lock{shared.mutex};
+    auto total = shared.retired;
+    for (const auto* counters: shared.live)
+        for (std::size_t i = 0; i < counter_count; ++i) total[i] += counters->values[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+}
+
+/// @brief 汇总所有线程的计数，包括已退出的线程
+/// @details 计数只增不减；需要某段时间内的计数时，用前后两次快照相减。
+[[nodiscard]] inline InstrumentCounters instrument_snapshot() {
+#ifdef CANGO_AES_INSTRUMENT
+    using details::instrument::Counter;
+    const auto total = details::instrument::sum();
+    const auto at = [&total](const Counter counter) { return total[static_cast<std::size_t>(counter)]; };
+    return {
+        at(Counter::encrypted_blocks),
+        at(Counter::decrypted_blocks),
+        at(Counter::key_expansions),
+        {at(Counter::sub_bytes_calls), at(Counter::sub_bytes_cycles)},
+        {at(Counter::shift_rows_calls), at(Counter::shift_rows_cycles)},
+        {at(Counter::mix_columns_calls), at(Counter::mix_columns_cycles)},
+        {at(Counter::add_round_key_calls), at(Counter::add_round_key_cycles)},
+    };
+#else
+    return {};
+#endif
+}
+
+}
+
+#ifdef CANGO_AES_INSTRUMENT
+/// @brief 增加当前线程的一个计数
+#define CANGO_AES_COUNT(counter, n) ::cango::aes::details::instrument::add(::cango::aes::details::instrument::Counter::counter, (n))
+#else
+#define CANGO_AES_COUNT(counter, n) static_cast<void>(0)
+#endif
+
+#ifdef CANGO_AES_PROFILE_STAGES
+/// @brief 执行参考实现的一个阶段，并记录其调用次数和周期数
+#define CANGO_AES_STAGE(stage, ...)                                                                  \
+    do {                                                                                             \
+        if (std::is_constant_evaluated()) {                                                          \
+            __VA_ARGS__;                                                                             \
+        }                                                                                            \
+        else {                                                                                       \
+            const auto stage_begin = ::cango::aes::details::instrument::read_cycles();               \
+            __VA_ARGS__;                                                                             \
+            ::cango::aes::details::instrument::record(::cango::aes::details::instrument::Counter::stage##_calls, \
+                                                      ::cango::aes::details::instrument::read_cycles() - stage_begin); \
+        }                                                                                            \
+    } while (false)
+#else
+#define CANGO_AES_STAGE(stage, ...) __VA_ARGS__
+#endif
+
+#endif//INCLUDE_CANGO_AES_DETAILS_INSTRUMENT
@@ -2,7 +2,12 @@
 #define INCLUDE_CANGO_AES_DETAILS_KEY
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
 
+#include "instrument.hpp"
 #include "matrix.hpp"
 #include "word.hpp"
 
@@ -20,8 +25,8 @@ struct RoundKeys {
     /// @brief 轮密钥列表的字数
     static constexpr auto word_count = 4 * key_count;
 
-    /// @brief 状态列表
-    std::array<StateMatrix, key_count> states;
+    /// @brief 状态列表，按缓存行对齐，AES-256 的 15 个轮密钥共 240 字节，正好占 4 个缓存行
+    alignas(64) std::array<StateMatrix, key_count> states;
 
     /// @brief 访问目标字
     /// @param index 目标下标
@@ -88,25 +93,30 @@ struct RoundKeys {
         expand_rest<NWord>();
     }
 
+    /// @brief 以 4 个 32 位字保存的状态，第 c 个字为第 c 列，第 r 行位于第 r 个字节(小端序)
+    using columns_t = std::array<std::uint32_t, 4>;
+
     /// @brief 使用轮密钥加密数据，直接在原矩阵上操作
+    /// @details 状态转为 4 个 32 位字后按轮完全展开；定义 CANGO_AES_PROFILE_STAGES 时改用逐阶段的 encrypt_stages 以便分别计时
     /// @param origin 需要加密的数据状态矩阵
     constexpr void encrypt(StateMatrix &origin) const noexcept {
-        origin.add_round_key_inplace(states[0]);
-        for (std::size_t round = 1; round < NRound; ++round) {
-            origin.substitute_with_inplace(SBox);
-            origin.shift_rows_inplace();
-            origin.mix_columns_inplace(CMDSMatrix);
-            origin.add_round_key_inplace(states[round]);
-        }
-        origin.substitute_with_inplace(SBox);
-        origin.shift_rows_inplace();
-        origin.add_round_key_inplace(states[NRound]);
+#ifdef CANGO_AES_PROFILE_STAGES
+        encrypt_stages(origin);
+#else
+        auto columns = load_columns(origin.words[0].data(), origin.words[1].data(), origin.words[2].data(), origin.words[3].data());
+        encrypt_columns(columns);
+        for (std::size_t col = 0; col < 4; ++col) store_u32le(origin.words[col].data(), columns[col]);
+#endif
     }
 
     constexpr void encrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
-        auto mat = StateMatrix::from_array(origin);
-        encrypt(mat);
-        origin = StateMatrix::to_array(mat);
+        crypt_bytes<true>(origin.data(), origin.data());
+    }
+
+    /// @brief 直接在调用方的内存上加密一个块，不要求对齐，不经过临时的块
+    /// @param out 可以与 in 是同一段内存
+    constexpr void encrypt(const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) const noexcept {
+        crypt_bytes<true>(in.data(), out.data());
     }
 
     /// @brief 使用轮密钥加密数据
@@ -121,16 +131,13 @@ struct RoundKeys {
     /// @brief 使用轮密钥接解密数据，直接在原矩阵上操作
     /// @param origin 需要解密的数据状态矩阵
     constexpr void decrypt(StateMatrix &origin) const noexcept {
-        origin.add_round_key_inplace(states[NRound]);
-        for (auto round = NRound - 1; round > 0; --round) {
-            origin.inv_shift_rows_inplace();
-            origin.substitute_with_inplace(InvSBox);
-            origin.add_round_key_inplace(states[round]);
-            origin.mix_columns_inplace(InvCMDSMatrix);
-        }
-        origin.inv_shift_rows_inplace();
-        origin.substitute_with_inplace(InvSBox);
-        origin.add_round_key_inplace(states[0]);
+#ifdef CANGO_AES_PROFILE_STAGES
+        decrypt_stages(origin);
+#else
+        auto columns = load_columns(origin.words[0].data(), origin.words[1].data(), origin.words[2].data(), origin.words[3].data());
+        decrypt_columns(columns);
+        for (std::size_t col = 0; col < 4; ++col) store_u32le(origin.words[col].data(), columns[col]);
+#endif
     }
 
     /// @brief 使用轮密钥接解密数据
@@ -143,9 +150,147 @@ struct RoundKeys {
     }
 
     constexpr void decrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
-        auto mat = StateMatrix::from_array(origin);
-        decrypt(mat);
-        origin = StateMatrix::to_array(mat);
+        crypt_bytes<false>(origin.data(), origin.data());
+    }
+
+    /// @brief 直接在调用方的内存上解密一个块，不要求对齐，不经过临时的块
+    constexpr void decrypt(const std::span<const std::byte, 16> in, const std::span<std::byte, 16> out) const noexcept {
+        crypt_bytes<false>(in.data(), out.data());
+    }
+
+    /// @brief 多块接口，逐块直接读写调用方的内存，不复制到临时的块
+    void encrypt_blocks(const std::uint8_t* in, std::uint8_t* out, std::size_t count) const noexcept {
+        for (; count > 0; --count, in += 16, out += 16) crypt_bytes<true>(in, out);
+    }
+
+    void decrypt_blocks(const std::uint8_t* in, std::uint8_t* out, std::size_t count) const noexcept {
+        for (; count > 0; --count, in += 16, out += 16) crypt_bytes<false>(in, out);
+    }
+
+    /// @brief 按标准逐阶段加密，每个阶段是状态矩阵上的一次操作，便于对照标准学习
+    /// @details 定义 CANGO_AES_PROFILE_STAGES 时记录每个阶段的周期数，解密的逆阶段计入同名阶段
+    constexpr void encrypt_stages(StateMatrix &origin) const noexcept {
+        CANGO_AES_STAGE(add_round_key, origin.add_round_key_inplace(states[0]));
+        for (std::size_t round = 1; round < NRound; ++round) {
+            CANGO_AES_STAGE(sub_bytes, origin.substitute_with_inplace(SBox));
+            CANGO_AES_STAGE(shift_rows, origin.shift_rows_inplace());
+            CANGO_AES_STAGE(mix_columns, origin.mix_columns_inplace(CMDSMatrix));
+            CANGO_AES_STAGE(add_round_key, origin.add_round_key_inplace(states[round]));
+        }
+        CANGO_AES_STAGE(sub_bytes, origin.substitute_with_inplace(SBox));
+        CANGO_AES_STAGE(shift_rows, origin.shift_rows_inplace());
+        CANGO_AES_STAGE(add_round_key, origin.add_round_key_inplace(states[NRound]));
+    }
+
+    /// @brief 按标准逐阶段解密
+    constexpr void decrypt_stages(StateMatrix &origin) const noexcept {
+        CANGO_AES_STAGE(add_round_key, origin.add_round_key_inplace(states[NRound]));
+        for (auto round = NRound - 1; round > 0; --round) {
+            CANGO_AES_STAGE(shift_rows, origin.inv_shift_rows_inplace());
+            CANGO_AES_STAGE(sub_bytes, origin.substitute_with_inplace(InvSBox));
+            CANGO_AES_STAGE(add_round_key, origin.add_round_key_inplace(states[round]));
+            CANGO_AES_STAGE(mix_columns, origin.mix_columns_inplace(InvCMDSMatrix));
+        }
+        CANGO_AES_STAGE(shift_rows, origin.inv_shift_rows_inplace());
+        CANGO_AES_STAGE(sub_bytes, origin.substitute_with_inplace(InvSBox));
+        CANGO_AES_STAGE(add_round_key, origin.add_round_key_inplace(states[0]));
+    }
+
+private:
+    [[nodiscard]] static constexpr columns_t load_columns(const std::uint8_t* c0, const std::uint8_t* c1, const std::uint8_t* c2,
+                                                          const std::uint8_t* c3) noexcept {
+        return {load_u32le(c0), load_u32le(c1), load_u32le(c2), load_u32le(c3)};
+    }
+
+    /// @brief 按小端序读出一列，字节类型可以是 std::uint8_t 或 std::byte
+    template<typename TByte>
+    [[nodiscard]] static constexpr std::uint32_t load_column(const TByte* bytes) noexcept {
+        return static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[0]))
+            | static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[1])) << 8
+            | static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[2])) << 16
+            | static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[3])) << 24;
+    }
+
+    template<typename TByte>
+    static constexpr void store_column(TByte* bytes, const std::uint32_t value) noexcept {
+        for (std::size_t i = 0; i < 4; ++i) bytes[i] = static_cast<TByte>(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+
+    /// @brief 在连续的 16 字节上加密或解密一个块，先读出全部输入，因此 in 与 out 可以相同
+    template<bool Encrypt, typename TIn, typename TOut>
+    constexpr void crypt_bytes(const TIn* in, TOut* out) const noexcept {
+        columns_t columns{load_column(in), load_column(in + 4), load_column(in + 8), load_column(in + 12)};
+#ifdef CANGO_AES_PROFILE_STAGES
+        StateMatrix mat{};
+        for (std::size_t col = 0; col < 4; ++col) store_u32le(mat.words[col].data(), columns[col]);
+        if constexpr (Encrypt) encrypt_stages(mat);
+        else decrypt_stages(mat);
+        for (std::size_t col = 0; col < 4; ++col) columns[col] = load_u32le(mat.words[col].data());
+#else
+        if constexpr (Encrypt) encrypt_columns(columns);
+        else decrypt_columns(columns);
+#endif
+        for (std::size_t col = 0; col < 4; ++col) store_column(out + 4 * col, columns[col]);
+    }
+
+    /// @brief 轮密钥加，轮密钥的每列在内存中就是小端序的 32 位字
+    template<std::size_t NKey>
+    constexpr void add_round_key(columns_t& columns) const noexcept {
+        const auto& key = states[NKey].words;
+        columns = {columns[0] ^ load_u32le(key[0].data()), columns[1] ^ load_u32le(key[1].data()),
+                   columns[2] ^ load_u32le(key[2].data()), columns[3] ^ load_u32le(key[3].data())};
+    }
+
+    /// @brief 字节替换与行移位合为一步：结果第 col 列第 row 行的字节取自第 (col ± row) % 4 列的第 row 个字节
+    /// @tparam Inverse 是否为逆行移位
+    template<bool Inverse>
+    [[nodiscard]] static constexpr std::uint32_t sub_shift_column(const columns_t& columns, const SubstituteBox& box, const std::size_t col) noexcept {
+        constexpr auto source = [](const std::size_t col, const std::size_t row) { return (Inverse ? col + 4 - row : col + row) % 4; };
+        return static_cast<std::uint32_t>(box[static_cast<std::uint8_t>(columns[source(col, 0)])])
+            | static_cast<std::uint32_t>(box[static_cast<std::uint8_t>(columns[source(col, 1)] >> 8)]) << 8
+            | static_cast<std::uint32_t>(box[static_cast<std::uint8_t>(columns[source(col, 2)] >> 16)]) << 16
+            | static_cast<std::uint32_t>(box[static_cast<std::uint8_t>(columns[source(col, 3)] >> 24)]) << 24;
+    }
+
+    template<bool Inverse>
+    [[nodiscard]] static constexpr columns_t sub_shift(const columns_t& columns, const SubstituteBox& box) noexcept {
+        return {sub_shift_column<Inverse>(columns, box, 0), sub_shift_column<Inverse>(columns, box, 1),
+                sub_shift_column<Inverse>(columns, box, 2), sub_shift_column<Inverse>(columns, box, 3)};
+    }
+
+    /// @brief 第 NKey 轮：字节替换、行移位、列混合、轮密钥加，列混合是打包字上的 xtime
+    template<std::size_t NKey>
+    constexpr void encrypt_round(columns_t& columns) const noexcept {
+        const auto shifted = sub_shift<false>(columns, SBox);
+        columns = {mix_column_u32(shifted[0]), mix_column_u32(shifted[1]), mix_column_u32(shifted[2]), mix_column_u32(shifted[3])};
+        add_round_key<NKey>(columns);
+    }
+
+    /// @brief 与 decrypt_stages 相同的顺序：逆行移位、逆字节替换、轮密钥加、逆列混合
+    template<std::size_t NKey>
+    constexpr void decrypt_round(columns_t& columns) const noexcept {
+        columns = sub_shift<true>(columns, InvSBox);
+        add_round_key<NKey>(columns);
+        columns = {inv_mix_column_u32(columns[0]), inv_mix_column_u32(columns[1]), inv_mix_column_u32(columns[2]), inv_mix_column_u32(columns[3])};
+    }
+
+    /// @brief 所有轮在编译期展开，轮密钥的下标都是常量，没有循环和分支
+    constexpr void encrypt_columns(columns_t& columns) const noexcept {
+        add_round_key<0>(columns);
+        [&]<std::size_t... NIndex>(std::index_sequence<NIndex...>) {
+            (encrypt_round<NIndex + 1>(columns), ...);
+        }(std::make_index_sequence<NRound - 1>{});
+        columns = sub_shift<false>(columns, SBox);
+        add_round_key<NRound>(columns);
+    }
+
+    constexpr void decrypt_columns(columns_t& columns) const noexcept {
+        add_round_key<NRound>(columns);
+        [&]<std::size_t... NIndex>(std::index_sequence<NIndex...>) {
+            (decrypt_round<NRound - 1 - NIndex>(columns), ...);
+        }(std::make_index_sequence<NRound - 1>{});
+        columns = sub_shift<true>(columns, InvSBox);
+        add_round_key<0>(columns);
     }
 };
 
@@ -2,7 +2,9 @@
 #define INCLUDE_CANGO_AES_DETAILS_MATRIX
 
 #include <array>
+#include <bit>
 #include <cstdint>
+#include <type_traits>
 
 #include "sbox.hpp"
 #include "word.hpp"
@@ -10,7 +12,8 @@
 namespace cango::aes::details {
 
 /// @brief 状态矩阵，4行4列的字节矩阵，一个字一列
-struct StateMatrix {
+/// @details 16 字节对齐，内存布局与按列排列的 16 字节数据块相同，两者之间的转换只是按位重新解释
+struct alignas(16) StateMatrix {
     /// @brief 字列表
     std::array<std::array<std::uint8_t, 4>, 4> words;
 
@@ -18,20 +21,14 @@ struct StateMatrix {
     /// @param nums 字节列表，将会按列存入状态矩阵
     /// @return 与字节列表元素一一对应的状态矩阵
     static constexpr StateMatrix from_array(const std::array<std::uint8_t, 16> &nums) noexcept {
-        StateMatrix result{};
-        for (std::uint8_t i = 0; i < 4; ++i)
-            for (std::uint8_t j = 0; j < 4; ++j) result.words[i][j] = nums[i * 4 + j];
-        return result;
+        return std::bit_cast<StateMatrix>(nums);
     }
 
     /// @brief 将状态矩阵转换为字节列表
     /// @param matrix 状态矩阵，将会按列存入字节列表
     /// @return 与状态矩阵元素一一对应的字节列表
     static constexpr std::array<std::uint8_t, 16> to_array(const StateMatrix &matrix) noexcept {
-        std::array<std::uint8_t, 16> result{};
-        for (std::uint8_t i = 0; i < 4; ++i)
-            for (std::uint8_t j = 0; j < 4; ++j) result[i * 4 + j] = matrix.words[i][j];
-        return result;
+        return std::bit_cast<std::array<std::uint8_t, 16>>(matrix);
     }
 
     /// @brief 行移位操作
@@ -162,6 +159,8 @@ struct StateMatrix {
     }
 };
 
+static_assert(sizeof(StateMatrix) == 16 && std::is_trivially_copyable_v<StateMatrix>, "StateMatrix 必须与 16 字节数据块布局相同");
+
 }
 
 #endif//INCLUDE_CANGO_AES_DETAILS_MATRIX
@@ -0,0 +1,34 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_PADDING
+#define INCLUDE_CANGO_AES_DETAILS_PADDING
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace cango::aes::details {
+
+/// @brief 按 PKCS#7 填充最后一块
+/// @param block 前 used 个字节为数据，used 小于 16
+constexpr void pkcs7_pad(std::array<std::uint8_t, 16>& block, const std::size_t used) noexcept {
+    const auto pad = static_cast<std::uint8_t>(16 - used);
+    for (auto i = used; i < 16; ++i) block[i] = pad;
+}
+
+/// @brief 以常数时间检查最后一块的 PKCS#7 填充
+/// @param last 最后一块解密后的 16 字节
+/// @return 填充的字节数，范围为 1 到 16 ；填充无效时返回 0
+[[nodiscard]] constexpr std::size_t pkcs7_padding_length(const std::uint8_t* last) noexcept {
+    const unsigned pad = last[15];
+    // pad 为 0 或大于 16 时差值回绕为很大的数
+    unsigned diff = ((pad - 1) | (16 - pad)) >> 8;
+    for (unsigned i = 0; i < 16; ++i) {
+        const unsigned in_padding = 0u - ((15 - i - pad) >> 31);
+        diff |= in_padding & (last[i] ^ pad);
+    }
+    const unsigned valid = ((diff | (0u - diff)) >> 31) ^ 1;
+    return pad * valid;
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_PADDING
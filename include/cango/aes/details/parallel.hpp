@@ -0,0 +1,47 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_PARALLEL
+#define INCLUDE_CANGO_AES_DETAILS_PARALLEL
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cango::aes::details {
+
+/// @brief 把连续的工作切分为若干段的方案
+struct ChunkPlan {
+    /// @brief 每段的单位数，最后一段可能更短
+    std::size_t chunk;
+
+    /// @brief 段数，为 1 时不启动额外线程
+    std::size_t count;
+};
+
+/// @brief 按线程数切分工作
+/// @param units 总单位数
+/// @param threads 期望的线程数，为 0 时使用硬件并发数
+/// @param min_per_thread 每个线程至少处理的单位数，工作较少时减少线程数
+[[nodiscard]] inline ChunkPlan plan_chunks(const std::size_t units, std::size_t threads, const std::size_t min_per_thread) noexcept {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::clamp<std::size_t>(units / std::max<std::size_t>(min_per_thread, 1), 1, threads);
+    const auto chunk = std::max<std::size_t>((units + threads - 1) / threads, 1);
+    return {chunk, units == 0 ? 1 : (units + chunk - 1) / chunk};
+}
+
+/// @brief 按方案并行执行，第一段在调用线程上执行，返回时所有段都已完成
+/// @param func 以 (段序号, 起始单位, 单位数) 调用
+template<typename TFunc>
+void run_chunks(const ChunkPlan& plan, const std::size_t units, const TFunc& func) {
+    std::vector<std::jthread> workers;
+    workers.reserve(plan.count - 1);
+    for (std::size_t index = 1; index < plan.count; ++index) {
+        const auto begin = index * plan.chunk;
+        const auto n = std::min(plan.chunk, units - begin);
+        workers.emplace_back([&func, index, begin, n] { func(index, begin, n); });
+    }
+    func(std::size_t{0}, std::size_t{0}, std::min(plan.chunk, units));
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_PARALLEL
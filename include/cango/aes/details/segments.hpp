@@ -0,0 +1,126 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_SEGMENTS
+#define INCLUDE_CANGO_AES_DETAILS_SEGMENTS
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace cango::aes::details {
+
+/// @brief 在一串分段(类似 iovec)上前进的游标
+/// @tparam TByte std::byte 或 const std::byte
+template<typename TByte>
+struct SegmentCursor {
+    std::span<const std::span<TByte>> segments;
+    std::size_t index = 0;
+    std::size_t offset = 0;
+
+    explicit SegmentCursor(const std::span<const std::span<TByte>> segments) noexcept : segments(segments) {}
+
+    /// @brief 当前分段中剩余的数据，跳过已用完的分段和空分段；全部用完时为空
+    [[nodiscard]] std::span<TByte> current() noexcept {
+        while (index < segments.size() && offset == segments[index].size()) {
+            ++index;
+            offset = 0;
+        }
+        return index < segments.size() ? segments[index].subspan(offset) : std::span<TByte>{};
+    }
+
+    void advance(const std::size_t n) noexcept {
+        offset += n;
+    }
+
+    /// @brief 游标之后是否还有至少 n 个字节
+    [[nodiscard]] bool has(std::size_t n) const noexcept {
+        auto probe = *this;
+        while (n != 0) {
+            const auto part = probe.current();
+            if (part.empty()) return false;
+            const auto step = std::min(part.size(), n);
+            probe.advance(step);
+            n -= step;
+        }
+        return true;
+    }
+
+    /// @brief 从游标处复制 buffer.size() 个字节，跨越分段边界，调用前应以 has 确认剩余字节足够
+    void gather(const std::span<std::byte> buffer) noexcept {
+        for (std::size_t done = 0; done < buffer.size();) {
+            const auto part = current();
+            const auto n = std::min(part.size(), buffer.size() - done);
+            std::memcpy(buffer.data() + done, part.data(), n);
+            advance(n);
+            done += n;
+        }
+    }
+
+    /// @brief 把 buffer 写到游标处，跨越分段边界，调用前应以 has 确认剩余空间足够
+    void scatter(const std::span<const std::byte> buffer) noexcept requires (!std::is_const_v<TByte>) {
+        for (std::size_t done = 0; done < buffer.size();) {
+            const auto part = current();
+            const auto n = std::min(part.size(), buffer.size() - done);
+            std::memcpy(part.data(), buffer.data() + done, n);
+            advance(n);
+            done += n;
+        }
+    }
+};
+
+/// @brief 同时在输入和输出两串分段上前进，每次以两边当前分段的公共部分调用 func(in, out)
+/// @details 不复制数据，适合能处理任意长度、可以分多次调用的流式模式(CTR, GCM)。
+/// 原地处理时输入与输出是同一串分段，每次调用的两个参数是同一段内存。
+/// @return 处理的字节数，即两串分段总长度的较小值
+template<typename TIn, typename TOut, typename TFunc>
+std::size_t for_each_run(const std::span<const std::span<TIn>> in, const std::span<const std::span<TOut>> out, const TFunc& func) {
+    SegmentCursor<TIn> reader{in};
+    SegmentCursor<TOut> writer{out};
+    std::size_t total = 0;
+    while (true) {
+        const auto source = reader.current();
+        const auto target = writer.current();
+        if (source.empty() || target.empty()) return total;
+        const auto n = std::min(source.size(), target.size());
+        func(std::span<const std::byte>{source.first(n)}, target.first(n));
+        reader.advance(n);
+        writer.advance(n);
+        total += n;
+    }
+}
+
+/// @brief 与 for_each_run 相同，但每次调用的长度都是 16 的倍数，适合只处理完整块的模式
+/// @details 两边当前分段的公共部分中的完整块直接在分段上处理；跨越分段边界的块先收集到栈上的 16 字节缓冲区，
+/// 原地处理后再分散写回输出，只有这样的块才会被复制。
+/// @return 处理的字节数，为 16 的倍数；末尾不足一块的数据保持不变
+template<typename TIn, typename TOut, typename TFunc>
+std::size_t for_each_block_run(const std::span<const std::span<TIn>> in, const std::span<const std::span<TOut>> out, const TFunc& func) {
+    SegmentCursor<TIn> reader{in};
+    SegmentCursor<TOut> writer{out};
+    std::size_t total = 0;
+    while (true) {
+        const auto source = reader.current();
+        const auto target = writer.current();
+        if (source.empty() || target.empty()) return total;
+        if (const auto n = std::min(source.size(), target.size()) / 16 * 16; n != 0) {
+            func(std::span<const std::byte>{source.first(n)}, target.first(n));
+            reader.advance(n);
+            writer.advance(n);
+            total += n;
+            continue;
+        }
+
+        // 输入或输出的当前分段中不足一块，这一块跨越了分段边界
+        if (!reader.has(16) || !writer.has(16)) return total;
+        std::array<std::byte, 16> block;
+        reader.gather(block);
+        func(std::span<const std::byte>{block}, std::span{block});
+        writer.scatter(block);
+        total += 16;
+    }
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_SEGMENTS
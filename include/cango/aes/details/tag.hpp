@@ -0,0 +1,27 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_TAG
+#define INCLUDE_CANGO_AES_DETAILS_TAG
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cango::aes::details {
+
+/// @brief 以常数时间比较收到的标签与完整标签的前缀，GCM, CMAC 和 HMAC 共用
+/// @param expected 计算得到的完整标签
+/// @param tag 收到的标签，可以是截断的标签
+/// @param min_size 允许的最短标签字节数，更短的标签容易被猜中，直接拒绝
+/// @return tag 的长度在 min_size 到 expected.size() 之间且与 expected 的前缀相同
+[[nodiscard]] constexpr bool tag_equal(
+    const std::span<const std::uint8_t> expected,
+    const std::span<const std::byte> tag,
+    const std::size_t min_size) noexcept {
+    if (tag.size() < min_size || tag.size() > expected.size()) return false;
+    std::uint8_t diff = 0;
+    for (std::size_t i = 0; i < tag.size(); ++i) diff |= expected[i] ^ static_cast<std::uint8_t>(tag[i]);
+    return diff == 0;
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_TAG
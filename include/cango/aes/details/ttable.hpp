@@ -0,0 +1,198 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_TTABLE
+#define INCLUDE_CANGO_AES_DETAILS_TTABLE
+
+#include <array>
+#include <cstdint>
+
+#include "sbox.hpp"
+#include "utils.hpp"
+#include "word.hpp"
+
+namespace cango::aes::details {
+
+/// @brief T 表类型，把字节替换和列混合合并为一次 32 位查表
+using TTable = std::array<std::uint32_t, 256>;
+
+/// @brief 生成 T 表
+/// @param sbox 替换盒
+/// @param mds MDS 矩阵
+/// @param row 输入字节所在的行，决定取 MDS 矩阵的哪一列
+/// @return 第 x 项为 sbox[x] 经过列混合后对一整列的贡献，第 i 行位于第 i 个字节(小端序)
+[[nodiscard]] constexpr TTable make_ttable(const SubstituteBox& sbox, const mds_t& mds, const std::size_t row) noexcept {
+    TTable result{};
+    for (std::size_t x = 0; x < 256; ++x) {
+        const auto substituted = sbox[static_cast<std::uint8_t>(x)];
+        std::uint32_t column = 0;
+        for (std::size_t i = 0; i < 4; ++i)
+            column |= static_cast<std::uint32_t>(gf_mul(mds[i * 4 + row], substituted)) << (8 * i);
+        result[x] = column;
+    }
+    return result;
+}
+
+/// @brief 加密 T 表，第 0 行
+inline constexpr TTable Te0 = make_ttable(SBox, CMDSMatrix, 0);
+
+/// @brief 加密 T 表，第 1 行
+inline constexpr TTable Te1 = make_ttable(SBox, CMDSMatrix, 1);
+
+/// @brief 加密 T 表，第 2 行
+inline constexpr TTable Te2 = make_ttable(SBox, CMDSMatrix, 2);
+
+/// @brief 加密 T 表，第 3 行
+inline constexpr TTable Te3 = make_ttable(SBox, CMDSMatrix, 3);
+
+/// @brief 解密 T 表，第 0 行
+inline constexpr TTable Td0 = make_ttable(InvSBox, InvCMDSMatrix, 0);
+
+/// @brief 解密 T 表，第 1 行
+inline constexpr TTable Td1 = make_ttable(InvSBox, InvCMDSMatrix, 1);
+
+/// @brief 解密 T 表，第 2 行
+inline constexpr TTable Td2 = make_ttable(InvSBox, InvCMDSMatrix, 2);
+
+/// @brief 解密 T 表，第 3 行
+inline constexpr TTable Td3 = make_ttable(InvSBox, InvCMDSMatrix, 3);
+
+/// @brief 取出字中的第 index 个字节(小端序)
+[[nodiscard]] constexpr std::uint8_t byte_of(const std::uint32_t word, const std::size_t index) noexcept {
+    return static_cast<std::uint8_t>(word >> (8 * index));
+}
+
+/// @brief 对一列做逆列混合
+/// @note 利用 Td[SBox[x]] 抵消 T 表里的逆字节替换，只在扩展密钥时使用
+[[nodiscard]] constexpr std::uint32_t inv_mix_column(const std::uint32_t column) noexcept {
+    return Td0[SBox[byte_of(column, 0)]]
+        ^ Td1[SBox[byte_of(column, 1)]]
+        ^ Td2[SBox[byte_of(column, 2)]]
+        ^ Td3[SBox[byte_of(column, 3)]];
+}
+
+/// @brief 对字做字节替换
+[[nodiscard]] constexpr std::uint32_t sub_word(const std::uint32_t word) noexcept {
+    return static_cast<std::uint32_t>(SBox[byte_of(word, 0)])
+        | static_cast<std::uint32_t>(SBox[byte_of(word, 1)]) << 8
+        | static_cast<std::uint32_t>(SBox[byte_of(word, 2)]) << 16
+        | static_cast<std::uint32_t>(SBox[byte_of(word, 3)]) << 24;
+}
+
+/// @brief T 表轮密钥，每轮用 4 次查表和异或完成字节替换、行移位和列混合
+/// @details 一列存为一个 32 位字，第 i 行位于第 i 个字节(小端序)。
+/// 解密使用等价逆密码，中间各轮的解密轮密钥在扩展时已做过逆列混合。
+template<std::size_t NRound>
+struct TableRoundKeys {
+    /// @brief 标准定义的轮数
+    static constexpr auto round_count = NRound;
+
+    /// @brief 轮密钥数
+    static constexpr auto key_count = round_count + 1;
+
+    /// @brief 轮密钥列表的字数
+    static constexpr auto word_count = 4 * key_count;
+
+    /// @brief 加密轮密钥，按使用顺序排列，按缓存行对齐，AES-256 的 240 字节正好占 4 个缓存行，且可以直接载入向量寄存器
+    alignas(64) std::array<std::uint32_t, word_count> enc;
+
+    /// @brief 解密轮密钥，按使用顺序排列，与 enc 一样按缓存行对齐
+    alignas(64) std::array<std::uint32_t, word_count> dec;
+
+    /// @brief 从字节列表主钥展开轮钥
+    /// @param mainKey 主钥
+    /// @return 轮钥
+    static constexpr TableRoundKeys from_array(const auto& mainKey) {
+        TableRoundKeys result;
+        result.expand_from(mainKey);
+        return result;
+    }
+
+    /// @brief 从主密钥扩展得到轮密钥
+    /// @tparam NBytes 主密钥字节数
+    /// @param mainKey 主密钥数据
+    template<std::size_t NBytes>
+    constexpr void expand_from(const std::array<std::uint8_t, NBytes>& mainKey) {
+        constexpr auto NWord = NBytes / 4;
+        for (std::size_t i = 0; i < NWord; ++i)
+            enc[i] = load_u32le(mainKey.data() + i * 4);
+
+        RoundConstant round_constant{};
+        for (auto i = NWord; i < word_count; ++i) {
+            auto temp = enc[i - 1];
+            if (i % NWord == 0)
+                temp = sub_word(temp >> 8 | temp << 24) ^ round_constant.step();
+            else if (NWord > 6 && i % NWord == 4)
+                temp = sub_word(temp);
+            enc[i] = enc[i - NWord] ^ temp;
+        }
+
+        for (std::size_t round = 0; round < key_count; ++round) {
+            for (std::size_t col = 0; col < 4; ++col) {
+                const auto word = enc[(NRound - round) * 4 + col];
+                dec[round * 4 + col] = round == 0 || round == NRound ? word : inv_mix_column(word);
+            }
+        }
+    }
+
+    /// @brief 加密数据，直接在原数据上操作
+    /// @param origin 需要加密的 16 字节数据
+    constexpr void encrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+        auto s0 = load_u32le(origin.data()) ^ enc[0];
+        auto s1 = load_u32le(origin.data() + 4) ^ enc[1];
+        auto s2 = load_u32le(origin.data() + 8) ^ enc[2];
+        auto s3 = load_u32le(origin.data() + 12) ^ enc[3];
+
+        for (std::size_t round = 1; round < NRound; ++round) {
+            const auto k = round * 4;
+            const auto t0 = Te0[byte_of(s0, 0)] ^ Te1[byte_of(s1, 1)] ^ Te2[byte_of(s2, 2)] ^ Te3[byte_of(s3, 3)] ^ enc[k];
+            const auto t1 = Te0[byte_of(s1, 0)] ^ Te1[byte_of(s2, 1)] ^ Te2[byte_of(s3, 2)] ^ Te3[byte_of(s0, 3)] ^ enc[k + 1];
+            const auto t2 = Te0[byte_of(s2, 0)] ^ Te1[byte_of(s3, 1)] ^ Te2[byte_of(s0, 2)] ^ Te3[byte_of(s1, 3)] ^ enc[k + 2];
+            const auto t3 = Te0[byte_of(s3, 0)] ^ Te1[byte_of(s0, 1)] ^ Te2[byte_of(s1, 2)] ^ Te3[byte_of(s2, 3)] ^ enc[k + 3];
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        const std::array<std::uint32_t, 4> state{s0, s1, s2, s3};
+        for (std::size_t col = 0; col < 4; ++col) {
+            const auto word = static_cast<std::uint32_t>(SBox[byte_of(state[col], 0)])
+                | static_cast<std::uint32_t>(SBox[byte_of(state[(col + 1) % 4], 1)]) << 8
+                | static_cast<std::uint32_t>(SBox[byte_of(state[(col + 2) % 4], 2)]) << 16
+                | static_cast<std::uint32_t>(SBox[byte_of(state[(col + 3) % 4], 3)]) << 24;
+            store_u32le(origin.data() + col * 4, word ^ enc[NRound * 4 + col]);
+        }
+    }
+
+    /// @brief 解密数据，直接在原数据上操作
+    /// @param origin 需要解密的 16 字节数据
+    constexpr void decrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+        auto s0 = load_u32le(origin.data()) ^ dec[0];
+        auto s1 = load_u32le(origin.data() + 4) ^ dec[1];
+        auto s2 = load_u32le(origin.data() + 8) ^ dec[2];
+        auto s3 = load_u32le(origin.data() + 12) ^ dec[3];
+
+        for (std::size_t round = 1; round < NRound; ++round) {
+            const auto k = round * 4;
+            const auto t0 = Td0[byte_of(s0, 0)] ^ Td1[byte_of(s3, 1)] ^ Td2[byte_of(s2, 2)] ^ Td3[byte_of(s1, 3)] ^ dec[k];
+            const auto t1 = Td0[byte_of(s1, 0)] ^ Td1[byte_of(s0, 1)] ^ Td2[byte_of(s3, 2)] ^ Td3[byte_of(s2, 3)] ^ dec[k + 1];
+            const auto t2 = Td0[byte_of(s2, 0)] ^ Td1[byte_of(s1, 1)] ^ Td2[byte_of(s0, 2)] ^ Td3[byte_of(s3, 3)] ^ dec[k + 2];
+            const auto t3 = Td0[byte_of(s3, 0)] ^ Td1[byte_of(s2, 1)] ^ Td2[byte_of(s1, 2)] ^ Td3[byte_of(s0, 3)] ^ dec[k + 3];
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        const std::array<std::uint32_t, 4> state{s0, s1, s2, s3};
+        for (std::size_t col = 0; col < 4; ++col) {
+            const auto word = static_cast<std::uint32_t>(InvSBox[byte_of(state[col], 0)])
+                | static_cast<std::uint32_t>(InvSBox[byte_of(state[(col + 3) % 4], 1)]) << 8
+                | static_cast<std::uint32_t>(InvSBox[byte_of(state[(col + 2) % 4], 2)]) << 16
+                | static_cast<std::uint32_t>(InvSBox[byte_of(state[(col + 1) % 4], 3)]) << 24;
+            store_u32le(origin.data() + col * 4, word ^ dec[NRound * 4 + col]);
+        }
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_TTABLE
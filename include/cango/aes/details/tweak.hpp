@@ -0,0 +1,73 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_TWEAK
+#define INCLUDE_CANGO_AES_DETAILS_TWEAK
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu.hpp"
+#include "word.hpp"
+
+namespace cango::aes::details {
+
+/// @brief XTS 调整值在 GF(2^128) 上乘以 α
+/// @details 16 个字节视为小端 128 位整数，整体左移 1 位，移出的最高位按 x^128 + x^7 + x^2 + x + 1 约简回最低字节。
+/// 用两个 64 位字完成，没有分支，代替逐字节的 xtime 循环。
+constexpr void multiply_alpha(std::array<std::uint8_t, 16>& tweak) noexcept {
+    const auto lo = load_u64le(tweak.data());
+    const auto hi = load_u64le(tweak.data() + 8);
+    store_u64le(tweak.data(), lo << 1 ^ ((0 - (hi >> 63)) & 0x87));
+    store_u64le(tweak.data() + 8, hi << 1 | lo >> 63);
+}
+
+/// @brief CMAC 子密钥的倍乘，即大端序下的 xtime
+/// @details 16 个字节视为大端 128 位整数，左移 1 位，移出的最高位按同一个多项式约简回最低字节(RFC 4493 第 2.3 节)。
+[[nodiscard]] constexpr std::array<std::uint8_t, 16> xtime_block(const std::array<std::uint8_t, 16>& block) noexcept {
+    const auto hi = load_u64be(block.data());
+    const auto lo = load_u64be(block.data() + 8);
+    std::array<std::uint8_t, 16> result{};
+    store_u64be(result.data(), hi << 1 | lo >> 63);
+    store_u64be(result.data() + 8, lo << 1 ^ ((0 - (hi >> 63)) & 0x87));
+    return result;
+}
+
+#if CANGO_AES_X86
+/// @brief SSE2 实现，两个 64 位通道各自左移，通道间的进位和约简由一次移位与洗牌得到
+CANGO_AES_TARGET("sse2")
+inline void fill_tweaks_sse2(std::uint8_t* tweak, std::uint8_t* out, const std::size_t count) noexcept {
+    const auto poly = _mm_set_epi32(0, 1, 0, 0x87);
+    auto t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tweak));
+    for (std::size_t i = 0; i < count; ++i, out += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), t);
+        // 第 1, 3 个 32 位字的符号位即两个通道的最高位，分别移到高通道的最低位和低通道的约简多项式
+        const auto carry = _mm_and_si128(_mm_shuffle_epi32(_mm_srai_epi32(t, 31), 0x13), poly);
+        t = _mm_xor_si128(_mm_add_epi64(t, t), carry);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(tweak), t);
+}
+#endif
+
+/// @brief 从 tweak 开始连续写出 count 个调整值，并把 tweak 更新为下一个
+inline void fill_tweaks(std::array<std::uint8_t, 16>& tweak, std::uint8_t* out, const std::size_t count) noexcept {
+#if CANGO_AES_X86
+    if (cpu_features().sse2) {
+        fill_tweaks_sse2(tweak.data(), out, count);
+        return;
+    }
+#endif
+    auto lo = load_u64le(tweak.data());
+    auto hi = load_u64le(tweak.data() + 8);
+    for (std::size_t i = 0; i < count; ++i, out += 16) {
+        store_u64le(out, lo);
+        store_u64le(out + 8, hi);
+        const auto carry = hi >> 63;
+        hi = hi << 1 | lo >> 63;
+        lo = lo << 1 ^ ((0 - carry) & 0x87);
+    }
+    store_u64le(tweak.data(), lo);
+    store_u64le(tweak.data() + 8, hi);
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_TWEAK
@@ -0,0 +1,565 @@
+#ifndef INCLUDE_CANGO_AES_DETAILS_VPERM
+#define INCLUDE_CANGO_AES_DETAILS_VPERM
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "bitslice.hpp"
+#include "cpu.hpp"
+#include "sbox.hpp"
+#include "utils.hpp"
+#include "word.hpp"
+
+namespace cango::aes::details {
+
+namespace vperm {
+
+/// @brief 16 字节向量，也用作 16 项的半字节查找表
+using Nibbles = std::array<std::uint8_t, 16>;
+
+/// @brief 塔域恒等式中的常数 c ，按子域编码
+/// @details 与 tower_e 一起满足：逆元的两部分可由 io, jo 各自查表后异或得到，make_tables 会检查这一点
+inline constexpr std::uint8_t tower_c = 2;
+
+/// @brief 塔域的第二个基元 e ，字节 x 表示为 x = i + k * e ，i, k 属于子域 GF(2^4)
+inline constexpr std::uint8_t tower_e = 242;
+
+/// @brief 在 GF(2^8) 上求逆，0 的逆定义为 0 ，只在生成表时使用
+[[nodiscard]] constexpr std::uint8_t gf_inv(const std::uint8_t x) noexcept {
+    std::uint8_t result = 1;
+    std::uint8_t base = x;
+    for (unsigned exponent = 254; exponent != 0; exponent >>= 1) {
+        if (exponent & 1) result = gf_mul(result, base);
+        base = gf_mul(base, base);
+    }
+    return result;
+}
+
+/// @brief 字节上的 GF(2) 线性映射，保存 8 个基向量的像
+struct LinearMap {
+    std::array<std::uint8_t, 8> columns;
+
+    /// @brief 由线性函数生成映射
+    static constexpr LinearMap from(const auto& func) noexcept {
+        LinearMap result{};
+        for (std::size_t bit = 0; bit < 8; ++bit) result.columns[bit] = func(static_cast<std::uint8_t>(1u << bit));
+        return result;
+    }
+
+    /// @brief 计算映射结果，不查表也不分支，可用于密钥
+    constexpr std::uint8_t operator()(const std::uint8_t x) const noexcept {
+        std::uint8_t result = 0;
+        for (std::size_t bit = 0; bit < 8; ++bit)
+            result ^= columns[bit] & static_cast<std::uint8_t>(0u - ((x >> bit) & 1u));
+        return result;
+    }
+};
+
+/// @brief 向量置换实现用到的所有查找表
+struct Tables {
+    /// @brief 子域中的 1/x ，1/0 记为 0x80 ，查表时最高位为 1 的下标得到 0
+    Nibbles inv;
+
+    /// @brief 子域中的 c/x
+    Nibbles inv_c;
+
+    /// @brief 字节到塔域坐标的线性映射 T
+    LinearMap to_tower;
+
+    /// @brief 逆仿射变换后再到塔域坐标的线性映射 U
+    LinearMap to_tower_inv;
+
+    /// @brief 加密输入变换 T 的低、高半字节表
+    std::array<Nibbles, 2> enc_in;
+
+    /// @brief 解密输入变换 U 的低、高半字节表
+    std::array<Nibbles, 2> dec_in;
+
+    /// @brief 加密中间轮输出 T(S(x)) 的 io, jo 表，不含常数 0x63
+    std::array<Nibbles, 2> enc_s;
+
+    /// @brief 加密中间轮输出 T(2 * S(x)) 的 io, jo 表
+    std::array<Nibbles, 2> enc_s2;
+
+    /// @brief 加密最后一轮输出 S(x) 的 io, jo 表
+    std::array<Nibbles, 2> enc_last;
+
+    /// @brief 解密中间轮输出 U(14 * InvS(x)) 等的 io, jo 表
+    std::array<Nibbles, 2> dec_14, dec_11, dec_13, dec_9;
+
+    /// @brief 解密最后一轮输出 InvS(x) 的 io, jo 表
+    std::array<Nibbles, 2> dec_last;
+
+    /// @brief 恒等式是否对全部 256 个字节成立
+    bool valid;
+};
+
+/// @brief 模拟 pshufb ：下标最高位为 1 时结果为 0 ，否则取低 4 位查表
+[[nodiscard]] constexpr std::uint8_t shuffle(const Nibbles& table, const std::uint8_t index) noexcept {
+    return index & 0x80 ? 0 : table[index & 0x0f];
+}
+
+/// @brief 在塔域中求逆，只用 4 位查表和异或
+/// @param x 塔域坐标，高 4 位为 i ，低 4 位为 k
+/// @param io 输出，1/(1/i + c/k) + j
+/// @param jo 输出，1/(1/j + c/k) + i ，其中 j = i + k
+constexpr void tower_inverse(const Tables& t, const std::uint8_t x, std::uint8_t& io, std::uint8_t& jo) noexcept {
+    const std::uint8_t k = x & 0x0f;
+    const std::uint8_t i = x >> 4;
+    const std::uint8_t j = i ^ k;
+    const std::uint8_t ak = t.inv_c[k];
+    io = shuffle(t.inv, t.inv[i] ^ ak) ^ j;
+    jo = shuffle(t.inv, t.inv[j] ^ ak) ^ i;
+}
+
+/// @brief 生成查找表
+[[nodiscard]] constexpr Tables make_tables() noexcept {
+    Tables t{};
+
+    // 子域 GF(2^4) = {x | x^16 = x} 的一组基，按数值从小到大贪心选取
+    std::array<std::uint8_t, 4> basis{};
+    std::array<bool, 256> in_span{};
+    in_span[0] = true;
+    std::size_t basis_size = 0;
+    for (unsigned x = 1; x < 256 && basis_size < 4; ++x) {
+        auto power = static_cast<std::uint8_t>(x);
+        for (int n = 0; n < 4; ++n) power = gf_mul(power, power);
+        if (power != x || in_span[x]) continue;
+        basis[basis_size++] = static_cast<std::uint8_t>(x);
+        auto next = in_span;
+        for (unsigned y = 0; y < 256; ++y)
+            if (in_span[y]) next[y ^ x] = true;
+        in_span = next;
+    }
+    const auto from_nibble = [&](const unsigned nibble) {
+        std::uint8_t result = 0;
+        for (std::size_t bit = 0; bit < 4; ++bit)
+            if ((nibble >> bit) & 1) result ^= basis[bit];
+        return result;
+    };
+    std::array<std::uint8_t, 256> to_nibble{};
+    for (unsigned n = 0; n < 16; ++n) to_nibble[from_nibble(n)] = static_cast<std::uint8_t>(n);
+
+    std::array<std::uint8_t, 256> coord{};
+    for (unsigned i = 0; i < 16; ++i)
+        for (unsigned k = 0; k < 16; ++k)
+            coord[from_nibble(i) ^ gf_mul(from_nibble(k), tower_e)] = static_cast<std::uint8_t>(i << 4 | k);
+
+    const auto c = from_nibble(tower_c);
+    t.inv[0] = 0x80;
+    t.inv_c[0] = 0x80;
+    for (unsigned n = 1; n < 16; ++n) {
+        const auto inverse = gf_inv(from_nibble(n));
+        t.inv[n] = to_nibble[inverse];
+        t.inv_c[n] = to_nibble[gf_mul(c, inverse)];
+    }
+
+    // S(x) = A(x^-1) + 0x63 ，A 为仿射变换的线性部分
+    const auto affine = [](const std::uint8_t y) {
+        return static_cast<std::uint8_t>(SBox[gf_inv(y)] ^ 0x63);
+    };
+    const auto inv_affine = [](const std::uint8_t y) {
+        return gf_inv(InvSBox[static_cast<std::uint8_t>(y ^ 0x63)]);
+    };
+    t.to_tower = LinearMap::from([&](const std::uint8_t x) { return coord[x]; });
+    t.to_tower_inv = LinearMap::from([&](const std::uint8_t x) { return coord[inv_affine(x)]; });
+    for (unsigned n = 0; n < 16; ++n) {
+        t.enc_in[0][n] = t.to_tower(static_cast<std::uint8_t>(n));
+        t.enc_in[1][n] = t.to_tower(static_cast<std::uint8_t>(n << 4));
+        t.dec_in[0][n] = t.to_tower_inv(static_cast<std::uint8_t>(n));
+        t.dec_in[1][n] = t.to_tower_inv(static_cast<std::uint8_t>(n << 4));
+    }
+
+    // 求 F, G 使 F[io] ^ G[jo] = x^-1 ，下标最高位为 1 的一侧固定为 0
+    std::array<std::uint8_t, 256> io{}, jo{};
+    for (unsigned x = 0; x < 256; ++x) tower_inverse(t, coord[x], io[x], jo[x]);
+    Nibbles f{}, g{};
+    std::array<bool, 16> f_known{}, g_known{};
+    for (bool progress = true; progress;) {
+        progress = false;
+        for (unsigned x = 0; x < 256; ++x) {
+            const bool f_zero = io[x] & 0x80, g_zero = jo[x] & 0x80;
+            const auto fi = io[x] & 0x0f, gi = jo[x] & 0x0f;
+            const bool fk = f_zero || f_known[fi], gk = g_zero || g_known[gi];
+            const auto target = gf_inv(static_cast<std::uint8_t>(x));
+            if (fk && !gk) {
+                g[gi] = target ^ (f_zero ? 0 : f[fi]);
+                g_known[gi] = progress = true;
+            }
+            else if (!fk && gk) {
+                f[fi] = target ^ (g_zero ? 0 : g[gi]);
+                f_known[fi] = progress = true;
+            }
+        }
+        for (unsigned x = 0; x < 256 && !progress; ++x) {
+            if (!(io[x] & 0x80) && !f_known[io[x] & 0x0f]) {
+                f[io[x] & 0x0f] = 0;
+                f_known[io[x] & 0x0f] = progress = true;
+            }
+        }
+    }
+    t.valid = true;
+    for (unsigned x = 0; x < 256; ++x)
+        t.valid = t.valid && (shuffle(f, io[x]) ^ shuffle(g, jo[x])) == gf_inv(static_cast<std::uint8_t>(x));
+
+    const auto output_tables = [&](const auto& map) {
+        std::array<Nibbles, 2> result{};
+        for (unsigned n = 0; n < 16; ++n) {
+            result[0][n] = map(f[n]);
+            result[1][n] = map(g[n]);
+        }
+        return result;
+    };
+    t.enc_s = output_tables([&](const std::uint8_t y) { return t.to_tower(affine(y)); });
+    t.enc_s2 = output_tables([&](const std::uint8_t y) { return t.to_tower(xtime(affine(y))); });
+    t.enc_last = output_tables(affine);
+    t.dec_14 = output_tables([&](const std::uint8_t y) { return t.to_tower_inv(gf_mul(14, y)); });
+    t.dec_11 = output_tables([&](const std::uint8_t y) { return t.to_tower_inv(gf_mul(11, y)); });
+    t.dec_13 = output_tables([&](const std::uint8_t y) { return t.to_tower_inv(gf_mul(13, y)); });
+    t.dec_9 = output_tables([&](const std::uint8_t y) { return t.to_tower_inv(gf_mul(9, y)); });
+    t.dec_last = output_tables([](const std::uint8_t y) { return y; });
+    return t;
+}
+
+/// @brief 查找表，编译期生成
+inline constexpr Tables tables = make_tables();
+
+static_assert(tables.valid, "塔域参数不满足 io, jo 可分离的条件");
+
+/// @brief 由置换规则生成字节置换下标
+template<typename TFunc>
+[[nodiscard]] constexpr Nibbles make_permutation(const TFunc& source) noexcept {
+    Nibbles result{};
+    for (std::size_t col = 0; col < 4; ++col)
+        for (std::size_t row = 0; row < 4; ++row)
+            result[col * 4 + row] = static_cast<std::uint8_t>(source(col, row));
+    return result;
+}
+
+/// @brief 行移位的字节置换
+inline constexpr Nibbles shift_rows = make_permutation([](const std::size_t col, const std::size_t row) {
+    return (col + row) % 4 * 4 + row;
+});
+
+/// @brief 逆行移位的字节置换
+inline constexpr Nibbles inv_shift_rows = make_permutation([](const std::size_t col, const std::size_t row) {
+    return (col + 4 - row) % 4 * 4 + row;
+});
+
+/// @brief 每列内取下 n 行的字节置换
+template<std::size_t N>
+inline constexpr Nibbles rotate_rows = make_permutation([](const std::size_t col, const std::size_t row) {
+    return col * 4 + (row + N) % 4;
+});
+
+/// @brief 可在编译期求值的逐字节模拟实现，查表下标依赖数据，不是常数时间
+struct Scalar {
+    static constexpr Nibbles permute(const Nibbles& v, const Nibbles& pattern) noexcept {
+        Nibbles result{};
+        for (std::size_t n = 0; n < 16; ++n) result[n] = v[pattern[n]];
+        return result;
+    }
+
+    static constexpr Nibbles xor_with(Nibbles v, const std::uint8_t* key) noexcept {
+        for (std::size_t n = 0; n < 16; ++n) v[n] ^= key[n];
+        return v;
+    }
+
+    static constexpr Nibbles transform(const Nibbles& v, const std::array<Nibbles, 2>& table) noexcept {
+        Nibbles result{};
+        for (std::size_t n = 0; n < 16; ++n) result[n] = table[0][v[n] & 0x0f] ^ table[1][v[n] >> 4];
+        return result;
+    }
+
+    static constexpr void inverse(const Nibbles& v, Nibbles& io, Nibbles& jo) noexcept {
+        for (std::size_t n = 0; n < 16; ++n) tower_inverse(tables, v[n], io[n], jo[n]);
+    }
+
+    static constexpr Nibbles output(const Nibbles& io, const Nibbles& jo, const std::array<Nibbles, 2>& table) noexcept {
+        Nibbles result{};
+        for (std::size_t n = 0; n < 16; ++n) result[n] = shuffle(table[0], io[n]) ^ shuffle(table[1], jo[n]);
+        return result;
+    }
+
+    template<std::size_t NRound>
+    static constexpr void encrypt(const std::uint8_t* keys, std::array<std::uint8_t, 16>& block) noexcept {
+        auto s = xor_with(transform(block, tables.enc_in), keys);
+        Nibbles io{}, jo{};
+        for (std::size_t round = 1; round < NRound; ++round) {
+            inverse(permute(s, shift_rows), io, jo);
+            const auto a = output(io, jo, tables.enc_s);
+            const auto d = output(io, jo, tables.enc_s2);
+            Nibbles ad{};
+            for (std::size_t n = 0; n < 16; ++n) ad[n] = a[n] ^ d[n];
+            const auto r1 = permute(ad, rotate_rows<1>);
+            const auto r2 = permute(a, rotate_rows<2>);
+            const auto r3 = permute(a, rotate_rows<3>);
+            for (std::size_t n = 0; n < 16; ++n) s[n] = d[n] ^ r1[n] ^ r2[n] ^ r3[n];
+            s = xor_with(s, keys + round * 16);
+        }
+        inverse(permute(s, shift_rows), io, jo);
+        block = xor_with(output(io, jo, tables.enc_last), keys + NRound * 16);
+    }
+
+    template<std::size_t NRound>
+    static constexpr void decrypt(const std::uint8_t* keys, std::array<std::uint8_t, 16>& block) noexcept {
+        auto s = xor_with(transform(block, tables.dec_in), keys);
+        Nibbles io{}, jo{};
+        for (std::size_t round = 1; round < NRound; ++round) {
+            inverse(permute(s, inv_shift_rows), io, jo);
+            const auto m14 = output(io, jo, tables.dec_14);
+            const auto m11 = permute(output(io, jo, tables.dec_11), rotate_rows<1>);
+            const auto m13 = permute(output(io, jo, tables.dec_13), rotate_rows<2>);
+            const auto m9 = permute(output(io, jo, tables.dec_9), rotate_rows<3>);
+            for (std::size_t n = 0; n < 16; ++n) s[n] = m14[n] ^ m11[n] ^ m13[n] ^ m9[n];
+            s = xor_with(s, keys + round * 16);
+        }
+        inverse(permute(s, inv_shift_rows), io, jo);
+        block = xor_with(output(io, jo, tables.dec_last), keys + NRound * 16);
+    }
+};
+
+#if CANGO_AES_X86
+/// @brief SSSE3 实现，所有查表都是寄存器内的 pshufb ，与数据无关
+struct Ssse3 {
+    CANGO_AES_TARGET("ssse3")
+    static __m128i load(const Nibbles& table) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data()));
+    }
+
+    CANGO_AES_TARGET("ssse3")
+    static __m128i lookup(const __m128i lo_table, const __m128i hi_table, const __m128i x) noexcept {
+        const auto mask = _mm_set1_epi8(0x0f);
+        const auto lo = _mm_and_si128(x, mask);
+        const auto hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+        return _mm_xor_si128(_mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+    }
+
+    CANGO_AES_TARGET("ssse3")
+    static void inverse(const __m128i x, const __m128i inv, const __m128i inv_c, __m128i& io, __m128i& jo) noexcept {
+        const auto mask = _mm_set1_epi8(0x0f);
+        const auto k = _mm_and_si128(x, mask);
+        const auto i = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+        const auto j = _mm_xor_si128(i, k);
+        const auto ak = _mm_shuffle_epi8(inv_c, k);
+        const auto iak = _mm_xor_si128(_mm_shuffle_epi8(inv, i), ak);
+        const auto jak = _mm_xor_si128(_mm_shuffle_epi8(inv, j), ak);
+        io = _mm_xor_si128(_mm_shuffle_epi8(inv, iak), j);
+        jo = _mm_xor_si128(_mm_shuffle_epi8(inv, jak), i);
+    }
+
+    CANGO_AES_TARGET("ssse3")
+    static __m128i output(const __m128i io, const __m128i jo, const std::array<Nibbles, 2>& table) noexcept {
+        return _mm_xor_si128(_mm_shuffle_epi8(load(table[0]), io), _mm_shuffle_epi8(load(table[1]), jo));
+    }
+
+    /// @brief 同时加密 NLanes 个数据块，各块的轮次交错执行以隐藏 pshufb 的延迟
+    /// @param in 输入数据，NLanes * 16 字节
+    /// @param out 输出数据，NLanes * 16 字节，可以与输入相同
+    template<std::size_t NRound, std::size_t NLanes = 1>
+    CANGO_AES_TARGET("ssse3")
+    static void encrypt(const std::uint8_t* keys, const std::uint8_t* in, std::uint8_t* out) noexcept {
+        const auto rk = reinterpret_cast<const __m128i*>(keys);
+        const auto inv = load(tables.inv), inv_c = load(tables.inv_c);
+        const auto sr = load(shift_rows);
+        const auto rot1 = load(rotate_rows<1>), rot2 = load(rotate_rows<2>), rot3 = load(rotate_rows<3>);
+        const auto in_lo = load(tables.enc_in[0]), in_hi = load(tables.enc_in[1]);
+        __m128i s[NLanes];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + lane);
+            s[lane] = _mm_xor_si128(lookup(in_lo, in_hi, block), _mm_load_si128(rk));
+        }
+        __m128i io, jo;
+        for (std::size_t round = 1; round < NRound; ++round) {
+            const auto key = _mm_load_si128(rk + round);
+            CANGO_AES_UNROLL
+            for (std::size_t lane = 0; lane < NLanes; ++lane) {
+                inverse(_mm_shuffle_epi8(s[lane], sr), inv, inv_c, io, jo);
+                const auto a = output(io, jo, tables.enc_s);
+                const auto d = output(io, jo, tables.enc_s2);
+                auto t = _mm_xor_si128(d, _mm_shuffle_epi8(_mm_xor_si128(a, d), rot1));
+                t = _mm_xor_si128(t, _mm_shuffle_epi8(a, rot2));
+                t = _mm_xor_si128(t, _mm_shuffle_epi8(a, rot3));
+                s[lane] = _mm_xor_si128(t, key);
+            }
+        }
+        const auto last_key = _mm_load_si128(rk + NRound);
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            inverse(_mm_shuffle_epi8(s[lane], sr), inv, inv_c, io, jo);
+            const auto block = _mm_xor_si128(output(io, jo, tables.enc_last), last_key);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + lane, block);
+        }
+    }
+
+    /// @brief 同时解密 NLanes 个数据块
+    /// @param in 输入数据，NLanes * 16 字节
+    /// @param out 输出数据，NLanes * 16 字节，可以与输入相同
+    template<std::size_t NRound, std::size_t NLanes = 1>
+    CANGO_AES_TARGET("ssse3")
+    static void decrypt(const std::uint8_t* keys, const std::uint8_t* in, std::uint8_t* out) noexcept {
+        const auto rk = reinterpret_cast<const __m128i*>(keys);
+        const auto inv = load(tables.inv), inv_c = load(tables.inv_c);
+        const auto isr = load(inv_shift_rows);
+        const auto rot1 = load(rotate_rows<1>), rot2 = load(rotate_rows<2>), rot3 = load(rotate_rows<3>);
+        const auto in_lo = load(tables.dec_in[0]), in_hi = load(tables.dec_in[1]);
+        __m128i s[NLanes];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + lane);
+            s[lane] = _mm_xor_si128(lookup(in_lo, in_hi, block), _mm_load_si128(rk));
+        }
+        __m128i io, jo;
+        for (std::size_t round = 1; round < NRound; ++round) {
+            const auto key = _mm_load_si128(rk + round);
+            CANGO_AES_UNROLL
+            for (std::size_t lane = 0; lane < NLanes; ++lane) {
+                inverse(_mm_shuffle_epi8(s[lane], isr), inv, inv_c, io, jo);
+                auto t = output(io, jo, tables.dec_14);
+                t = _mm_xor_si128(t, _mm_shuffle_epi8(output(io, jo, tables.dec_11), rot1));
+                t = _mm_xor_si128(t, _mm_shuffle_epi8(output(io, jo, tables.dec_13), rot2));
+                t = _mm_xor_si128(t, _mm_shuffle_epi8(output(io, jo, tables.dec_9), rot3));
+                s[lane] = _mm_xor_si128(t, key);
+            }
+        }
+        const auto last_key = _mm_load_si128(rk + NRound);
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            inverse(_mm_shuffle_epi8(s[lane], isr), inv, inv_c, io, jo);
+            const auto block = _mm_xor_si128(output(io, jo, tables.dec_last), last_key);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + lane, block);
+        }
+    }
+};
+#endif
+
+}
+
+/// @brief 向量置换(vpaes 风格)轮密钥，单块也是常数时间
+/// @details 字节替换在塔域 GF((2^4)^2) 中求逆，所有查表都是 16 项的 pshufb ，不使用 256 项的 SBox/InvSBox 。
+/// 状态在各轮之间保持在塔域坐标下，轮密钥在扩展时就转换到对应的坐标，并折入仿射常数。
+/// 不支持 SSSE3 的 CPU 和编译期求值使用逐字节模拟，此时不是常数时间。
+template<std::size_t NRound>
+struct VpermRoundKeys {
+    /// @brief 标准定义的轮数
+    static constexpr auto round_count = NRound;
+
+    /// @brief 轮密钥数
+    static constexpr auto key_count = round_count + 1;
+
+    /// @brief 转换到塔域坐标的加密轮密钥
+    alignas(16) std::array<std::uint8_t, 16 * key_count> enc;
+
+    /// @brief 转换到塔域坐标的等价逆密码解密轮密钥
+    alignas(16) std::array<std::uint8_t, 16 * key_count> dec;
+
+    /// @brief 从字节列表主钥展开轮钥
+    /// @param mainKey 主钥
+    /// @return 轮钥
+    static constexpr VpermRoundKeys from_array(const auto& mainKey) {
+        VpermRoundKeys result;
+        result.expand_from(mainKey);
+        return result;
+    }
+
+    /// @brief 从主密钥扩展得到轮密钥，全程常数时间
+    /// @tparam NBytes 主密钥字节数
+    /// @param mainKey 主密钥数据
+    template<std::size_t NBytes>
+    constexpr void expand_from(const std::array<std::uint8_t, NBytes>& mainKey) {
+        std::array<std::uint32_t, 4 * key_count> words{};
+        bitslice::expand_words(mainKey, words);
+
+        const auto& t = vperm::tables;
+        const auto enc_const = t.to_tower(0x63);
+        const auto dec_const = t.to_tower_inv(0x63);
+        for (std::size_t round = 0; round < key_count; ++round) {
+            for (std::size_t col = 0; col < 4; ++col) {
+                const auto enc_word = words[round * 4 + col];
+                auto dec_word = words[(NRound - round) * 4 + col];
+                if (round != 0 && round != NRound) dec_word = inv_mix_column_u32(dec_word);
+                for (std::size_t row = 0; row < 4; ++row) {
+                    const auto index = round * 16 + col * 4 + row;
+                    const auto enc_byte = static_cast<std::uint8_t>(enc_word >> (8 * row));
+                    const auto dec_byte = static_cast<std::uint8_t>(dec_word >> (8 * row));
+                    if (round == 0) enc[index] = t.to_tower(enc_byte);
+                    else if (round == NRound) enc[index] = enc_byte ^ 0x63;
+                    else enc[index] = t.to_tower(enc_byte) ^ enc_const;
+                    dec[index] = round == NRound ? dec_byte : t.to_tower_inv(dec_byte) ^ dec_const;
+                }
+            }
+        }
+    }
+
+    /// @brief 加密数据，直接在原数据上操作
+    constexpr void encrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+#if CANGO_AES_X86
+        if (!std::is_constant_evaluated() && cpu_features().ssse3) {
+            vperm::Ssse3::encrypt<NRound>(enc.data(), origin.data(), origin.data());
+            return;
+        }
+#endif
+        vperm::Scalar::encrypt<NRound>(enc.data(), origin);
+    }
+
+    /// @brief 解密数据，直接在原数据上操作
+    constexpr void decrypt(std::array<std::uint8_t, 16>& origin) const noexcept {
+#if CANGO_AES_X86
+        if (!std::is_constant_evaluated() && cpu_features().ssse3) {
+            vperm::Ssse3::decrypt<NRound>(dec.data(), origin.data(), origin.data());
+            return;
+        }
+#endif
+        vperm::Scalar::decrypt<NRound>(dec.data(), origin);
+    }
+
+    /// @brief 加密连续的多个数据块，SSSE3 下每 4 块交错处理
+    /// @param in 输入数据，count * 16 字节
+    /// @param out 输出数据，count * 16 字节，可以与输入相同
+    void encrypt_blocks(const std::uint8_t* in, std::uint8_t* out, const std::size_t count) const noexcept {
+        process_blocks<true>(in, out, count);
+    }
+
+    /// @brief 解密连续的多个数据块，SSSE3 下每 4 块交错处理
+    /// @param in 输入数据，count * 16 字节
+    /// @param out 输出数据，count * 16 字节，可以与输入相同
+    void decrypt_blocks(const std::uint8_t* in, std::uint8_t* out, const std::size_t count) const noexcept {
+        process_blocks<false>(in, out, count);
+    }
+
+private:
+    /// @brief 每次交错处理的块数
+    static constexpr std::size_t interleave = 4;
+
+    template<bool Encrypt>
+    void process_blocks(const std::uint8_t* in, std::uint8_t* out, std::size_t count) const noexcept {
+#if CANGO_AES_X86
+        if (cpu_features().ssse3) {
+            for (; count >= interleave; count -= interleave, in += 16 * interleave, out += 16 * interleave) {
+                if constexpr (Encrypt) vperm::Ssse3::encrypt<NRound, interleave>(enc.data(), in, out);
+                else vperm::Ssse3::decrypt<NRound, interleave>(dec.data(), in, out);
+            }
+            for (; count > 0; --count, in += 16, out += 16) {
+                if constexpr (Encrypt) vperm::Ssse3::encrypt<NRound>(enc.data(), in, out);
+                else vperm::Ssse3::decrypt<NRound>(dec.data(), in, out);
+            }
+            return;
+        }
+#endif
+        for (; count > 0; --count, in += 16, out += 16) {
+            std::array<std::uint8_t, 16> block;
+            std::memcpy(block.data(), in, 16);
+            if constexpr (Encrypt) vperm::Scalar::encrypt<NRound>(enc.data(), block);
+            else vperm::Scalar::decrypt<NRound>(dec.data(), block);
+            std::memcpy(out, block.data(), 16);
+        }
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_DETAILS_VPERM
@@ -2,6 +2,8 @@
 #define INCLUDE_CANGO_AES_DETAILS_WORD
 
 #include <array>
+#include <bit>
+#include <cstdint>
 
 #include "sbox.hpp"
 #include "utils.hpp"
@@ -17,6 +19,85 @@ constexpr Word operator^(const Word& lhs, const Word& rhs) noexcept {
     return result;
 }
 
+/// @brief 将 4 个字节按小端序打包为 32 位字，第 0 个字节位于最低 8 位
+/// @param bytes 字节序列的起始位置
+[[nodiscard]] constexpr std::uint32_t load_u32le(const std::uint8_t* bytes) noexcept {
+    return static_cast<std::uint32_t>(bytes[0])
+        | static_cast<std::uint32_t>(bytes[1]) << 8
+        | static_cast<std::uint32_t>(bytes[2]) << 16
+        | static_cast<std::uint32_t>(bytes[3]) << 24;
+}
+
+/// @brief 对打包在 32 位字中的 4 个字节同时做 xtime ，没有分支
+[[nodiscard]] constexpr std::uint32_t xtime_u32(const std::uint32_t word) noexcept {
+    return ((word & 0x7f7f7f7fu) << 1) ^ (((word >> 7) & 0x01010101u) * 0x1bu);
+}
+
+/// @brief 对一列做列混合，第 i 行位于第 i 个字节(小端序)，只用移位和异或，与数据无关
+[[nodiscard]] constexpr std::uint32_t mix_column_u32(const std::uint32_t column) noexcept {
+    const auto x2 = xtime_u32(column);
+    return x2 ^ std::rotr(x2 ^ column, 8) ^ std::rotr(column, 16) ^ std::rotr(column, 24);
+}
+
+/// @brief 对一列做逆列混合，第 i 行位于第 i 个字节(小端序)，只用移位和异或，与数据无关
+[[nodiscard]] constexpr std::uint32_t inv_mix_column_u32(const std::uint32_t column) noexcept {
+    const auto x2 = xtime_u32(column);
+    const auto x4 = xtime_u32(x2);
+    const auto x8 = xtime_u32(x4);
+    const auto m9 = x8 ^ column;
+    const auto m11 = m9 ^ x2;
+    const auto m13 = m9 ^ x4;
+    const auto m14 = x8 ^ x4 ^ x2;
+    return m14 ^ std::rotr(m11, 8) ^ std::rotr(m13, 16) ^ std::rotr(m9, 24);
+}
+
+/// @brief 将 32 位字按小端序拆为 4 个字节，最低 8 位写入第 0 个字节
+/// @param bytes 字节序列的起始位置
+/// @param value 需要写入的字
+constexpr void store_u32le(std::uint8_t* bytes, const std::uint32_t value) noexcept {
+    bytes[0] = static_cast<std::uint8_t>(value);
+    bytes[1] = static_cast<std::uint8_t>(value >> 8);
+    bytes[2] = static_cast<std::uint8_t>(value >> 16);
+    bytes[3] = static_cast<std::uint8_t>(value >> 24);
+}
+
+/// @brief 将 4 个字节按大端序打包为 32 位字，第 0 个字节位于最高 8 位
+[[nodiscard]] constexpr std::uint32_t load_u32be(const std::uint8_t* bytes) noexcept {
+    return static_cast<std::uint32_t>(bytes[0]) << 24
+        | static_cast<std::uint32_t>(bytes[1]) << 16
+        | static_cast<std::uint32_t>(bytes[2]) << 8
+        | static_cast<std::uint32_t>(bytes[3]);
+}
+
+/// @brief 将 32 位字按大端序拆为 4 个字节
+constexpr void store_u32be(std::uint8_t* bytes, const std::uint32_t value) noexcept {
+    for (std::size_t i = 0; i < 4; ++i) bytes[i] = static_cast<std::uint8_t>(value >> (24 - 8 * i));
+}
+
+/// @brief 将 8 个字节按大端序打包为 64 位字
+[[nodiscard]] constexpr std::uint64_t load_u64be(const std::uint8_t* bytes) noexcept {
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < 8; ++i) result = result << 8 | bytes[i];
+    return result;
+}
+
+/// @brief 将 8 个字节按小端序打包为 64 位字
+[[nodiscard]] constexpr std::uint64_t load_u64le(const std::uint8_t* bytes) noexcept {
+    std::uint64_t result = 0;
+    for (std::size_t i = 8; i-- > 0;) result = result << 8 | bytes[i];
+    return result;
+}
+
+/// @brief 将 64 位字按小端序拆为 8 个字节
+constexpr void store_u64le(std::uint8_t* bytes, const std::uint64_t value) noexcept {
+    for (std::size_t i = 0; i < 8; ++i) bytes[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+/// @brief 将 64 位字按大端序拆为 8 个字节
+constexpr void store_u64be(std::uint8_t* bytes, const std::uint64_t value) noexcept {
+    for (std::size_t i = 0; i < 8; ++i) bytes[i] = static_cast<std::uint8_t>(value >> (56 - 8 * i));
+}
+
 }
 
 #endif//INCLUDE_CANGO_AES_DETAILS_WORD
@@ -0,0 +1,40 @@
+#ifndef INCLUDE_CANGO_AES_ECB
+#define INCLUDE_CANGO_AES_ECB
+
+#include <cstddef>
+#include <span>
+
+#include "details/segments.hpp"
+
+namespace cango::aes {
+
+/// @brief 加密一串分段中的完整块，块可以跨越分段边界
+/// @details 分段内的块直接走多块接口，只有跨越边界的块经过栈上的 16 字节缓冲区
+/// @param out 输出分段，切分方式可以与 in 不同；原地处理时传入同一串分段
+/// @return 处理的块数，末尾不足一块的数据不处理
+template<typename TCryptor>
+std::size_t encrypt_segments(const TCryptor& cryptor, const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+    return details::for_each_block_run(in, out, [&cryptor](const auto source, const auto target) { cryptor.encrypt_blocks(source, target); }) / 16;
+}
+
+/// @brief 原地加密一串分段中的完整块
+template<typename TCryptor>
+std::size_t encrypt_segments(const TCryptor& cryptor, const std::span<const std::span<std::byte>> data) noexcept {
+    return details::for_each_block_run(data, data, [&cryptor](const auto source, const auto target) { cryptor.encrypt_blocks(source, target); }) / 16;
+}
+
+/// @brief 解密一串分段中的完整块，参数与 encrypt_segments 相同
+template<typename TCryptor>
+std::size_t decrypt_segments(const TCryptor& cryptor, const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+    return details::for_each_block_run(in, out, [&cryptor](const auto source, const auto target) { cryptor.decrypt_blocks(source, target); }) / 16;
+}
+
+/// @brief 原地解密一串分段中的完整块
+template<typename TCryptor>
+std::size_t decrypt_segments(const TCryptor& cryptor, const std::span<const std::span<std::byte>> data) noexcept {
+    return details::for_each_block_run(data, data, [&cryptor](const auto source, const auto target) { cryptor.decrypt_blocks(source, target); }) / 16;
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_ECB
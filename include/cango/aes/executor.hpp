@@ -0,0 +1,217 @@
+#ifndef INCLUDE_CANGO_AES_EXECUTOR
+#define INCLUDE_CANGO_AES_EXECUTOR
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "details/parallel.hpp"
+
+namespace cango::aes {
+
+/// @brief 线程池的选项
+struct ExecutorOptions {
+    /// @brief 参与计算的线程数，包括提交任务的线程；为 0 时使用硬件并发数
+    std::size_t threads = 0;
+
+    /// @brief 总数据量小于该字节数时不拆分，直接在调用线程上执行
+    std::size_t serial_bytes = 256 * 1024;
+
+    /// @brief 每个任务的最小字节数，低于此值时调度开销不可忽略
+    std::size_t min_chunk_bytes = 64 * 1024;
+
+    /// @brief 每个任务的最大字节数，约为单核二级缓存的大小，使一个任务的输入输出能留在缓存中
+    std::size_t max_chunk_bytes = 1024 * 1024;
+};
+
+/// @brief 可复用的工作窃取线程池
+/// @details 每个工作线程有自己的双端队列，从队尾取自己的任务，空闲时从其他队列的队头窃取。
+/// 提交任务的线程不会空等，也参与执行，直到本次提交的任务全部完成。
+/// 任务只保存调用方函数对象的地址，轮密钥等数据由调用方以只读方式共享，不会按任务复制。
+class Executor {
+    /// @brief 一次 run 调用，记录未完成的任务数
+    struct Job {
+        std::atomic<std::size_t> remaining;
+    };
+
+    /// @brief 一段任务，invoke 调用调用方的函数对象
+    struct Task {
+        void (*invoke)(const void* func, std::size_t index, std::size_t begin, std::size_t n);
+        const void* func;
+        std::size_t index;
+        std::size_t begin;
+        std::size_t n;
+        Job* job;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    ExecutorOptions options;
+
+    /// @brief 每个参与线程一个队列，最后一个队列属于提交任务的线程
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    /// @brief 已入队但尚未被取走的任务数
+    std::atomic<std::size_t> pending{0};
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    std::vector<std::jthread> workers;
+
+public:
+    explicit Executor(const ExecutorOptions& options = {}) : options(options) {
+        auto threads = options.threads;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+        workers.reserve(threads - 1);
+        for (std::size_t i = 0; i + 1 < threads; ++i) workers.emplace_back([this, i] { work(i); });
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    ~Executor() {
+        {
+            const std::lock_guard lock{sleep_mutex};
+            stopping = true;
+        }
+        wake.notify_all();
+    }
+
+    /// @brief 参与计算的线程数，包括提交任务的线程
+    [[nodiscard]] std::size_t concurrency() const noexcept {
+        return queues.size();
+    }
+
+    /// @brief 按数据量切分工作
+    /// @details 数据量低于 serial_bytes 时不拆分；否则每个线程约 4 个任务以便负载均衡，
+    /// 每个任务的字节数限制在 [min_chunk_bytes, max_chunk_bytes] 内。
+    /// @param units 总单位数
+    /// @param unitBytes 每个单位的字节数，如块为 16 ，扇区为扇区大小
+    [[nodiscard]] details::ChunkPlan plan(const std::size_t units, const std::size_t unitBytes) const noexcept {
+        const auto bytes = units * unitBytes;
+        if (units == 0 || concurrency() == 1 || bytes < options.serial_bytes) return {std::max<std::size_t>(units, 1), 1};
+        const auto min_units = std::max<std::size_t>(options.min_chunk_bytes / unitBytes, 1);
+        const auto max_units = std::max(options.max_chunk_bytes / unitBytes, min_units);
+        const auto chunk = std::clamp((units + concurrency() * 4 - 1) / (concurrency() * 4), min_units, max_units);
+        return {chunk, (units + chunk - 1) / chunk};
+    }
+
+    /// @brief 按方案并行执行，与 details::run_chunks 的约定相同，返回时所有段都已完成
+    /// @param func 以 (段序号, 起始单位, 单位数) 调用，可能在多个线程上同时调用
+    template<typename TFunc>
+    void run(const details::ChunkPlan& plan, const std::size_t units, const TFunc& func) {
+        if (plan.count <= 1) {
+            func(std::size_t{0}, std::size_t{0}, std::min(plan.chunk, units));
+            return;
+        }
+
+        Job job{plan.count};
+        {
+            // 先计数再入队，工作线程取走任务时计数不会小于 0
+            const std::lock_guard lock{sleep_mutex};
+            pending += plan.count;
+        }
+        constexpr auto invoke = [](const void* f, const std::size_t index, const std::size_t begin, const std::size_t n) {
+            (*static_cast<const TFunc*>(f))(index, begin, n);
+        };
+        // 相邻的段放在同一个队列中，各线程先处理连续的数据
+        const auto per_queue = (plan.count + queues.size() - 1) / queues.size();
+        for (std::size_t q = 0; q < queues.size(); ++q) {
+            const std::lock_guard lock{queues[q]->mutex};
+            for (auto index = q * per_queue; index < std::min((q + 1) * per_queue, plan.count); ++index) {
+                const auto begin = index * plan.chunk;
+                queues[q]->tasks.push_back({invoke, &func, index, begin, std::min(plan.chunk, units - begin), &job});
+            }
+        }
+        wake.notify_all();
+
+        const auto self = queues.size() - 1;
+        while (true) {
+            const auto remaining = job.remaining.load();
+            if (remaining == 0) break;
+            if (auto task = take(self)) execute(*task);
+            else job.remaining.wait(remaining);
+        }
+    }
+
+private:
+    void work(const std::size_t self) {
+        while (true) {
+            if (auto task = take(self)) {
+                execute(*task);
+                continue;
+            }
+            std::unique_lock lock{sleep_mutex};
+            wake.wait(lock, [this] { return stopping || pending.load() > 0; });
+            if (stopping) return;
+        }
+    }
+
+    /// @brief 先从自己的队尾取，再从其他队列的队头窃取
+    std::optional<Task> take(const std::size_t self) {
+        if (auto task = pop(*queues[self], false)) return task;
+        for (std::size_t i = 1; i < queues.size(); ++i)
+            if (auto task = pop(*queues[(self + i) % queues.size()], true)) return task;
+        return std::nullopt;
+    }
+
+    std::optional<Task> pop(Queue& queue, const bool front) {
+        const std::lock_guard lock{queue.mutex};
+        if (queue.tasks.empty()) return std::nullopt;
+        Task task;
+        if (front) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+        else {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        --pending;
+        return task;
+    }
+
+    static void execute(const Task& task) {
+        task.invoke(task.func, task.index, task.begin, task.n);
+        if (task.job->remaining.fetch_sub(1) == 1) task.job->remaining.notify_all();
+    }
+};
+
+/// @brief 用线程池并行加密多个块
+/// @return 处理的块数，与 Cryptor::encrypt_blocks 相同
+template<typename TCryptor>
+std::size_t encrypt_blocks(const TCryptor& cryptor, const std::span<const std::byte> in, const std::span<std::byte> out, Executor& executor) {
+    const auto count = std::min(in.size(), out.size()) / 16;
+    executor.run(executor.plan(count, 16), count, [&](std::size_t, const std::size_t begin, const std::size_t n) {
+        cryptor.encrypt_blocks(in.subspan(begin * 16, n * 16), out.subspan(begin * 16, n * 16));
+    });
+    return count;
+}
+
+/// @brief 用线程池并行解密多个块
+template<typename TCryptor>
+std::size_t decrypt_blocks(const TCryptor& cryptor, const std::span<const std::byte> in, const std::span<std::byte> out, Executor& executor) {
+    const auto count = std::min(in.size(), out.size()) / 16;
+    executor.run(executor.plan(count, 16), count, [&](std::size_t, const std::size_t begin, const std::size_t n) {
+        cryptor.decrypt_blocks(in.subspan(begin * 16, n * 16), out.subspan(begin * 16, n * 16));
+    });
+    return count;
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_EXECUTOR
@@ -0,0 +1,228 @@
+#ifndef INCLUDE_CANGO_AES_FILE
+#define INCLUDE_CANGO_AES_FILE
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <thread>
+
+#include "ctr.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+/// @brief 是否可以使用 mmap 处理文件
+#define CANGO_AES_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CANGO_AES_MMAP 0
+#endif
+
+namespace cango::aes {
+
+/// @brief 文件处理的选项
+struct FileOptions {
+    /// @brief 线程数，为 0 时使用硬件并发数
+    std::size_t threads = 0;
+
+    /// @brief 读写回退路径中每个缓冲区的字节数，应为 16 的倍数
+    std::size_t buffer_bytes = 8 * 1024 * 1024;
+
+    /// @brief 是否尝试内存映射，为 false 时总是使用读写回退路径
+    bool allow_mmap = true;
+
+    /// @brief 线程池，不为空时代替 threads 使用，避免每次调用都创建线程
+    Executor* executor = nullptr;
+};
+
+/// @brief 文件处理的结果
+struct FileReport {
+    /// @brief 处理的字节数
+    std::uint64_t bytes = 0;
+
+    /// @brief 是否使用了内存映射
+    bool mapped = false;
+
+    /// @brief 失败时的系统错误，成功时为空
+    std::error_code error;
+};
+
+namespace details {
+
+/// @brief 当前 errno 对应的错误
+inline std::error_code last_error() noexcept {
+    return {errno, std::generic_category()};
+}
+
+/// @brief 关闭 FILE* 的删除器
+struct FileCloser {
+    void operator()(std::FILE* file) const noexcept {
+        std::fclose(file);
+    }
+};
+
+using FileHandle = std::unique_ptr<std::FILE, FileCloser>;
+
+/// @brief 数据超出计数器范围时报告的错误
+inline std::error_code file_too_large() noexcept {
+    return std::make_error_code(std::errc::file_too_large);
+}
+
+/// @brief 读满缓冲区，只有到达文件末尾时才会读得更少
+inline std::size_t read_full(std::FILE* file, std::byte* buffer, const std::size_t size) noexcept {
+    std::size_t total = 0;
+    while (total < size) {
+        const auto n = std::fread(buffer + total, 1, size - total, file);
+        if (n == 0) break;
+        total += n;
+    }
+    return total;
+}
+
+/// @brief 读写回退路径：一个线程读下一段的同时，当前线程加密并写出上一段
+template<typename TCryptor, std::size_t NCounterBits>
+FileReport ctr_file_stream(CtrCryptor<TCryptor, NCounterBits>& ctr, const std::filesystem::path& input, const std::filesystem::path& output,
+                           const FileOptions& options) {
+    FileReport report{};
+    const FileHandle in{std::fopen(input.string().c_str(), "rb")};
+    if (!in) return {0, false, last_error()};
+    const FileHandle out{std::fopen(output.string().c_str(), "wb")};
+    if (!out) return {0, false, last_error()};
+
+    const auto capacity = std::max<std::size_t>(options.buffer_bytes / 16 * 16, 16);
+    const auto storage = std::make_unique<std::byte[]>(capacity * 2);
+    std::span<std::byte> buffers[2]{{storage.get(), capacity}, {storage.get() + capacity, capacity}};
+
+    auto size = read_full(in.get(), buffers[0].data(), capacity);
+    for (std::size_t current = 0; size != 0; current ^= 1) {
+        // 输入可能是管道，无法事先得知长度，只能在加密超出计数器范围的数据之前停下
+        if (exceeds_counter<NCounterBits>(report.bytes + size)) return {report.bytes, false, file_too_large()};
+        std::size_t next_size = 0;
+        {
+            const std::jthread reader{[&] { next_size = read_full(in.get(), buffers[current ^ 1].data(), capacity); }};
+            const auto data = buffers[current].first(size);
+            if (options.executor) ctr.apply_parallel(data, *options.executor);
+            else ctr.apply_parallel(data, options.threads);
+            if (std::fwrite(data.data(), 1, size, out.get()) != size) return {report.bytes, false, last_error()};
+        }
+        report.bytes += size;
+        size = next_size;
+    }
+    if (std::ferror(in.get()) || std::fflush(out.get()) != 0) report.error = last_error();
+    return report;
+}
+
+#if CANGO_AES_MMAP
+/// @brief 关闭文件描述符
+struct Descriptor {
+    int fd = -1;
+
+    ~Descriptor() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+/// @brief 解除映射
+struct Mapping {
+    void* address = MAP_FAILED;
+    std::size_t size = 0;
+
+    ~Mapping() {
+        if (address != MAP_FAILED) ::munmap(address, size);
+    }
+};
+
+/// @brief 为输出文件分配实际的磁盘块并设置长度
+/// @details 只用 ftruncate 得到的是稀疏文件，磁盘写满时写入映射会触发 SIGBUS ；
+/// 预先分配失败(空间不足或文件系统不支持)时返回 false ，由调用方回退到读写路径
+inline bool reserve_file(const int fd, const std::size_t size) noexcept {
+    if (size == 0) return true;
+#if defined(__APPLE__)
+    fstore_t store{F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0};
+    return ::fcntl(fd, F_PREALLOCATE, &store) != -1 && ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+    return ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+/// @brief 内存映射路径，输入不是普通文件或映射失败时返回 false ，由调用方回退到读写路径
+template<typename TCryptor, std::size_t NCounterBits>
+bool ctr_file_mapped(CtrCryptor<TCryptor, NCounterBits>& ctr, const std::filesystem::path& input, const std::filesystem::path& output,
+                     const FileOptions& options, FileReport& report) {
+    const Descriptor in{::open(input.c_str(), O_RDONLY)};
+    if (in.fd < 0) return false;
+    struct stat info{};
+    if (::fstat(in.fd, &info) != 0 || !S_ISREG(info.st_mode)) return false;
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (exceeds_counter<NCounterBits>(size)) {
+        report = {0, false, file_too_large()};
+        return true;
+    }
+
+    const Descriptor out{::open(output.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if (out.fd < 0) return false;
+    if (!reserve_file(out.fd, size)) return false;
+    report = {size, true, {}};
+    if (size == 0) return true;
+
+    const Mapping source{::mmap(nullptr, size, PROT_READ, MAP_SHARED, in.fd, 0), size};
+    if (source.address == MAP_FAILED) return false;
+    const Mapping target{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, out.fd, 0), size};
+    if (target.address == MAP_FAILED) return false;
+    ::madvise(source.address, size, MADV_SEQUENTIAL);
+    ::madvise(target.address, size, MADV_SEQUENTIAL);
+
+    // 每个线程处理一段连续的数据，从该段的字节偏移对应的计数器开始
+    const std::span plain{static_cast<const std::byte*>(source.address), size};
+    const std::span cipher{static_cast<std::byte*>(target.address), size};
+    if (options.executor) ctr.apply_parallel(plain, cipher, *options.executor);
+    else ctr.apply_parallel(plain, cipher, options.threads);
+    // 写回失败时不能报告成功
+    if (::msync(target.address, size, MS_SYNC) != 0) report = {0, true, last_error()};
+    return true;
+}
+#endif
+
+}
+
+/// @brief 用 CTR 模式加密或解密整个文件
+/// @details 优先把输入和输出映射到内存，按字节偏移分给多个线程，每个线程从自己的计数器偏移开始；
+/// 输出的磁盘空间在映射前预先分配，映射的写回在返回前同步完成。
+/// 输入不是普通文件(如管道)、无法预先分配或无法映射时，回退为双缓冲的读、加密、写流水线。
+/// CTR 的加密和解密是同一个操作。
+/// 默认使用 128 位计数器，任何大小的文件都不会重复使用密钥流；
+/// 使用 32 位计数器时文件超过 16 * 2^32 字节(64 GiB)即会回绕，此时不做任何加密，报告 std::errc::file_too_large 。
+/// @param cryptor 已初始化的密码工具
+/// @param initialCounter 文件偏移为 0 处的计数器块
+/// @param input 输入文件
+/// @param output 输出文件，已存在时被覆盖，不能与 input 是同一个文件
+template<typename TCryptor, std::size_t NCounterBits = 128>
+FileReport ctr_file(const TCryptor& cryptor, const block_t& initialCounter, const std::filesystem::path& input,
+                    const std::filesystem::path& output, const FileOptions& options = {}) {
+    if constexpr (NCounterBits < 64) {
+        std::error_code error;
+        if (std::filesystem::is_regular_file(input, error)) {
+            const auto size = std::filesystem::file_size(input, error);
+            if (!error && details::exceeds_counter<NCounterBits>(size)) return {0, false, details::file_too_large()};
+        }
+    }
+    CtrCryptor<TCryptor, NCounterBits> ctr{cryptor, initialCounter};
+#if CANGO_AES_MMAP
+    if (options.allow_mmap) {
+        FileReport report{};
+        if (details::ctr_file_mapped(ctr, input, output, options, report)) return report;
+    }
+#endif
+    return details::ctr_file_stream(ctr, input, output, options);
+}
+
+}
+
+#endif//INCLUDE_CANGO_AES_FILE
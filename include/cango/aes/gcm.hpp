@@ -0,0 +1,282 @@
+#ifndef INCLUDE_CANGO_AES_GCM
+#define INCLUDE_CANGO_AES_GCM
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include "cryptor.hpp"
+#include "ctr.hpp"
+#include "details/ghash.hpp"
+#include "details/segments.hpp"
+#include "details/tag.hpp"
+
+namespace cango::aes {
+
+/// @brief GCM 认证加密(SP 800-38D)
+/// @details 每条消息依次调用 start, update_aad(可多次), encrypt 或 decrypt(可多次), finish 或 verify 。
+/// 附加数据和载荷都可以按任意长度分段传入，不足一块的部分在内部的 16 字节缓冲区中暂存。
+/// 载荷按 8 块一段处理，每段先生成 CTR 密钥流，再趁数据还在一级缓存中时吸收进 GHASH ，每个字节只经过一遍。
+/// 同一个密钥下 start 的代价只有一到两次分组加密，GHASH 的表在构造时生成一次。
+/// 载荷超过 SP 800-38D 的上限 (2^32 - 2) * 16 字节或附加数据超过 2^61 - 1 字节时，32 位计数器会回绕到 J0 ，
+/// 重复使用掩盖标签的密钥流；此时拒绝该段数据并使当前消息失效，finish 返回空，verify 返回 false ，直到下一次 start 。
+/// @tparam TCryptor 密码工具类型，需要提供 encrypt_blocks ，对象的生命周期必须长于本对象
+template<typename TCryptor>
+class GcmCryptor {
+    /// @brief 每段融合处理的字节数
+    static constexpr std::size_t chunk_bytes = 16 * 8;
+
+    const TCryptor* cryptor;
+
+    /// @brief GHASH 的密钥部分，由 H = E(0) 生成
+    details::ghash::Key hash_key;
+
+    /// @brief 载荷的 CTR 密钥流，从 inc32(J0) 开始
+    CtrCryptor<TCryptor, 32> ctr;
+
+    /// @brief E(J0) ，与 GHASH 结果异或得到标签
+    block_t tag_mask{};
+
+    /// @brief GHASH 状态
+    block_t state{};
+
+    /// @brief 不足一块的待吸收数据
+    block_t pending{};
+    std::size_t pending_size = 0;
+
+    /// @brief 每条消息的载荷上限，不超过 max_payload_bytes
+    std::uint64_t payload_limit;
+
+    std::uint64_t aad_bytes = 0;
+    std::uint64_t payload_bytes = 0;
+    bool payload_started = false;
+
+    /// @brief 当前消息超出长度上限，已失效
+    bool failed = false;
+
+public:
+    /// @brief 标签的最大字节数
+    static constexpr std::size_t tag_size = 16;
+
+    /// @brief 载荷最多使用的计数器值之外保留的个数：J0 用于标签，另按 SP 800-38D 保留一个
+    static constexpr std::uint64_t reserved_counters = 2;
+
+    /// @brief 每条消息的载荷上限，SP 800-38D 规定为 2^39 - 256 位
+    static constexpr std::uint64_t max_payload_bytes = ((std::uint64_t{1} << 32) - reserved_counters) * 16;
+
+    /// @brief 每条消息的附加数据上限，SP 800-38D 规定为 2^64 - 1 位
+    static constexpr std::uint64_t max_aad_bytes = (std::uint64_t{1} << 61) - 1;
+
+    /// @brief verify 默认接受的最短标签字节数，SP 800-38D 5.2.1.2 允许的一般长度为 12 到 16 字节
+    static constexpr std::size_t min_tag_size = 12;
+
+    /// @param cryptor 已初始化的密码工具
+    /// @param maxPayloadBytes 每条消息的载荷上限，不能超过 max_payload_bytes ；
+    /// 使用 SP 800-38D 附录 C 的短标签时应按其要求设定更小的上限
+    explicit GcmCryptor(const TCryptor& cryptor, const std::uint64_t maxPayloadBytes = max_payload_bytes) noexcept
+        : cryptor(&cryptor),
+          hash_key(details::ghash::Key::from(cryptor.encrypt(block_t{}))),
+          ctr(cryptor, block_t{}),
+          payload_limit(std::min(maxPayloadBytes, max_payload_bytes)) {}
+
+    /// @brief 开始一条新消息
+    /// @param iv 初始向量，推荐 12 字节；其他长度先经过 GHASH 得到 J0
+    void start(const std::span<const std::byte> iv) noexcept {
+        block_t j0{};
+        if (iv.size() == 12) {
+            std::memcpy(j0.data(), iv.data(), 12);
+            j0[15] = 1;
+        }
+        else {
+            reset_hash();
+            absorb(iv);
+            flush();
+            absorb_lengths(0, iv.size());
+            j0 = state;
+        }
+
+        tag_mask = j0;
+        cryptor->encrypt(tag_mask);
+        details::increment_counter<32>(j0);
+        ctr = CtrCryptor<TCryptor, 32>{*cryptor, j0};
+        reset_hash();
+        aad_bytes = 0;
+        payload_bytes = 0;
+        payload_started = false;
+        failed = false;
+    }
+
+    /// @brief 吸收附加数据，必须在载荷之前
+    /// @return 已经开始处理载荷时返回 false ，数据被忽略；超出附加数据上限时返回 false 并使当前消息失效
+    bool update_aad(const std::span<const std::byte> aad) noexcept {
+        if (payload_started || failed) return false;
+        if (aad.size() > max_aad_bytes - aad_bytes) {
+            failed = true;
+            return false;
+        }
+        absorb(aad);
+        aad_bytes += aad.size();
+        return true;
+    }
+
+    /// @brief 加密一段载荷
+    /// @param in 明文，任意长度
+    /// @param out 密文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 写入的字节数，即 min(in.size(), out.size()) ；超出载荷上限时为 0 ，并使当前消息失效
+    std::size_t encrypt(const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        return process<true>(in, out);
+    }
+
+    /// @brief 原地加密一段载荷
+    std::size_t encrypt(const std::span<std::byte> data) noexcept {
+        return process<true>(data, data);
+    }
+
+    /// @brief 解密一段载荷，在 verify 成功之前不应使用解密结果
+    /// @param in 密文，任意长度
+    /// @param out 明文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 写入的字节数，即 min(in.size(), out.size()) ；超出载荷上限时为 0 ，并使当前消息失效
+    std::size_t decrypt(const std::span<const std::byte> in, const std::span<std::byte> out) noexcept {
+        return process<false>(in, out);
+    }
+
+    /// @brief 原地解密一段载荷
+    std::size_t decrypt(const std::span<std::byte> data) noexcept {
+        return process<false>(data, data);
+    }
+
+    /// @brief 依次吸收一串附加数据分段，如分片报文的头部
+    bool update_aad_segments(const std::span<const std::span<const std::byte>> aad) noexcept {
+        if (payload_started) return false;
+        for (const auto segment: aad) update_aad(segment);
+        return !failed;
+    }
+
+    /// @brief 加密一串载荷分段，块可以跨越分段边界，数据不会被复制
+    /// @param out 输出分段，切分方式可以与 in 不同，但不能与 in 部分重叠
+    /// @return 写入的字节数，即两串分段总长度的较小值；超出载荷上限时为 0 ，并使当前消息失效
+    std::size_t encrypt_segments(const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+        const auto written = details::for_each_run(in, out, [this](const auto source, const auto target) { process<true>(source, target); });
+        return failed ? 0 : written;
+    }
+
+    /// @brief 原地加密一串载荷分段
+    std::size_t encrypt_segments(const std::span<const std::span<std::byte>> data) noexcept {
+        const auto written = details::for_each_run(data, data, [this](const auto source, const auto target) { process<true>(source, target); });
+        return failed ? 0 : written;
+    }
+
+    /// @brief 解密一串载荷分段，在 verify 成功之前不应使用解密结果
+    std::size_t decrypt_segments(const std::span<const std::span<const std::byte>> in, const std::span<const std::span<std::byte>> out) noexcept {
+        const auto written = details::for_each_run(in, out, [this](const auto source, const auto target) { process<false>(source, target); });
+        return failed ? 0 : written;
+    }
+
+    /// @brief 原地解密一串载荷分段
+    std::size_t decrypt_segments(const std::span<const std::span<std::byte>> data) noexcept {
+        const auto written = details::for_each_run(data, data, [this](const auto source, const auto target) { process<false>(source, target); });
+        return failed ? 0 : written;
+    }
+
+    /// @brief 结束消息并计算 16 字节标签，截断标签取前若干字节
+    /// @return 消息因超出长度上限而失效时为空
+    [[nodiscard]] std::optional<block_t> finish() noexcept {
+        if (failed) return std::nullopt;
+        flush();
+        absorb_lengths(aad_bytes, payload_bytes);
+        block_t tag{};
+        for (std::size_t i = 0; i < tag_size; ++i) tag[i] = state[i] ^ tag_mask[i];
+        return tag;
+    }
+
+    /// @brief 结束消息并以常数时间比较标签
+    /// @param tag 收到的标签，可以是截断的标签，长度为 12 到 16 字节
+    /// @param min_size 接受的最短标签字节数；只有显式传入 8 或 4 才接受 SP 800-38D 附录 C 的 8 字节或 4 字节短标签，
+    /// 这类标签只适用于限制了消息长度和验证失败次数的场合。其他长度的标签一律拒绝。
+    [[nodiscard]] bool verify(const std::span<const std::byte> tag, const std::size_t min_size = min_tag_size) noexcept {
+        const auto expected = finish();
+        const bool standard_size = tag.size() >= min_tag_size || tag.size() == 8 || tag.size() == 4;
+        return expected && standard_size && details::tag_equal(*expected, tag, min_size);
+    }
+
+private:
+    template<bool Encrypt>
+    std::size_t process(std::span<const std::byte> in, std::span<std::byte> out) noexcept {
+        if (!payload_started) {
+            flush();
+            payload_started = true;
+        }
+        const auto size = std::min(in.size(), out.size());
+        // 与文件管道相同的检查：计数器不能回绕到 J0
+        if (failed || payload_bytes + size > payload_limit || details::exceeds_counter<32>(payload_bytes + size, reserved_counters)) {
+            failed = true;
+            return 0;
+        }
+        for (std::size_t offset = 0; offset < size; offset += chunk_bytes) {
+            const auto n = std::min(chunk_bytes, size - offset);
+            const auto chunk_in = in.subspan(offset, n);
+            const auto chunk_out = out.subspan(offset, n);
+            if constexpr (Encrypt) {
+                ctr.apply(chunk_in, chunk_out);
+                absorb(chunk_out);
+            }
+            else {
+                absorb(chunk_in);
+                ctr.apply(chunk_in, chunk_out);
+            }
+        }
+        payload_bytes += size;
+        return size;
+    }
+
+    void reset_hash() noexcept {
+        state = {};
+        pending_size = 0;
+    }
+
+    /// @brief 吸收任意长度的数据，不足一块的部分暂存
+    void absorb(const std::span<const std::byte> data) noexcept {
+        auto bytes = reinterpret_cast<const std::uint8_t*>(data.data());
+        auto size = data.size();
+        if (size == 0) return;
+        if (pending_size != 0) {
+            const auto n = std::min(16 - pending_size, size);
+            std::memcpy(pending.data() + pending_size, bytes, n);
+            pending_size += n;
+            bytes += n;
+            size -= n;
+            if (pending_size < 16) return;
+            hash_key.absorb(state, pending.data(), 1);
+            pending_size = 0;
+        }
+        hash_key.absorb(state, bytes, size / 16);
+        pending_size = size % 16;
+        std::memcpy(pending.data(), bytes + size / 16 * 16, pending_size);
+    }
+
+    /// @brief 用 0 补齐暂存的数据并吸收
+    void flush() noexcept {
+        if (pending_size == 0) return;
+        std::fill(pending.begin() + static_cast<std::ptrdiff_t>(pending_size), pending.end(), 0);
+        hash_key.absorb(state, pending.data(), 1);
+        pending_size = 0;
+    }
+
+    /// @brief 吸收长度块 [len(A)]64 || [len(C)]64 ，单位为位
+    void absorb_lengths(const std::uint64_t first_bytes, const std::uint64_t second_bytes) noexcept {
+        block_t lengths{};
+        for (std::size_t i = 0; i < 8; ++i) {
+            lengths[i] = static_cast<std::uint8_t>((first_bytes * 8) >> (56 - 8 * i));
+            lengths[i + 8] = static_cast<std::uint8_t>((second_bytes * 8) >> (56 - 8 * i));
+        }
+        hash_key.absorb(state, lengths.data(), 1);
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_GCM
@@ -0,0 +1,160 @@
+#ifndef INCLUDE_CANGO_AES_STREAM
+#define INCLUDE_CANGO_AES_STREAM
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include "cryptor.hpp"
+#include "details/padding.hpp"
+
+namespace cango::aes {
+
+/// @brief 流式加密，输入可以按任意长度分段传入，结束时按 PKCS#7 填充
+/// @details 不足一块的尾部暂存在对象内的 16 字节缓冲区中，调用方缓冲区中的完整块直接走多块接口，不复制也不分配内存。
+/// 每块独立加密(ECB)，相同的明文块会得到相同的密文块，需要隐藏数据模式时应使用 CBC, CTR 或 GCM 。
+/// @tparam TCryptor 密码工具类型，需要提供 encrypt_blocks ，对象的生命周期必须长于本对象
+template<typename TCryptor>
+class StreamEncryptor {
+    const TCryptor* cryptor;
+
+    /// @brief 不足一块的待加密数据
+    block_t tail{};
+    std::size_t tail_size = 0;
+
+public:
+    /// @param cryptor 已初始化的密码工具
+    explicit constexpr StreamEncryptor(const TCryptor& cryptor) noexcept : cryptor(&cryptor) {}
+
+    /// @brief 丢弃暂存的数据，开始一条新消息，轮密钥不变
+    constexpr void reset() noexcept {
+        tail_size = 0;
+    }
+
+    /// @brief 传入 size 字节后 update 将写出的字节数，用于准备输出缓冲区
+    [[nodiscard]] constexpr std::size_t update_size(const std::size_t size) const noexcept {
+        return (tail_size + size) / 16 * 16;
+    }
+
+    /// @brief 加密一段数据，写出所有已经凑齐的块
+    /// @param in 明文，任意长度
+    /// @param out 密文，至少 update_size(in.size()) 字节，不能与 in 重叠
+    /// @return 写入的字节数，数据全部暂存时为 0 ；out 不够大时不做任何处理并返回空
+    std::optional<std::size_t> update(std::span<const std::byte> in, std::span<std::byte> out) noexcept {
+        if (in.empty()) return 0;
+        // 直接用 tail_size 写出边界，编译器才能看出暂存时不会越过 tail
+        if (tail_size + in.size() < 16) {
+            std::memcpy(tail.data() + tail_size, in.data(), in.size());
+            tail_size += in.size();
+            return 0;
+        }
+        const auto total = update_size(in.size());
+        if (out.size() < total) return std::nullopt;
+
+        if (tail_size != 0) {
+            const auto n = 16 - tail_size;
+            std::memcpy(tail.data() + tail_size, in.data(), n);
+            cryptor->encrypt(tail);
+            std::memcpy(out.data(), tail.data(), 16);
+            in = in.subspan(n);
+            out = out.subspan(16);
+        }
+        const auto whole = in.size() / 16 * 16;
+        cryptor->encrypt_blocks(in.first(whole), out);
+        tail_size = in.size() - whole;
+        std::memcpy(tail.data(), in.data() + whole, tail_size);
+        return total;
+    }
+
+    /// @brief 填充并加密最后一块，之后可以开始新消息
+    /// @param out 至少 16 字节
+    /// @return 写入的字节数，总是 16 ；out 不够大时不做任何处理并返回 0
+    std::size_t finalize(const std::span<std::byte> out) noexcept {
+        if (out.size() < 16) return 0;
+        details::pkcs7_pad(tail, tail_size);
+        cryptor->encrypt(tail);
+        std::memcpy(out.data(), tail.data(), 16);
+        reset();
+        return 16;
+    }
+};
+
+/// @brief 流式解密 StreamEncryptor 的输出，结束时检查并去掉 PKCS#7 填充
+/// @details 最后一块含有填充，总是保留到 finalize 才写出，因此 update 的输出会比输入滞后最多 16 字节。
+/// @tparam TCryptor 密码工具类型，需要提供 decrypt_blocks ，对象的生命周期必须长于本对象
+template<typename TCryptor>
+class StreamDecryptor {
+    const TCryptor* cryptor;
+
+    /// @brief 尚未写出的数据，有数据时总是保留 1 到 16 字节
+    block_t tail{};
+    std::size_t tail_size = 0;
+
+public:
+    /// @param cryptor 已初始化的密码工具
+    explicit constexpr StreamDecryptor(const TCryptor& cryptor) noexcept : cryptor(&cryptor) {}
+
+    /// @brief 丢弃暂存的数据，开始一条新消息，轮密钥不变
+    constexpr void reset() noexcept {
+        tail_size = 0;
+    }
+
+    /// @brief 传入 size 字节后 update 将写出的字节数，用于准备输出缓冲区
+    [[nodiscard]] constexpr std::size_t update_size(const std::size_t size) const noexcept {
+        const auto total = tail_size + size;
+        return total == 0 ? 0 : (total - 1) / 16 * 16;
+    }
+
+    /// @brief 解密一段数据，写出除最后一块以外所有已经凑齐的块
+    /// @param in 密文，任意长度
+    /// @param out 明文，至少 update_size(in.size()) 字节，不能与 in 重叠
+    /// @return 写入的字节数，数据全部暂存时为 0 ；out 不够大时不做任何处理并返回空
+    std::optional<std::size_t> update(std::span<const std::byte> in, std::span<std::byte> out) noexcept {
+        if (in.empty()) return 0;
+        if (tail_size + in.size() <= 16) {
+            std::memcpy(tail.data() + tail_size, in.data(), in.size());
+            tail_size += in.size();
+            return 0;
+        }
+        const auto total = update_size(in.size());
+        if (out.size() < total) return std::nullopt;
+
+        if (tail_size != 0) {
+            const auto n = 16 - tail_size;
+            std::memcpy(tail.data() + tail_size, in.data(), n);
+            cryptor->decrypt(tail);
+            std::memcpy(out.data(), tail.data(), 16);
+            in = in.subspan(n);
+            out = out.subspan(16);
+        }
+        // 保留 1 到 16 字节，in 此时一定不为空
+        const auto whole = (in.size() - 1) / 16 * 16;
+        cryptor->decrypt_blocks(in.first(whole), out);
+        tail_size = in.size() - whole;
+        std::memcpy(tail.data(), in.data() + whole, tail_size);
+        return total;
+    }
+
+    /// @brief 解密最后一块并去掉填充，填充以常数时间检查，之后可以开始新消息
+    /// @param out 至少 15 字节，或至少为去掉填充后的长度
+    /// @return 写入的字节数；总长度不是 16 的正整数倍、填充无效或 out 不够大时返回空
+    /// @note 向对端暴露填充是否有效会构成填充预言攻击，应与消息认证一起使用
+    std::optional<std::size_t> finalize(const std::span<std::byte> out) noexcept {
+        const auto complete = tail_size == 16;
+        reset();
+        if (!complete) return std::nullopt;
+        cryptor->decrypt(tail);
+        const auto pad = details::pkcs7_padding_length(tail.data());
+        if (pad == 0 || out.size() < 16 - pad) return std::nullopt;
+        std::memcpy(out.data(), tail.data(), 16 - pad);
+        return 16 - pad;
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_STREAM
@@ -0,0 +1,220 @@
+#ifndef INCLUDE_CANGO_AES_XTS
+#define INCLUDE_CANGO_AES_XTS
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "cryptor.hpp"
+#include "details/parallel.hpp"
+#include "details/tweak.hpp"
+#include "details/word.hpp"
+#include "executor.hpp"
+
+namespace cango::aes {
+
+/// @brief XTS 模式(IEEE 1619)，用于按扇区加密的存储设备
+/// @details 每个扇区的初始调整值由扇区号加密一次得到，之后每块乘以 α 。
+/// 一个扇区内按 8 块一批生成调整值，异或后走多块接口；长度不是 16 的倍数时使用密文挪用。
+/// 多个扇区互不依赖，可以一次传入一批扇区并分给多个线程。
+/// @tparam TCryptor 密码工具类型，需要提供 encrypt_blocks, decrypt_blocks ，对象的生命周期必须长于本对象
+template<typename TCryptor>
+class XtsCryptor {
+    /// @brief 每批处理的块数
+    static constexpr std::size_t batch_blocks = 8;
+
+    /// @brief 多线程时每个线程至少处理的字节数
+    static constexpr std::size_t min_bytes_per_thread = 256 * 1024;
+
+    /// @brief 加密数据的密钥，即 Key1
+    const TCryptor* data_cryptor;
+
+    /// @brief 加密扇区号的密钥，即 Key2
+    const TCryptor* tweak_cryptor;
+
+public:
+    /// @param dataCryptor 由 XTS 密钥前半部分初始化的密码工具
+    /// @param tweakCryptor 由 XTS 密钥后半部分初始化的密码工具，应与 dataCryptor 的密钥不同
+    constexpr XtsCryptor(const TCryptor& dataCryptor, const TCryptor& tweakCryptor) noexcept
+        : data_cryptor(&dataCryptor), tweak_cryptor(&tweakCryptor) {}
+
+    /// @brief 扇区的初始调整值，即扇区号按小端序写成 16 字节后用 Key2 加密
+    [[nodiscard]] block_t tweak_of(const std::uint64_t sector) const noexcept {
+        block_t tweak{};
+        details::store_u64le(tweak.data(), sector);
+        tweak_cryptor->encrypt(tweak);
+        return tweak;
+    }
+
+    /// @brief 加密一个扇区
+    /// @param sector 扇区号
+    /// @param in 扇区明文，长度至少 16 字节，可以不是 16 的倍数
+    /// @param out 扇区密文，至少与 in 一样长，可以与 in 是同一段内存，否则两者不能重叠
+    /// @return 长度不足 16 字节或 out 太小时返回 false ，不做任何处理
+    bool encrypt_sector(const std::uint64_t sector, const std::span<const std::byte> in, const std::span<std::byte> out) const noexcept {
+        if (in.size() < 16 || out.size() < in.size()) return false;
+        process_sector<true>(sector, in.data(), out.data(), in.size());
+        return true;
+    }
+
+    /// @brief 原地加密一个扇区
+    bool encrypt_sector(const std::uint64_t sector, const std::span<std::byte> data) const noexcept {
+        return encrypt_sector(sector, data, data);
+    }
+
+    /// @brief 解密一个扇区，参数与 encrypt_sector 相同
+    bool decrypt_sector(const std::uint64_t sector, const std::span<const std::byte> in, const std::span<std::byte> out) const noexcept {
+        if (in.size() < 16 || out.size() < in.size()) return false;
+        process_sector<false>(sector, in.data(), out.data(), in.size());
+        return true;
+    }
+
+    /// @brief 原地解密一个扇区
+    bool decrypt_sector(const std::uint64_t sector, const std::span<std::byte> data) const noexcept {
+        return decrypt_sector(sector, data, data);
+    }
+
+    /// @brief 加密一批连续存放的扇区，扇区号任意
+    /// @param sectors 每个扇区的扇区号
+    /// @param in 明文，第 i 个扇区位于 [i * sectorSize, (i + 1) * sectorSize)
+    /// @param out 密文，可以与 in 是同一段内存，否则两者不能重叠
+    /// @param sectorSize 扇区字节数，至少 16
+    /// @param threads 线程数，为 0 时使用硬件并发数；数据较少时自动减少线程数
+    /// @return 处理的扇区数，即 sectors 与 in, out 所能容纳的扇区数中的最小值
+    std::size_t encrypt_sectors(const std::span<const std::uint64_t> sectors, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, const std::size_t threads = 0) const {
+        return process_sectors<true>([sectors](const std::size_t i) { return sectors[i]; }, sectors.size(), in, out, sectorSize, threads);
+    }
+
+    /// @brief 加密一批扇区号连续的扇区，第 i 个扇区的扇区号为 firstSector + i
+    std::size_t encrypt_sectors(const std::uint64_t firstSector, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, const std::size_t threads = 0) const {
+        return process_sectors<true>([firstSector](const std::size_t i) { return firstSector + i; }, SIZE_MAX, in, out, sectorSize, threads);
+    }
+
+    /// @brief 解密一批连续存放的扇区，参数与 encrypt_sectors 相同
+    std::size_t decrypt_sectors(const std::span<const std::uint64_t> sectors, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, const std::size_t threads = 0) const {
+        return process_sectors<false>([sectors](const std::size_t i) { return sectors[i]; }, sectors.size(), in, out, sectorSize, threads);
+    }
+
+    /// @brief 解密一批扇区号连续的扇区
+    std::size_t decrypt_sectors(const std::uint64_t firstSector, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, const std::size_t threads = 0) const {
+        return process_sectors<false>([firstSector](const std::size_t i) { return firstSector + i; }, SIZE_MAX, in, out, sectorSize, threads);
+    }
+
+    /// @brief 与 encrypt_sectors 相同，但交给线程池处理
+    std::size_t encrypt_sectors(const std::span<const std::uint64_t> sectors, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, Executor& executor) const {
+        return process_sectors<true>([sectors](const std::size_t i) { return sectors[i]; }, sectors.size(), in, out, sectorSize, executor);
+    }
+
+    /// @brief 与 encrypt_sectors 相同，但交给线程池处理
+    std::size_t encrypt_sectors(const std::uint64_t firstSector, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, Executor& executor) const {
+        return process_sectors<true>([firstSector](const std::size_t i) { return firstSector + i; }, SIZE_MAX, in, out, sectorSize, executor);
+    }
+
+    /// @brief 与 decrypt_sectors 相同，但交给线程池处理
+    std::size_t decrypt_sectors(const std::span<const std::uint64_t> sectors, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, Executor& executor) const {
+        return process_sectors<false>([sectors](const std::size_t i) { return sectors[i]; }, sectors.size(), in, out, sectorSize, executor);
+    }
+
+    /// @brief 与 decrypt_sectors 相同，但交给线程池处理
+    std::size_t decrypt_sectors(const std::uint64_t firstSector, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, Executor& executor) const {
+        return process_sectors<false>([firstSector](const std::size_t i) { return firstSector + i; }, SIZE_MAX, in, out, sectorSize, executor);
+    }
+
+private:
+    template<bool Encrypt, typename TSectorAt>
+    std::size_t process_sectors(const TSectorAt& sectorAt, const std::size_t limit, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, const std::size_t threads) const {
+        if (sectorSize < 16) return 0;
+        const auto count = std::min(limit, std::min(in.size(), out.size()) / sectorSize);
+        const auto plan = details::plan_chunks(count, threads, std::max<std::size_t>(min_bytes_per_thread / sectorSize, 1));
+        details::run_chunks(plan, count, sector_range<Encrypt>(sectorAt, in, out, sectorSize));
+        return count;
+    }
+
+    template<bool Encrypt, typename TSectorAt>
+    std::size_t process_sectors(const TSectorAt& sectorAt, const std::size_t limit, const std::span<const std::byte> in, const std::span<std::byte> out,
+                                const std::size_t sectorSize, Executor& executor) const {
+        if (sectorSize < 16) return 0;
+        const auto count = std::min(limit, std::min(in.size(), out.size()) / sectorSize);
+        executor.run(executor.plan(count, sectorSize), count, sector_range<Encrypt>(sectorAt, in, out, sectorSize));
+        return count;
+    }
+
+    /// @brief 处理一段扇区的函数对象
+    template<bool Encrypt, typename TSectorAt>
+    auto sector_range(const TSectorAt& sectorAt, const std::span<const std::byte> in, const std::span<std::byte> out, const std::size_t sectorSize) const {
+        return [this, &sectorAt, in, out, sectorSize](std::size_t, const std::size_t begin, const std::size_t n) {
+            for (auto i = begin; i < begin + n; ++i)
+                process_sector<Encrypt>(sectorAt(i), in.data() + i * sectorSize, out.data() + i * sectorSize, sectorSize);
+        };
+    }
+
+    template<bool Encrypt>
+    void process_sector(const std::uint64_t sector, const std::byte* in, std::byte* out, const std::size_t size) const noexcept {
+        auto tweak = tweak_of(sector);
+        const auto tail = size % 16;
+        // 有密文挪用时，最后一个完整块与不完整块一起处理
+        const auto bulk = size / 16 - (tail != 0);
+
+        alignas(16) std::array<std::uint8_t, 16 * batch_blocks> tweaks;
+        for (std::size_t i = 0; i < bulk;) {
+            const auto n = std::min(batch_blocks, bulk - i);
+            const std::span block_out{out + i * 16, n * 16};
+            details::fill_tweaks(tweak, tweaks.data(), n);
+            xor_bytes(in + i * 16, tweaks.data(), block_out.data(), n * 16);
+            if constexpr (Encrypt) data_cryptor->encrypt_blocks(block_out);
+            else data_cryptor->decrypt_blocks(block_out);
+            xor_bytes(block_out.data(), tweaks.data(), block_out.data(), n * 16);
+            i += n;
+        }
+        if (tail == 0) return;
+
+        // 密文挪用：加密时最后一个完整块用当前调整值、拼接块用下一个；解密时顺序相反
+        auto next = tweak;
+        details::multiply_alpha(next);
+        const auto last = out + bulk * 16;
+        block_t full{};
+        block_t stolen{};
+        std::memcpy(full.data(), in + bulk * 16, 16);
+        crypt_block<Encrypt>(full, Encrypt ? tweak : next);
+        std::memcpy(stolen.data(), in + bulk * 16 + 16, tail);
+        std::memcpy(stolen.data() + tail, full.data() + tail, 16 - tail);
+        std::memcpy(last + 16, full.data(), tail);
+        crypt_block<Encrypt>(stolen, Encrypt ? next : tweak);
+        std::memcpy(last, stolen.data(), 16);
+    }
+
+    template<bool Encrypt>
+    void crypt_block(block_t& block, const block_t& tweak) const noexcept {
+        for (std::size_t i = 0; i < 16; ++i) block[i] ^= tweak[i];
+        if constexpr (Encrypt) data_cryptor->encrypt(block);
+        else data_cryptor->decrypt(block);
+        for (std::size_t i = 0; i < 16; ++i) block[i] ^= tweak[i];
+    }
+
+    /// @brief out = in ^ tweaks ，每次 8 个字节
+    static void xor_bytes(const std::byte* in, const std::uint8_t* tweaks, std::byte* out, const std::size_t size) noexcept {
+        for (std::size_t i = 0; i < size; i += 8) {
+            std::uint64_t a, b;
+            std::memcpy(&a, in + i, 8);
+            std::memcpy(&b, tweaks + i, 8);
+            a ^= b;
+            std::memcpy(out + i, &a, 8);
+        }
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_AES_XTS
@@ -0,0 +1,70 @@
+#ifndef INCLUDE_CANGO_SHA_DETAILS_SHANI
+#define INCLUDE_CANGO_SHA_DETAILS_SHANI
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../aes/details/cpu.hpp"
+#include "constants.hpp"
+
+namespace cango::sha::details {
+
+#if CANGO_AES_X86
+namespace shani {
+
+/// @brief 当前 CPU 是否支持 SHA 扩展
+[[nodiscard]] inline bool available() noexcept {
+    const auto& features = aes::details::cpu_features();
+    return features.sha && features.sse41 && features.ssse3;
+}
+
+/// @brief 用 SHA256RNDS2, SHA256MSG1, SHA256MSG2 压缩 count 个块
+/// @details 状态按 SHA256RNDS2 的要求重排为 ABEF 和 CDGH 两个寄存器，整段数据处理完后再换回。
+/// 每 4 轮一组，消息调度与轮函数交错，4 个寄存器轮流保存最近的 16 个消息字。
+CANGO_AES_TARGET("sha,sse4.1,ssse3")
+inline void compress(std::uint32_t* state, const std::uint8_t* blocks, std::size_t count) noexcept {
+    const auto byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+    auto dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+    auto hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+    const auto cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    const auto efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for (; count > 0; --count, blocks += 64) {
+        const auto abef_saved = abef;
+        const auto cdgh_saved = cdgh;
+        __m128i w[4];
+        CANGO_AES_UNROLL
+        for (std::size_t g = 0; g < 16; ++g) {
+            if (g < 4) {
+                w[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * g)), byte_swap);
+            }
+            else {
+                // W[g] = σ1(W[g-1]) + W[g-7 字] + σ0(W[g-15 字]) + W[g-4]
+                auto next = _mm_sha256msg1_epu32(w[g % 4], w[(g + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(g + 3) % 4], w[(g + 2) % 4], 4));
+                w[g % 4] = _mm_sha256msg2_epu32(next, w[(g + 3) % 4]);
+            }
+            auto message = _mm_add_epi32(w[g % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(round_constants.data() + 4 * g)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+            message = _mm_shuffle_epi32(message, 0x0e);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+        }
+        abef = _mm_add_epi32(abef, abef_saved);
+        cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+}
+#endif
+
+}
+
+#endif//INCLUDE_CANGO_SHA_DETAILS_SHANI
@@ -0,0 +1,168 @@
+#ifndef INCLUDE_CANGO_SHA_FILE
+#define INCLUDE_CANGO_SHA_FILE
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "../aes/file.hpp"
+#include "merkle.hpp"
+
+namespace cango::sha {
+
+namespace details::merkle {
+
+/// @brief 读写回退路径中每个缓冲区的字节数，不足一个叶子时为一个叶子
+inline constexpr std::size_t stream_buffer_bytes = 8 * 1024 * 1024;
+
+/// @brief 定位到文件的 64 位偏移
+inline bool seek_to(std::FILE* file, const std::uint64_t offset) noexcept {
+#if CANGO_AES_MMAP
+    return ::fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#elif defined(_WIN32)
+    return ::_fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0;
+#endif
+}
+
+#if CANGO_AES_MMAP
+/// @brief 只读映射整个文件后以数据调用 func ，不是普通文件或映射失败时返回 false
+/// @param sequential 是否按顺序访问，否则提示内核随机访问
+template<typename TFunc>
+bool with_mapped_file(const std::filesystem::path& input, const bool sequential, const TFunc& func) {
+    const aes::details::Descriptor file{::open(input.c_str(), O_RDONLY)};
+    if (file.fd < 0) return false;
+    struct stat info{};
+    if (::fstat(file.fd, &info) != 0 || !S_ISREG(info.st_mode)) return false;
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (size == 0) {
+        func(std::span<const std::byte>{});
+        return true;
+    }
+    const aes::details::Mapping mapping{::mmap(nullptr, size, PROT_READ, MAP_SHARED, file.fd, 0), size};
+    if (mapping.address == MAP_FAILED) return false;
+    ::madvise(mapping.address, size, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    func(std::span{static_cast<const std::byte*>(mapping.address), size});
+    return true;
+}
+#endif
+
+/// @brief 读写回退路径：一个线程读下一段的同时，当前线程并行计算上一段的叶子
+inline aes::FileReport merkle_file_stream(const std::filesystem::path& input, MerkleTree& tree, const MerkleOptions& options) {
+    const aes::details::FileHandle in{std::fopen(input.string().c_str(), "rb")};
+    if (!in) return {0, false, aes::details::last_error()};
+
+    // 缓冲区是叶子的整数倍，只有文件末尾的叶子可能不满
+    const auto capacity = std::max<std::size_t>(stream_buffer_bytes / options.leaf_size, 1) * options.leaf_size;
+    const auto storage = std::make_unique<std::byte[]>(capacity * 2);
+    std::span<std::byte> buffers[2]{{storage.get(), capacity}, {storage.get() + capacity, capacity}};
+
+    std::vector<SHA256::digest_t> leaves;
+    std::uint64_t total = 0;
+    auto size = aes::details::read_full(in.get(), buffers[0].data(), capacity);
+    for (std::size_t current = 0; size != 0; current ^= 1) {
+        std::size_t next_size = 0;
+        {
+            const std::jthread reader{[&] { next_size = aes::details::read_full(in.get(), buffers[current ^ 1].data(), capacity); }};
+            const auto first = leaves.size();
+            leaves.resize(first + (size + options.leaf_size - 1) / options.leaf_size);
+            hash_leaves(buffers[current].first(size), std::span{leaves}.subspan(first), options);
+        }
+        total += size;
+        size = next_size;
+    }
+    if (std::ferror(in.get())) return {total, false, aes::details::last_error()};
+    if (leaves.empty()) leaves.push_back(hash_leaf({}));
+    tree = MerkleTree::from_leaves(std::move(leaves), options.leaf_size, total);
+    return {total, false, {}};
+}
+
+/// @brief 读出第 index 个叶子的数据
+inline bool read_leaf(std::FILE* file, const MerkleTree& tree, const std::size_t index, const std::span<std::byte> chunk) noexcept {
+    return seek_to(file, tree.leaf_offset(index)) && aes::details::read_full(file, chunk.data(), chunk.size()) == chunk.size();
+}
+
+}
+
+/// @brief 计算文件的树哈希
+/// @details 优先把文件映射到内存，叶子分给多个线程计算；输入不是普通文件(如管道)或无法映射时，
+/// 回退为一边读下一段、一边并行计算当前段的流水线。
+/// @param tree 输出，成功时为文件的树，可以序列化保存，供之后的增量更新和单块校验使用
+inline aes::FileReport merkle_file(const std::filesystem::path& input, MerkleTree& tree, const MerkleOptions& options = {}) {
+#if CANGO_AES_MMAP
+    if (options.allow_mmap) {
+        aes::FileReport report{};
+        const auto mapped = details::merkle::with_mapped_file(input, true, [&](const std::span<const std::byte> data) {
+            tree = MerkleTree::build(data, options);
+            report = {data.size(), true, {}};
+        });
+        if (mapped) return report;
+    }
+#endif
+    return details::merkle::merkle_file_stream(input, tree, options);
+}
+
+/// @brief 文件中部分叶子被修改后更新树，只读取被修改的叶子
+/// @param changed 被修改的叶子序号
+/// @return bytes 为重新读取的字节数，重复的序号只计一次；文件长度与树不同或序号越界时为 invalid_argument 错误，树不变
+inline aes::FileReport merkle_file_update(const std::filesystem::path& input, MerkleTree& tree, const std::span<const std::size_t> changed,
+                                          const MerkleOptions& options = {}) {
+    std::error_code error{};
+    const auto size = std::filesystem::file_size(input, error);
+    if (error) return {0, false, error};
+    const auto invalid = std::make_error_code(std::errc::invalid_argument);
+    if (size != tree.size()) return {0, false, invalid};
+
+    // 与 update_leaves 相同，先排序去重：重复的序号只读一次，读入的数据按在列表中的位置存放
+    std::vector<std::size_t> dirty(changed.begin(), changed.end());
+    std::ranges::sort(dirty);
+    dirty.erase(std::ranges::unique(dirty).begin(), dirty.end());
+    if (!dirty.empty() && dirty.back() >= tree.leaf_count()) return {0, false, invalid};
+
+    std::uint64_t bytes = 0;
+    for (const auto index: dirty) bytes += tree.leaf_length(index);
+#if CANGO_AES_MMAP
+    if (options.allow_mmap) {
+        bool updated = false;
+        const auto mapped = details::merkle::with_mapped_file(input, false, [&](const std::span<const std::byte> data) {
+            updated = tree.update(data, dirty, options);
+        });
+        if (mapped) return {updated ? bytes : 0, true, updated ? std::error_code{} : invalid};
+    }
+#endif
+
+    // 逐个读入被修改的叶子，再并行计算
+    const aes::details::FileHandle in{std::fopen(input.string().c_str(), "rb")};
+    if (!in) return {0, false, aes::details::last_error()};
+    const auto storage = std::make_unique<std::byte[]>(dirty.size() * tree.leaf_size());
+    for (std::size_t i = 0; i < dirty.size(); ++i) {
+        const std::span chunk{storage.get() + i * tree.leaf_size(), tree.leaf_length(dirty[i])};
+        if (!details::merkle::read_leaf(in.get(), tree, dirty[i], chunk)) return {0, false, aes::details::last_error()};
+    }
+    tree.update_leaves(dirty, options, [&](const std::size_t index) {
+        const auto i = static_cast<std::size_t>(std::ranges::lower_bound(dirty, index) - dirty.begin());
+        return std::span<const std::byte>{storage.get() + i * tree.leaf_size(), tree.leaf_length(index)};
+    });
+    return {bytes, false, {}};
+}
+
+/// @brief 只读取文件中的一个叶子并用树校验，文件无法读取时也返回 false
+[[nodiscard]] inline bool merkle_file_verify_leaf(const std::filesystem::path& input, const MerkleTree& tree, const std::size_t index) {
+    if (index >= tree.leaf_count()) return false;
+    const aes::details::FileHandle in{std::fopen(input.string().c_str(), "rb")};
+    if (!in) return false;
+    std::vector<std::byte> chunk(tree.leaf_length(index));
+    return details::merkle::read_leaf(in.get(), tree, index, chunk) && tree.verify_leaf(index, chunk);
+}
+
+}
+
+#endif//INCLUDE_CANGO_SHA_FILE
@@ -0,0 +1,216 @@
+#ifndef INCLUDE_CANGO_SHA_HMAC
+#define INCLUDE_CANGO_SHA_HMAC
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "../aes/details/tag.hpp"
+#include "sha256.hpp"
+
+namespace cango::sha {
+
+/// @brief HMAC-SHA256(RFC 2104)
+/// @details 构造时把 K ^ ipad 与 K ^ opad 各压缩一次，保存两个压缩后的中间状态；
+/// 之后每条消息只从中间状态的副本继续，只需压缩消息本身和结束时的两次压缩，不再处理密钥块。
+/// 所有操作都可以在编译期使用。
+class HmacSha256 {
+public:
+    /// @brief 标签字节数
+    static constexpr std::size_t tag_size = SHA256::digest_size;
+
+    /// @brief verify 接受的最短截断标签字节数，RFC 2104 第 5 节要求不短于输出的一半且不少于 80 位
+    static constexpr std::size_t min_tag_size = tag_size / 2;
+
+    using digest_t = SHA256::digest_t;
+
+private:
+    /// @brief 已吸收 K ^ ipad 的状态
+    SHA256 inner_keyed{};
+
+    /// @brief 已吸收 K ^ opad 的状态
+    SHA256 outer_keyed{};
+
+    /// @brief 当前消息的内层哈希
+    SHA256 inner{};
+
+public:
+    explicit constexpr HmacSha256(const std::span<const std::byte> key) noexcept {
+        set_key(key.data(), key.size());
+    }
+
+    explicit constexpr HmacSha256(const std::span<const std::uint8_t> key) noexcept {
+        set_key(key.data(), key.size());
+    }
+
+    explicit constexpr HmacSha256(const std::string_view key) noexcept {
+        set_key(key.data(), key.size());
+    }
+
+    /// @brief 丢弃已输入的数据，开始新的消息，密钥不变
+    constexpr void reset() noexcept {
+        inner = inner_keyed;
+    }
+
+    /// @brief 输入一段消息
+    constexpr void update(const std::span<const std::byte> data) noexcept {
+        inner.update(data);
+    }
+
+    constexpr void update(const std::span<const std::uint8_t> data) noexcept {
+        inner.update(data);
+    }
+
+    constexpr void update(const std::string_view data) noexcept {
+        inner.update(data);
+    }
+
+    /// @brief 输出标签，之后开始新的消息
+    [[nodiscard]] constexpr digest_t finalize() noexcept {
+        const auto tag = finish_outer(inner.finalize());
+        inner = inner_keyed;
+        return tag;
+    }
+
+    /// @brief 一次性计算一条消息的标签，不影响正在输入的消息
+    [[nodiscard]] constexpr digest_t mac(const std::span<const std::byte> message) const noexcept {
+        auto hasher = inner_keyed;
+        hasher.update(message);
+        return finish_outer(hasher.finalize());
+    }
+
+    [[nodiscard]] constexpr digest_t mac(const std::span<const std::uint8_t> message) const noexcept {
+        auto hasher = inner_keyed;
+        hasher.update(message);
+        return finish_outer(hasher.finalize());
+    }
+
+    [[nodiscard]] constexpr digest_t mac(const std::string_view message) const noexcept {
+        auto hasher = inner_keyed;
+        hasher.update(message);
+        return finish_outer(hasher.finalize());
+    }
+
+    /// @brief 以常数时间比较标签
+    /// @param tag 收到的标签，可以是截断的标签，长度为 16 到 32 字节
+    [[nodiscard]] constexpr bool verify(const std::span<const std::byte> message, const std::span<const std::byte> tag) const noexcept {
+        return aes::details::tag_equal(mac(message), tag, min_tag_size);
+    }
+
+    /// @brief 不保存密钥状态，一次性计算标签
+    [[nodiscard]] static constexpr digest_t compute(const std::span<const std::byte> key, const std::span<const std::byte> message) noexcept {
+        return HmacSha256{key}.mac(message);
+    }
+
+    [[nodiscard]] static constexpr digest_t compute(const std::string_view key, const std::string_view message) noexcept {
+        return HmacSha256{key}.mac(message);
+    }
+
+private:
+    /// @brief 长于一块的密钥先哈希，再与 ipad, opad 异或后各压缩一块
+    template<typename TByte> requires details::ByteLike<TByte>
+    constexpr void set_key(const TByte* key, const std::size_t size) noexcept {
+        std::array<std::uint8_t, SHA256::block_size> block{};
+        if (size > SHA256::block_size) {
+            SHA256 hasher{};
+            for (std::size_t offset = 0; offset < size; offset += block.size()) {
+                const auto n = std::min(block.size(), size - offset);
+                for (std::size_t i = 0; i < n; ++i) block[i] = static_cast<std::uint8_t>(key[offset + i]);
+                hasher.update(std::span{block}.first(n));
+            }
+            block = {};
+            const auto digest = hasher.finalize();
+            std::copy(digest.begin(), digest.end(), block.begin());
+        }
+        else {
+            for (std::size_t i = 0; i < size; ++i) block[i] = static_cast<std::uint8_t>(key[i]);
+        }
+
+        for (auto& byte: block) byte ^= 0x36;
+        inner_keyed.update(block);
+        for (auto& byte: block) byte ^= 0x36 ^ 0x5c;
+        outer_keyed.update(block);
+        inner = inner_keyed;
+    }
+
+    [[nodiscard]] constexpr digest_t finish_outer(const digest_t& inner_digest) const noexcept {
+        auto outer = outer_keyed;
+        outer.update(inner_digest);
+        return outer.finalize();
+    }
+};
+
+/// @brief HKDF-SHA256(RFC 5869)
+/// @details extract 得到伪随机密钥 PRK ；Hkdf 对象以 PRK 为 HMAC 密钥，构造时保存中间状态，
+/// 之后每次 expand 的每 32 字节输出只需内外各一到两次压缩。一个 PRK 派生大量会话密钥时使用 expand_many 。
+class Hkdf {
+public:
+    /// @brief 一次 expand 的最大输出字节数
+    static constexpr std::size_t max_output = 255 * SHA256::digest_size;
+
+    using digest_t = SHA256::digest_t;
+
+private:
+    HmacSha256 prk_mac;
+
+public:
+    /// @param prk extract 的结果，或已经足够随机的密钥
+    explicit constexpr Hkdf(const digest_t& prk) noexcept : prk_mac(std::span<const std::uint8_t>{prk}) {}
+
+    /// @brief 由输入密钥材料构造，即 Hkdf{extract(salt, ikm)}
+    [[nodiscard]] static constexpr Hkdf from_ikm(const std::span<const std::byte> salt, const std::span<const std::byte> ikm) noexcept {
+        return Hkdf{extract(salt, ikm)};
+    }
+
+    /// @brief PRK = HMAC(salt, IKM) ，空的 salt 等价于 32 个 0 字节
+    [[nodiscard]] static constexpr digest_t extract(const std::span<const std::byte> salt, const std::span<const std::byte> ikm) noexcept {
+        return HmacSha256{salt}.mac(ikm);
+    }
+
+    /// @brief 派生 out.size() 字节的密钥
+    /// @details T(i) = HMAC(PRK, T(i - 1) || info || i) ，输出为 T(1) || T(2) || ... 的前 out.size() 字节
+    /// @return out 超过 max_output 字节时返回 false ，不写入
+    constexpr bool expand(const std::span<const std::byte> info, const std::span<std::byte> out) const noexcept {
+        if (out.size() > max_output) return false;
+        digest_t block{};
+        for (std::size_t offset = 0, counter = 1; offset < out.size(); offset += block.size(), ++counter) {
+            auto hmac = prk_mac;
+            if (counter > 1) hmac.update(block);
+            hmac.update(info);
+            const std::uint8_t index[1]{static_cast<std::uint8_t>(counter)};
+            hmac.update(index);
+            block = hmac.finalize();
+            const auto n = std::min(block.size(), out.size() - offset);
+            for (std::size_t i = 0; i < n; ++i) out[offset + i] = static_cast<std::byte>(block[i]);
+        }
+        return true;
+    }
+
+    /// @brief 派生固定长度的密钥，如 Cryptor::reinit 使用的主钥
+    template<std::size_t NBytes> requires (NBytes <= max_output)
+    [[nodiscard]] constexpr std::array<std::uint8_t, NBytes> expand(const std::span<const std::byte> info) const noexcept {
+        std::array<std::byte, NBytes> bytes{};
+        expand(info, bytes);
+        std::array<std::uint8_t, NBytes> key{};
+        for (std::size_t i = 0; i < NBytes; ++i) key[i] = static_cast<std::uint8_t>(bytes[i]);
+        return key;
+    }
+
+    /// @brief 由同一个 PRK 为每个 info 派生一个 keyBytes 字节的密钥
+    /// @param out 输出，第 i 个密钥位于 [i * keyBytes, (i + 1) * keyBytes)
+    /// @return 派生的密钥数，即 min(infos.size(), out.size() / keyBytes) ；keyBytes 为 0 或超过 max_output 时为 0
+    constexpr std::size_t expand_many(const std::span<const std::span<const std::byte>> infos, const std::span<std::byte> out,
+                                      const std::size_t keyBytes) const noexcept {
+        if (keyBytes == 0 || keyBytes > max_output) return 0;
+        const auto count = std::min(infos.size(), out.size() / keyBytes);
+        for (std::size_t i = 0; i < count; ++i) expand(infos[i], out.subspan(i * keyBytes, keyBytes));
+        return count;
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_SHA_HMAC
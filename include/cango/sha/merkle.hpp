@@ -0,0 +1,277 @@
+#ifndef INCLUDE_CANGO_SHA_MERKLE
+#define INCLUDE_CANGO_SHA_MERKLE
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "../aes/details/word.hpp"
+#include "../aes/executor.hpp"
+#include "sha256.hpp"
+
+namespace cango::sha {
+
+/// @brief 树哈希的选项
+struct MerkleOptions {
+    /// @brief 叶子块的字节数，必须大于 0 ，最后一个叶子可能更短
+    std::size_t leaf_size = 1024 * 1024;
+
+    /// @brief 线程数，为 0 时使用硬件并发数
+    std::size_t threads = 0;
+
+    /// @brief 线程池，不为空时代替 threads 使用
+    aes::Executor* executor = nullptr;
+
+    /// @brief 处理文件时是否尝试内存映射，为 false 时总是使用读写回退路径
+    bool allow_mmap = true;
+};
+
+namespace details::merkle {
+
+/// @brief 叶子与内部节点使用不同的前缀，叶子摘要不能被当作内部节点，反之亦然
+inline constexpr std::uint8_t leaf_prefix = 0x00;
+inline constexpr std::uint8_t node_prefix = 0x01;
+
+/// @brief 每个线程至少处理的字节数
+inline constexpr std::size_t min_bytes_per_thread = 4 * 1024 * 1024;
+
+/// @brief SHA256(0x00 || chunk)
+[[nodiscard]] inline SHA256::digest_t hash_leaf(const std::span<const std::byte> chunk) noexcept {
+    SHA256 hasher{};
+    hasher.update(std::span{&leaf_prefix, 1});
+    hasher.update(chunk);
+    return hasher.finalize();
+}
+
+/// @brief SHA256(0x01 || left || right)
+[[nodiscard]] inline SHA256::digest_t hash_node(const SHA256::digest_t& left, const SHA256::digest_t& right) noexcept {
+    std::array<std::uint8_t, 1 + 2 * SHA256::digest_size> bytes{};
+    bytes[0] = node_prefix;
+    std::memcpy(bytes.data() + 1, left.data(), left.size());
+    std::memcpy(bytes.data() + 1 + left.size(), right.data(), right.size());
+    return SHA256::hash(bytes);
+}
+
+/// @brief 某一层第 index 个节点的父节点，没有兄弟的最后一个节点原样上移
+[[nodiscard]] inline SHA256::digest_t parent_of(const std::span<const SHA256::digest_t> level, const std::size_t index) noexcept {
+    const auto left = index & ~std::size_t{1};
+    return left + 1 < level.size() ? hash_node(level[left], level[left + 1]) : level[left];
+}
+
+/// @brief 把 units 个单位分段并行处理，与 aes::details::run_chunks 的约定相同
+template<typename TFunc>
+void run_parallel(const std::size_t units, const std::size_t unitBytes, const MerkleOptions& options, const TFunc& func) {
+    if (options.executor) {
+        options.executor->run(options.executor->plan(units, unitBytes), units, func);
+        return;
+    }
+    const auto min_units = std::max<std::size_t>(min_bytes_per_thread / std::max<std::size_t>(unitBytes, 1), 1);
+    aes::details::run_chunks(aes::details::plan_chunks(units, options.threads, min_units), units, func);
+}
+
+/// @brief 并行计算一段连续数据的叶子摘要，data 从某个叶子的起点开始
+/// @param digests 输出，大小应为 data 包含的叶子数
+inline void hash_leaves(const std::span<const std::byte> data, const std::span<SHA256::digest_t> digests, const MerkleOptions& options) {
+    const auto leaf_size = options.leaf_size;
+    run_parallel(digests.size(), leaf_size, options, [&](std::size_t, const std::size_t begin, const std::size_t n) {
+        for (auto i = begin; i < begin + n; ++i) {
+            const auto offset = std::min(i * leaf_size, data.size());
+            digests[i] = hash_leaf(data.subspan(offset, std::min(leaf_size, data.size() - offset)));
+        }
+    });
+}
+
+}
+
+/// @brief SHA-256 树哈希(Merkle 树)
+/// @details 数据按 leaf_size 切分为叶子，叶子摘要为 SHA256(0x00 || 块)，内部节点为 SHA256(0x01 || 左 || 右)，
+/// 某一层节点数为奇数时最后一个节点原样上移。叶子并行计算；保存了所有层的摘要，
+/// 只修改了部分叶子时只需重新计算这些叶子及其祖先，也可以只读一个块就校验它。
+/// 空数据视为一个空的叶子。
+class MerkleTree {
+public:
+    using digest_t = SHA256::digest_t;
+
+private:
+    std::size_t leaf_bytes = 0;
+    std::uint64_t total_bytes = 0;
+
+    /// @brief levels[0] 为叶子，levels.back() 只有根一个节点
+    std::vector<std::vector<digest_t>> levels;
+
+    /// @brief 序列化的头部：魔数、叶子字节数、数据字节数
+    static constexpr std::array<std::uint8_t, 4> magic{'C', 'M', 'R', 'K'};
+    static constexpr std::size_t header_size = 4 + 8 + 8;
+
+public:
+    MerkleTree() = default;
+
+    /// @brief 计算一段内存数据的树
+    [[nodiscard]] static MerkleTree build(const std::span<const std::byte> data, const MerkleOptions& options = {}) {
+        std::vector<digest_t> leaves(leaf_count_of(data.size(), options.leaf_size));
+        details::merkle::hash_leaves(data, leaves, options);
+        return from_leaves(std::move(leaves), options.leaf_size, data.size());
+    }
+
+    /// @brief 由已计算的叶子摘要构建内部节点，用于分段读入的数据
+    [[nodiscard]] static MerkleTree from_leaves(std::vector<digest_t> leaves, const std::size_t leafSize, const std::uint64_t totalBytes) {
+        MerkleTree tree{};
+        tree.leaf_bytes = leafSize;
+        tree.total_bytes = totalBytes;
+        tree.levels.push_back(std::move(leaves));
+        while (tree.levels.back().size() > 1) {
+            const auto& below = tree.levels.back();
+            std::vector<digest_t> level((below.size() + 1) / 2);
+            for (std::size_t i = 0; i < level.size(); ++i) level[i] = details::merkle::parent_of(below, 2 * i);
+            tree.levels.push_back(std::move(level));
+        }
+        return tree;
+    }
+
+    /// @brief 数据长度对应的叶子数，至少为 1
+    [[nodiscard]] static constexpr std::size_t leaf_count_of(const std::uint64_t totalBytes, const std::size_t leafSize) noexcept {
+        // 不使用 (totalBytes + leafSize - 1) / leafSize ，接近 2^64 的长度会溢出
+        return std::max<std::size_t>(static_cast<std::size_t>(totalBytes / leafSize + (totalBytes % leafSize != 0)), 1);
+    }
+
+    [[nodiscard]] std::size_t leaf_size() const noexcept {
+        return leaf_bytes;
+    }
+
+    /// @brief 数据的字节数
+    [[nodiscard]] std::uint64_t size() const noexcept {
+        return total_bytes;
+    }
+
+    [[nodiscard]] std::size_t leaf_count() const noexcept {
+        return levels.empty() ? 0 : levels.front().size();
+    }
+
+    /// @brief 第 index 个叶子在数据中的偏移
+    [[nodiscard]] std::uint64_t leaf_offset(const std::size_t index) const noexcept {
+        return static_cast<std::uint64_t>(index) * leaf_bytes;
+    }
+
+    /// @brief 第 index 个叶子的字节数
+    [[nodiscard]] std::size_t leaf_length(const std::size_t index) const noexcept {
+        const auto offset = std::min(leaf_offset(index), total_bytes);
+        return static_cast<std::size_t>(std::min<std::uint64_t>(leaf_bytes, total_bytes - offset));
+    }
+
+    /// @brief 层数，包括叶子和根
+    [[nodiscard]] std::size_t level_count() const noexcept {
+        return levels.size();
+    }
+
+    /// @brief 第 depth 层的所有节点，0 为叶子
+    [[nodiscard]] std::span<const digest_t> level(const std::size_t depth) const noexcept {
+        return levels[depth];
+    }
+
+    /// @brief 根摘要，空树时为全 0
+    [[nodiscard]] digest_t root() const noexcept {
+        return levels.empty() ? digest_t{} : levels.back().front();
+    }
+
+    /// @brief 数据中部分叶子被修改后，只重新计算这些叶子及其祖先
+    /// @param data 修改后的完整数据，长度必须与原数据相同
+    /// @param changed 被修改的叶子序号，可以无序、重复
+    /// @return 长度不同或序号越界时返回 false ，树不变
+    bool update(const std::span<const std::byte> data, const std::span<const std::size_t> changed, const MerkleOptions& options = {}) {
+        if (data.size() != total_bytes) return false;
+        return update_leaves(changed, options, [&](const std::size_t index) {
+            return data.subspan(static_cast<std::size_t>(leaf_offset(index)), leaf_length(index));
+        });
+    }
+
+    /// @brief 与 update 相同，但由 chunk_of(index) 提供被修改的叶子的数据，不需要完整数据
+    /// @details chunk_of 可能在多个线程上同时调用，返回的数据长度应为 leaf_length(index)
+    template<typename TChunkOf>
+    bool update_leaves(const std::span<const std::size_t> changed, const MerkleOptions& options, const TChunkOf& chunk_of) {
+        std::vector<std::size_t> dirty(changed.begin(), changed.end());
+        std::ranges::sort(dirty);
+        dirty.erase(std::ranges::unique(dirty).begin(), dirty.end());
+        if (dirty.empty()) return true;
+        if (dirty.back() >= leaf_count()) return false;
+
+        auto& leaves = levels.front();
+        details::merkle::run_parallel(dirty.size(), leaf_bytes, options, [&](std::size_t, const std::size_t begin, const std::size_t n) {
+            for (auto i = begin; i < begin + n; ++i) leaves[dirty[i]] = details::merkle::hash_leaf(chunk_of(dirty[i]));
+        });
+        for (std::size_t depth = 0; depth + 1 < levels.size(); ++depth) {
+            for (auto& index: dirty) index /= 2;
+            dirty.erase(std::ranges::unique(dirty).begin(), dirty.end());
+            for (const auto index: dirty) levels[depth + 1][index] = details::merkle::parent_of(levels[depth], 2 * index);
+        }
+        return true;
+    }
+
+    /// @brief 只用一个块校验：块的摘要与叶子相同，且从该叶子到根的每个节点都与其子节点一致
+    [[nodiscard]] bool verify_leaf(const std::size_t index, const std::span<const std::byte> chunk) const noexcept {
+        if (index >= leaf_count() || chunk.size() != leaf_length(index)) return false;
+        if (details::merkle::hash_leaf(chunk) != levels.front()[index]) return false;
+        auto position = index;
+        for (std::size_t depth = 0; depth + 1 < levels.size(); ++depth, position /= 2)
+            if (details::merkle::parent_of(levels[depth], position) != levels[depth + 1][position / 2]) return false;
+        return true;
+    }
+
+    /// @brief 序列化所有层，格式为头部后依次为各层的摘要(叶子在前)
+    [[nodiscard]] std::vector<std::byte> serialize() const {
+        std::vector<std::byte> bytes(header_size + node_count() * SHA256::digest_size);
+        auto* out = reinterpret_cast<std::uint8_t*>(bytes.data());
+        std::memcpy(out, magic.data(), magic.size());
+        aes::details::store_u64le(out + 4, leaf_bytes);
+        aes::details::store_u64le(out + 12, total_bytes);
+        out += header_size;
+        for (const auto& level: levels) {
+            std::memcpy(out, level.data(), level.size() * SHA256::digest_size);
+            out += level.size() * SHA256::digest_size;
+        }
+        return bytes;
+    }
+
+    /// @brief 读取 serialize 的结果，格式错误或各层之间不一致时返回空
+    [[nodiscard]] static std::optional<MerkleTree> deserialize(const std::span<const std::byte> bytes) {
+        if (bytes.size() < header_size) return std::nullopt;
+        const auto* in = reinterpret_cast<const std::uint8_t*>(bytes.data());
+        if (std::memcmp(in, magic.data(), magic.size()) != 0) return std::nullopt;
+        const auto leaf_size = aes::details::load_u64le(in + 4);
+        const auto total = aes::details::load_u64le(in + 12);
+        if (leaf_size == 0 || leaf_size > SIZE_MAX) return std::nullopt;
+        const auto leaves = total / leaf_size + (total % leaf_size != 0);
+        if (leaves > (bytes.size() - header_size) / SHA256::digest_size) return std::nullopt;
+
+        std::vector<digest_t> leaf_digests(std::max<std::size_t>(static_cast<std::size_t>(leaves), 1));
+        const auto leaf_bytes_total = leaf_digests.size() * SHA256::digest_size;
+        if (bytes.size() < header_size + leaf_bytes_total) return std::nullopt;
+        std::memcpy(leaf_digests.data(), in + header_size, leaf_bytes_total);
+
+        auto tree = from_leaves(std::move(leaf_digests), static_cast<std::size_t>(leaf_size), total);
+        if (bytes.size() != header_size + tree.node_count() * SHA256::digest_size) return std::nullopt;
+        // 内部节点由叶子重新计算，与保存的内部节点比较
+        in += header_size + leaf_bytes_total;
+        for (std::size_t depth = 1; depth < tree.levels.size(); ++depth) {
+            const auto& level = tree.levels[depth];
+            if (std::memcmp(in, level.data(), level.size() * SHA256::digest_size) != 0) return std::nullopt;
+            in += level.size() * SHA256::digest_size;
+        }
+        return tree;
+    }
+
+private:
+    [[nodiscard]] std::size_t node_count() const noexcept {
+        std::size_t nodes = 0;
+        for (const auto& level: levels) nodes += level.size();
+        return nodes;
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_SHA_MERKLE
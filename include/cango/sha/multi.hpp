@@ -0,0 +1,248 @@
+#ifndef INCLUDE_CANGO_SHA_MULTI
+#define INCLUDE_CANGO_SHA_MULTI
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "sha256.hpp"
+
+#if CANGO_AES_X86 && (defined(__GNUC__) || defined(__clang__))
+/// @brief 是否编译多缓冲 SIMD 实现，依赖编译器的向量扩展
+#define CANGO_SHA_MULTI_SIMD 1
+#else
+#define CANGO_SHA_MULTI_SIMD 0
+#endif
+
+namespace cango::sha {
+
+namespace details::multi {
+
+#if CANGO_SHA_MULTI_SIMD
+/// @brief NLanes 个 32 位通道的向量，第 i 个通道属于第 i 条消息
+template<std::size_t NLanes>
+using lanes_t [[gnu::vector_size(4 * NLanes)]] = std::uint32_t;
+
+/// @brief 向量的循环右移，写成宏以免在未开启 AVX 的函数签名中按值传递向量
+#define CANGO_SHA_ROTR(x, n) ((x) >> (n) | (x) << (32 - (n)))
+
+/// @brief 各通道同时压缩一个块
+/// @details 与 compress_portable 相同的轮函数，每个运算同时作用于所有通道；
+/// 状态按字转置存放，state[k * NLanes + i] 为第 i 个通道的第 k 个字。
+/// @param message 已转置并转为大端序的 16 个消息字，message[t] 的第 i 个通道为第 i 个块的第 t 个字
+template<std::size_t NLanes>
+[[gnu::always_inline]] inline void compress_lanes(std::uint32_t* state, const lanes_t<NLanes>* message) noexcept {
+    using V = lanes_t<NLanes>;
+    V s[8];
+    std::memcpy(s, state, sizeof(s));
+    auto a = s[0], b = s[1], c = s[2], d = s[3];
+    auto e = s[4], f = s[5], g = s[6], h = s[7];
+    V w[16];
+    _Pragma("GCC unroll 64")
+    for (std::size_t i = 0; i < 64; ++i) {
+        if (i < 16) {
+            w[i] = message[i];
+        }
+        else {
+            const auto w15 = w[(i - 15) % 16];
+            const auto w2 = w[(i - 2) % 16];
+            w[i % 16] += (CANGO_SHA_ROTR(w15, 7) ^ CANGO_SHA_ROTR(w15, 18) ^ w15 >> 3)
+                + (CANGO_SHA_ROTR(w2, 17) ^ CANGO_SHA_ROTR(w2, 19) ^ w2 >> 10)
+                + w[(i - 7) % 16];
+        }
+        const auto t1 = h + (CANGO_SHA_ROTR(e, 6) ^ CANGO_SHA_ROTR(e, 11) ^ CANGO_SHA_ROTR(e, 25)) + ((e & f) ^ (~e & g))
+            + round_constants[i] + w[i % 16];
+        const auto t2 = (CANGO_SHA_ROTR(a, 2) ^ CANGO_SHA_ROTR(a, 13) ^ CANGO_SHA_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+    std::memcpy(state, s, sizeof(s));
+}
+
+#undef CANGO_SHA_ROTR
+
+/// @brief 读入 8 个块并转置为 16 个消息字向量，每半块做一次 8x8 的 32 位转置，同时转为大端序
+CANGO_AES_TARGET("avx2")
+inline void load_message_avx2(__m256i* message, const std::uint8_t* const* blocks) noexcept {
+    const auto byte_swap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                           12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    CANGO_AES_UNROLL
+    for (std::size_t half = 0; half < 2; ++half) {
+        __m256i r[8];
+        CANGO_AES_UNROLL
+        for (std::size_t lane = 0; lane < 8; ++lane)
+            r[lane] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[lane] + 32 * half)), byte_swap);
+        __m256i t[8];
+        CANGO_AES_UNROLL
+        for (std::size_t i = 0; i < 4; ++i) {
+            t[2 * i] = _mm256_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+            t[2 * i + 1] = _mm256_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+        }
+        // u[j] 的低 128 位为 4 个通道的第 j 个字，高 128 位为第 j + 4 个字
+        __m256i u[8];
+        CANGO_AES_UNROLL
+        for (std::size_t i = 0; i < 2; ++i) {
+            u[4 * i + 0] = _mm256_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 1] = _mm256_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 2] = _mm256_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+            u[4 * i + 3] = _mm256_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+        }
+        CANGO_AES_UNROLL
+        for (std::size_t j = 0; j < 4; ++j) {
+            message[8 * half + j] = _mm256_permute2x128_si256(u[j], u[j + 4], 0x20);
+            message[8 * half + j + 4] = _mm256_permute2x128_si256(u[j], u[j + 4], 0x31);
+        }
+    }
+}
+
+/// @brief AVX2 ，8 个通道
+CANGO_AES_TARGET("avx2")
+inline void compress_avx2(std::uint32_t* state, const std::uint8_t* const* blocks) noexcept {
+    lanes_t<8> message[16];
+    load_message_avx2(reinterpret_cast<__m256i*>(message), blocks);
+    compress_lanes<8>(state, message);
+}
+
+/// @brief AVX-512 ，16 个通道，前后 8 个通道各自转置后拼接
+CANGO_AES_TARGET("avx512f")
+inline void compress_avx512(std::uint32_t* state, const std::uint8_t* const* blocks) noexcept {
+    __m256i low[16];
+    __m256i high[16];
+    load_message_avx2(low, blocks);
+    load_message_avx2(high, blocks + 8);
+    lanes_t<16> message[16];
+    for (std::size_t t = 0; t < 16; ++t) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(message + t), low[t]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(message + t) + 1, high[t]);
+    }
+    compress_lanes<16>(state, message);
+}
+#endif
+
+/// @brief 一个通道当前处理的消息
+struct Lane {
+    /// @brief 消息序号，空闲时为 SIZE_MAX
+    std::size_t message = SIZE_MAX;
+
+    /// @brief 消息中尚未压缩的完整块
+    const std::uint8_t* data = nullptr;
+    std::size_t whole_blocks = 0;
+
+    /// @brief 消息的尾部及填充，1 或 2 块
+    std::array<std::uint8_t, 128> tail{};
+    std::size_t tail_blocks = 0;
+    std::size_t tail_index = 0;
+
+    /// @brief 开始处理一条消息，预先写好尾部的填充
+    void start(const std::size_t index, const std::span<const std::byte> bytes) noexcept {
+        message = index;
+        data = reinterpret_cast<const std::uint8_t*>(bytes.data());
+        whole_blocks = bytes.size() / 64;
+        const auto rest = bytes.size() % 64;
+        tail_blocks = rest + 9 > 64 ? 2 : 1;
+        tail_index = 0;
+        std::fill(tail.begin(), tail.begin() + static_cast<std::ptrdiff_t>(64 * tail_blocks), 0);
+        if (rest != 0) std::memcpy(tail.data(), data + whole_blocks * 64, rest);
+        tail[rest] = 0x80;
+        const auto bits = static_cast<std::uint64_t>(bytes.size()) * 8;
+        for (std::size_t i = 0; i < 8; ++i) tail[64 * tail_blocks - 1 - i] = static_cast<std::uint8_t>(bits >> (8 * i));
+    }
+
+    /// @brief 取下一个要压缩的块
+    const std::uint8_t* next_block() noexcept {
+        if (whole_blocks != 0) {
+            --whole_blocks;
+            const auto block = data;
+            data += 64;
+            return block;
+        }
+        return tail.data() + 64 * tail_index++;
+    }
+
+    [[nodiscard]] bool finished() const noexcept {
+        return whole_blocks == 0 && tail_index == tail_blocks;
+    }
+};
+
+/// @brief 多通道调度：每一步各通道压缩自己消息的一个块，某条消息结束后立刻换入下一条
+template<std::size_t NLanes, typename TCompress>
+void hash_lanes(const std::span<const std::span<const std::byte>> messages, const std::span<SHA256::digest_t> digests, const TCompress& compress) noexcept {
+    static constexpr std::array<std::uint8_t, 64> idle_block{};
+    alignas(64) std::array<std::uint32_t, 8 * NLanes> state{};
+    std::array<Lane, NLanes> lanes{};
+    std::array<const std::uint8_t*, NLanes> blocks{};
+    std::size_t next = 0;
+    std::size_t active = 0;
+
+    const auto refill = [&](const std::size_t lane) {
+        if (next == messages.size()) {
+            lanes[lane].message = SIZE_MAX;
+            return;
+        }
+        lanes[lane].start(next, messages[next]);
+        ++next;
+        ++active;
+        for (std::size_t k = 0; k < 8; ++k) state[k * NLanes + lane] = initial_state[k];
+    };
+    for (std::size_t lane = 0; lane < NLanes; ++lane) refill(lane);
+
+    while (active != 0) {
+        for (std::size_t lane = 0; lane < NLanes; ++lane)
+            blocks[lane] = lanes[lane].message == SIZE_MAX ? idle_block.data() : lanes[lane].next_block();
+        compress(state.data(), blocks.data());
+        for (std::size_t lane = 0; lane < NLanes; ++lane) {
+            if (lanes[lane].message == SIZE_MAX || !lanes[lane].finished()) continue;
+            auto& digest = digests[lanes[lane].message];
+            for (std::size_t k = 0; k < 8; ++k)
+                for (std::size_t j = 0; j < 4; ++j) digest[4 * k + j] = static_cast<std::uint8_t>(state[k * NLanes + lane] >> (24 - 8 * j));
+            --active;
+            refill(lane);
+        }
+    }
+}
+
+}
+
+/// @brief 计算一批独立消息的 SHA-256 摘要
+/// @details 支持 AVX-512 时 16 条消息同时在向量的各通道中压缩，某条消息结束后由下一条消息补上对应的通道；
+/// 否则支持 SHA 扩展时逐条用 SHA 扩展计算(比 8 通道的 AVX2 更快)，再否则用 AVX2 的 8 个通道，
+/// 都不支持时逐条计算。不分配内存。适合大量较短的消息，单条长消息直接用 SHA256 即可。
+/// @param messages 消息列表
+/// @param digests 输出，第 i 个摘要对应第 i 条消息
+/// @return 计算的摘要数，即 min(messages.size(), digests.size())
+inline std::size_t sha256_many(std::span<const std::span<const std::byte>> messages, const std::span<SHA256::digest_t> digests) noexcept {
+    messages = messages.first(std::min(messages.size(), digests.size()));
+#if CANGO_SHA_MULTI_SIMD
+    const auto& features = aes::details::cpu_features();
+    if (messages.size() > 1 && features.avx512f) {
+        details::multi::hash_lanes<16>(messages, digests, details::multi::compress_avx512);
+        return messages.size();
+    }
+    if (messages.size() > 1 && features.avx2 && !details::shani::available()) {
+        details::multi::hash_lanes<8>(messages, digests, details::multi::compress_avx2);
+        return messages.size();
+    }
+#endif
+    for (std::size_t i = 0; i < messages.size(); ++i) digests[i] = SHA256::hash(messages[i]);
+    return messages.size();
+}
+}
+
+#endif//INCLUDE_CANGO_SHA_MULTI
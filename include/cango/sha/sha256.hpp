@@ -0,0 +1,212 @@
+#ifndef INCLUDE_CANGO_SHA_SHA256
+#define INCLUDE_CANGO_SHA_SHA256
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "details/constants.hpp"
+#include "details/shani.hpp"
+
+namespace cango::sha {
+
+namespace details {
+
+/// @brief 可以作为哈希输入的单字节类型
+template<typename T>
+concept ByteLike = std::is_same_v<T, std::byte> || std::is_same_v<T, std::uint8_t> || std::is_same_v<T, char>;
+
+[[nodiscard]] constexpr std::uint32_t load_u32be(const std::uint8_t* bytes) noexcept {
+    return static_cast<std::uint32_t>(bytes[0]) << 24
+        | static_cast<std::uint32_t>(bytes[1]) << 16
+        | static_cast<std::uint32_t>(bytes[2]) << 8
+        | static_cast<std::uint32_t>(bytes[3]);
+}
+
+/// @brief 可移植实现，可在编译期使用
+/// @details 消息调度只保留 16 个字的滑动窗口，64 轮完全展开，8 个工作变量在寄存器中轮换，不需要逐轮搬移。
+constexpr void compress_portable(std::array<std::uint32_t, 8>& state, const std::uint8_t* blocks, std::size_t count) noexcept {
+    for (; count > 0; --count, blocks += 64) {
+        std::uint32_t w[16]{};
+        auto a = state[0], b = state[1], c = state[2], d = state[3];
+        auto e = state[4], f = state[5], g = state[6], h = state[7];
+#if defined(__GNUC__) || defined(__clang__)
+        _Pragma("GCC unroll 64")
+#endif
+        for (std::size_t i = 0; i < 64; ++i) {
+            if (i < 16) {
+                w[i] = load_u32be(blocks + 4 * i);
+            }
+            else {
+                const auto w15 = w[(i - 15) % 16];
+                const auto w2 = w[(i - 2) % 16];
+                w[i % 16] += (std::rotr(w15, 7) ^ std::rotr(w15, 18) ^ w15 >> 3)
+                    + (std::rotr(w2, 17) ^ std::rotr(w2, 19) ^ w2 >> 10)
+                    + w[(i - 7) % 16];
+            }
+            const auto t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g))
+                + round_constants[i] + w[i % 16];
+            const auto t2 = (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+/// @brief 压缩 count 个完整块，运行时在支持的 CPU 上使用 SHA 扩展指令
+constexpr void compress(std::array<std::uint32_t, 8>& state, const std::uint8_t* blocks, const std::size_t count) noexcept {
+#if CANGO_AES_X86
+    if (!std::is_constant_evaluated() && shani::available()) {
+        shani::compress(state.data(), blocks, count);
+        return;
+    }
+#endif
+    compress_portable(state, blocks, count);
+}
+
+}
+
+/// @brief SHA-256 哈希(FIPS 180-4)
+/// @details 依次调用 update(可多次，任意长度) 和 finalize ；不足一块的数据暂存在对象内的 64 字节缓冲区中，
+/// 调用方缓冲区中的完整块直接压缩，不复制。所有操作都可以在编译期使用。
+class SHA256 {
+public:
+    /// @brief 块字节数
+    static constexpr std::size_t block_size = 64;
+
+    /// @brief 摘要字节数
+    static constexpr std::size_t digest_size = 32;
+
+    using digest_t = std::array<std::uint8_t, digest_size>;
+
+private:
+    std::array<std::uint32_t, 8> state = details::initial_state;
+
+    /// @brief 不足一块的待压缩数据
+    std::array<std::uint8_t, block_size> buffer{};
+    std::size_t buffer_size = 0;
+
+    std::uint64_t total_bytes = 0;
+
+public:
+    constexpr SHA256() noexcept = default;
+
+    /// @brief 丢弃已输入的数据，开始计算新的哈希
+    constexpr void reset() noexcept {
+        state = details::initial_state;
+        buffer_size = 0;
+        total_bytes = 0;
+    }
+
+    /// @brief 输入一段数据
+    constexpr void update(const std::span<const std::byte> data) noexcept {
+        absorb(data.data(), data.size());
+    }
+
+    constexpr void update(const std::span<const std::uint8_t> data) noexcept {
+        absorb(data.data(), data.size());
+    }
+
+    constexpr void update(const std::string_view data) noexcept {
+        absorb(data.data(), data.size());
+    }
+
+    /// @brief 填充并输出摘要，之后对象回到初始状态
+    [[nodiscard]] constexpr digest_t finalize() noexcept {
+        const auto bits = total_bytes * 8;
+        buffer[buffer_size++] = 0x80;
+        if (buffer_size > block_size - 8) {
+            std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(buffer_size), buffer.end(), 0);
+            details::compress(state, buffer.data(), 1);
+            buffer_size = 0;
+        }
+        std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(buffer_size), buffer.end() - 8, 0);
+        for (std::size_t i = 0; i < 8; ++i) buffer[block_size - 1 - i] = static_cast<std::uint8_t>(bits >> (8 * i));
+        details::compress(state, buffer.data(), 1);
+
+        digest_t digest{};
+        for (std::size_t i = 0; i < 8; ++i)
+            for (std::size_t j = 0; j < 4; ++j) digest[4 * i + j] = static_cast<std::uint8_t>(state[i] >> (24 - 8 * j));
+        reset();
+        return digest;
+    }
+
+    /// @brief 一次性计算摘要
+    [[nodiscard]] static constexpr digest_t hash(const std::span<const std::byte> data) noexcept {
+        SHA256 hasher{};
+        hasher.update(data);
+        return hasher.finalize();
+    }
+
+    [[nodiscard]] static constexpr digest_t hash(const std::span<const std::uint8_t> data) noexcept {
+        SHA256 hasher{};
+        hasher.update(data);
+        return hasher.finalize();
+    }
+
+    [[nodiscard]] static constexpr digest_t hash(const std::string_view data) noexcept {
+        SHA256 hasher{};
+        hasher.update(data);
+        return hasher.finalize();
+    }
+
+private:
+    template<typename TByte> requires details::ByteLike<TByte>
+    constexpr void absorb(const TByte* data, std::size_t size) noexcept {
+        total_bytes += size;
+        if (buffer_size != 0) {
+            const auto n = std::min(block_size - buffer_size, size);
+            copy_to_buffer(data, n);
+            data += n;
+            size -= n;
+            if (buffer_size < block_size) return;
+            details::compress(state, buffer.data(), 1);
+            buffer_size = 0;
+        }
+
+        const auto blocks = size / block_size;
+        if (std::is_constant_evaluated()) {
+            // 编译期不能重新解释指针，逐块复制到缓冲区
+            for (std::size_t i = 0; i < blocks; ++i) {
+                copy_to_buffer(data + i * block_size, block_size);
+                details::compress(state, buffer.data(), 1);
+                buffer_size = 0;
+            }
+        }
+        else if (blocks != 0) {
+            details::compress(state, reinterpret_cast<const std::uint8_t*>(data), blocks);
+        }
+        data += blocks * block_size;
+        size -= blocks * block_size;
+        copy_to_buffer(data, size);
+    }
+
+    template<typename TByte>
+    constexpr void copy_to_buffer(const TByte* data, const std::size_t size) noexcept {
+        for (std::size_t i = 0; i < size; ++i) buffer[buffer_size + i] = static_cast<std::uint8_t>(data[i]);
+        buffer_size += size;
+    }
+};
+
+}
+
+#endif//INCLUDE_CANGO_SHA_SHA256
@@ -1,2 +1,4 @@
 #include <cango/aes.hpp>
+#include <cango/aes/file.hpp>
 #include <cango/sha.hpp>
+#include <cango/sha/file.hpp>
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <cango/aes.hpp>
+
+#include "toolbox.hpp"
+
+using namespace cango::aes;
+using namespace cango::aes::details;
+
+/// @brief RFC 4493 第 4 节的测试向量，消息为同一段数据的前 0, 16, 40, 64 字节
+constexpr std::string_view cmac_key = "2b7e151628aed2a6abf7158809cf4f3c";
+constexpr std::string_view cmac_message =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+constexpr std::array<std::pair<std::size_t, std::string_view>, 4> cmac_vectors{{
+    {0, "bb1d6929e95937287fa37d129b756746"},
+    {16, "070a16b46b4d4144f79bdd9dd04a287c"},
+    {40, "dfa66747de9ae63030ca32611497c827"},
+    {64, "51f0bebf7e3b9d92fc49741779363cfe"},
+}};
+
+// RFC 4493 第 4 节：L = E(0) ，K1 = L·x ，K2 = K1·x
+constexpr block_t cmac_l{0x7d, 0xf7, 0x6b, 0x0c, 0x1a, 0xb8, 0x99, 0xb3, 0x3e, 0x42, 0xf0, 0x47, 0xb9, 0x1b, 0x54, 0x6f};
+constexpr block_t cmac_k1{0xfb, 0xee, 0xd6, 0x18, 0x35, 0x71, 0x33, 0x66, 0x7c, 0x85, 0xe0, 0x8f, 0x72, 0x36, 0xa8, 0xde};
+constexpr block_t cmac_k2{0xf7, 0xdd, 0xac, 0x30, 0x6a, 0xe2, 0x66, 0xcc, 0xf9, 0x0b, 0xc1, 0x1e, 0xe4, 0x6d, 0x51, 0x3b};
+static_assert(xtime_block(cmac_l) == cmac_k1, "failed: " "xtime_block(cmac_l) == cmac_k1");
+static_assert(xtime_block(cmac_k1) == cmac_k2, "failed: " "xtime_block(cmac_k1) == cmac_k2");
+
+bool test_cmac_vectors() {
+    const auto key_bytes = hex_to_bytes(cmac_key);
+    std::array<std::uint8_t, 16> key{};
+    std::memcpy(key.data(), key_bytes.data(), key.size());
+    const AES128Cryptor cryptor{key};
+    CmacCryptor<AES128Cryptor> cmac{cryptor};
+
+    const auto message = hex_to_bytes(cmac_message);
+    for (const auto& [size, expected]: cmac_vectors) {
+        const auto data = std::span{message}.first(size);
+        const auto expected_tag = hex_to_bytes(expected);
+        const auto tag = cmac.compute(data);
+        if (!std::equal(tag.begin(), tag.end(), expected_tag.begin(), [](auto a, auto b) { return static_cast<std::byte>(a) == b; })) {
+            std::println(std::cerr, "[cmac-{}] 标签与测试向量不符({})", size, bytes_to_string(tag));
+            return false;
+        }
+        cmac.start();
+        cmac.update(data);
+        if (!cmac.verify(expected_tag)) {
+            std::println(std::cerr, "[cmac-{}] 增量计算的标签验证失败", size);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 任意切分的增量计算和批量计算都应与单条计算相同
+bool test_cmac_batch() {
+    std::uint32_t seed = 0x6c3e'0003;
+    std::array<std::uint8_t, 32> key{};
+    fill_pseudo_random(key, seed);
+    const AES256Cryptor cryptor{key};
+    CmacCryptor<AES256Cryptor> cmac{cryptor};
+
+    // 长度覆盖空消息、整块和非整块，使各条消息在不同的步骤结束
+    std::vector<std::vector<std::byte>> messages;
+    for (std::size_t size = 0; size < 100; size += size % 7 + 1) {
+        messages.emplace_back(size);
+        fill_pseudo_random(messages.back(), seed);
+    }
+    std::vector<CmacMessage> batch;
+    for (const auto& message: messages) batch.push_back({message, {}});
+    cmac.compute_many(batch);
+
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        const auto& message = messages[i];
+        const auto expected = cmac.compute(message);
+        cmac.start();
+        for (std::size_t offset = 0, step = 1; offset < message.size(); offset += step, step = step * 3 % 19 + 1)
+            cmac.update(std::span{message}.subspan(offset, std::min(step, message.size() - offset)));
+        if (cmac.finish() != expected || batch[i].tag != expected) {
+            std::println(std::cerr, "[cmac] {} 字节消息的增量或批量结果与单条计算不符", message.size());
+            return false;
+        }
+    }
+
+    const auto tag = cmac.compute(messages.back());
+    auto tampered = messages.back();
+    tampered[3] ^= std::byte{1};
+    cmac.start();
+    cmac.update(tampered);
+    if (cmac.verify(std::as_bytes(std::span{tag}))) {
+        std::println(std::cerr, "[cmac] 篡改后的消息通过了验证");
+        return false;
+    }
+
+    // 截断标签不能短于 8 字节
+    const auto tag_bytes = std::as_bytes(std::span{tag});
+    const auto verify = [&](const std::size_t size) {
+        cmac.start();
+        cmac.update(messages.back());
+        return cmac.verify(tag_bytes.first(size));
+    };
+    for (std::size_t size = 0; size <= 16; ++size) {
+        if (verify(size) != (size >= 8)) {
+            std::println(std::cerr, "[cmac] {} 字节的标签验证结果不正确", size);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    toolbox tb{true};
+    tb.execute("cmac vectors", test_cmac_vectors);
+    tb.execute("cmac batch", test_cmac_batch);
+    tb.summary();
+    return tb.failed > 0 ? 1 : 0;
+}
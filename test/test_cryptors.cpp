@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cstring>
 #include <span>
+#include <thread>
+#include <vector>
 
 #include <cango/aes.hpp>
 #include <cassert>
@@ -43,6 +47,325 @@ bool test_cryptor(const std::string_view name, const auto &plainText, const auto
     return true;
 }
 
+/// @brief 用伪随机主钥和数据比较两种实现，要求结果逐位相同
+template<typename TExpected, typename TActual, std::size_t NKeyBytes>
+bool test_same_as_reference(const std::string_view name) {
+    std::uint32_t seed = 0x2024'0601;
+    for (int i = 0; i < 256; ++i) {
+        std::array<std::uint8_t, NKeyBytes> key{};
+        block_t buffer{};
+        fill_pseudo_random(key, seed);
+        fill_pseudo_random(buffer, seed);
+        const auto plain = buffer;
+
+        const TExpected expected{key};
+        const TActual actual{key};
+        const auto expected_cipher = expected.encrypt(plain);
+        const auto actual_cipher = actual.encrypt(plain);
+        if (actual_cipher != expected_cipher) {
+            std::println(
+                std::cerr,
+                "[{}] 密文与参考实现不符：密文({})，预期({})",
+                std::string(name),
+                bytes_to_string(actual_cipher),
+                bytes_to_string(expected_cipher));
+            return false;
+        }
+
+        const auto actual_plain = actual.decrypt(actual_cipher);
+        if (actual_plain != plain) {
+            std::println(
+                std::cerr,
+                "[{}] 解密与原文不符：解密({})，原文({})",
+                std::string(name),
+                bytes_to_string(actual_plain),
+                bytes_to_string(plain));
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 展开的 32 位字实现与逐阶段实现逐位相同
+template<std::size_t NRound, std::size_t NKeyBytes>
+bool test_reference_stages(const std::string_view name) {
+    std::uint32_t seed = 0x2024'0621;
+    for (int i = 0; i < 256; ++i) {
+        std::array<std::uint8_t, NKeyBytes> key{};
+        block_t buffer{};
+        fill_pseudo_random(key, seed);
+        fill_pseudo_random(buffer, seed);
+        const auto keys = RoundKeys<NRound>::from_array(key);
+        const auto plain = StateMatrix::from_array(buffer);
+
+        auto staged = plain;
+        keys.encrypt_stages(staged);
+        const auto cipher = keys.encrypt(plain);
+        auto unstaged = cipher;
+        keys.decrypt_stages(unstaged);
+        if (cipher != staged || keys.decrypt(cipher) != unstaged || unstaged != plain) {
+            std::println(std::cerr, "[{}] 展开的实现与逐阶段实现不符", std::string(name));
+            return false;
+        }
+        auto bytes = buffer;
+        keys.encrypt(bytes);
+        if (bytes != StateMatrix::to_array(cipher)) return false;
+
+        // 直接在未对齐的调用方内存上加密解密
+        std::array<std::byte, 17> unaligned{};
+        std::memcpy(unaligned.data() + 1, buffer.data(), 16);
+        const std::span<std::byte, 16> view{unaligned.data() + 1, 16};
+        keys.encrypt(view, view);
+        if (std::memcmp(view.data(), bytes.data(), 16) != 0) return false;
+        keys.decrypt(view, view);
+        if (std::memcmp(view.data(), buffer.data(), 16) != 0) return false;
+    }
+    return true;
+}
+
+static_assert(alignof(RoundKeys<14>) == 64 && sizeof(RoundKeys<14>::states) <= 4 * 64, "failed: " "AES-256 轮密钥占 4 个缓存行");
+static_assert(alignof(TableRoundKeys<14>) == 64, "failed: " "alignof(TableRoundKeys<14>) == 64");
+
+bool test_reference_engine() {
+    return test_reference_stages<10, 16>("AES128-stages")
+        && test_reference_stages<12, 24>("AES192-stages")
+        && test_reference_stages<14, 32>("AES256-stages");
+}
+
+bool test_table_engine() {
+    return test_same_as_reference<ReferenceCryptor<4, 10>, TableCryptor<4, 10>, 16>("AES128-table")
+        && test_same_as_reference<ReferenceCryptor<6, 12>, TableCryptor<6, 12>, 24>("AES192-table")
+        && test_same_as_reference<ReferenceCryptor<8, 14>, TableCryptor<8, 14>, 32>("AES256-table");
+}
+
+bool test_bitslice_engine() {
+    return test_same_as_reference<ReferenceCryptor<4, 10>, BitsliceCryptor<4, 10>, 16>("AES128-bitslice")
+        && test_same_as_reference<ReferenceCryptor<6, 12>, BitsliceCryptor<6, 12>, 24>("AES192-bitslice")
+        && test_same_as_reference<ReferenceCryptor<8, 14>, BitsliceCryptor<8, 14>, 32>("AES256-bitslice");
+}
+
+bool test_vperm_engine() {
+    return test_same_as_reference<ReferenceCryptor<4, 10>, VpermCryptor<4, 10>, 16>("AES128-vperm")
+        && test_same_as_reference<ReferenceCryptor<6, 12>, VpermCryptor<6, 12>, 24>("AES192-vperm")
+        && test_same_as_reference<ReferenceCryptor<8, 14>, VpermCryptor<8, 14>, 32>("AES256-vperm");
+}
+
+/// @brief 多块加密解密与逐块参考实现比较，块数覆盖向量批次和不足一个通道的尾部
+template<std::size_t NRound, std::size_t NKeyBytes>
+bool test_bitslice_blocks() {
+    std::uint32_t seed = 0x5eed'b175;
+    std::array<std::uint8_t, NKeyBytes> key{};
+    fill_pseudo_random(key, seed);
+    const auto reference = RoundKeys<NRound>::from_array(key);
+    const auto sliced = BitsliceRoundKeys<NRound>::from_array(key);
+
+    for (const std::size_t count: {1, 3, 4, 7, 8, 16, 37}) {
+        std::vector<block_t> plain(count);
+        for (auto& block: plain) fill_pseudo_random(block, seed);
+
+        auto buffer = plain;
+        sliced.encrypt_blocks(buffer[0].data(), buffer[0].data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto expected = plain[i];
+            reference.encrypt(expected);
+            if (buffer[i] != expected) {
+                std::println(std::cerr, "[bitslice-{}] 第 {} 块密文与参考实现不符", count, i);
+                return false;
+            }
+        }
+
+        sliced.decrypt_blocks(buffer[0].data(), buffer[0].data(), count);
+        if (buffer != plain) {
+            std::println(std::cerr, "[bitslice-{}] 多块解密与原文不符", count);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_bitslice_bulk() {
+    return test_bitslice_blocks<10, 16>() && test_bitslice_blocks<12, 24>() && test_bitslice_blocks<14, 32>();
+}
+
+/// @brief span 多块接口与逐块接口比较，数据故意不对齐并带有不足一块的尾部
+template<typename TCryptor, std::size_t NKeyBytes>
+bool test_span_blocks(const std::string_view name) {
+    std::uint32_t seed = 0x0b1c'5a11;
+    std::array<std::uint8_t, NKeyBytes> key{};
+    fill_pseudo_random(key, seed);
+    const TCryptor cryptor{key};
+
+    constexpr std::size_t count = 37;
+    std::vector<std::uint8_t> storage(count * 16 + 1 + 5);
+    fill_pseudo_random(storage, seed);
+    const std::span<std::byte> data = std::as_writable_bytes(std::span{storage}).subspan(1);
+    const std::vector<std::byte> plain(data.begin(), data.end());
+
+    std::vector<std::byte> cipher(plain.size());
+    if (cryptor.encrypt_blocks(plain, cipher) != count) {
+        std::println(std::cerr, "[{}] 处理的块数不正确", std::string(name));
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        block_t expected{};
+        std::memcpy(expected.data(), plain.data() + i * 16, 16);
+        cryptor.encrypt(expected);
+        if (std::memcmp(expected.data(), cipher.data() + i * 16, 16) != 0) {
+            std::println(std::cerr, "[{}] 第 {} 块密文与逐块加密不符", std::string(name), i);
+            return false;
+        }
+    }
+
+    // 单块 span 接口直接读写未对齐的内存，BareCryptor 的结果应相同
+    const auto bare = TCryptor::create_const(key);
+    std::vector<std::byte> single(plain.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::span<const std::byte, 16> in{plain.data() + i * 16, 16};
+        const std::span<std::byte, 16> out{single.data() + i * 16, 16};
+        cryptor.encrypt(in, out);
+        if (!std::equal(out.begin(), out.end(), cipher.begin() + i * 16)) {
+            std::println(std::cerr, "[{}] 第 {} 块的单块 span 加密与多块加密不符", std::string(name), i);
+            return false;
+        }
+        bare.decrypt(out, out);
+        if (!std::equal(out.begin(), out.end(), in.begin())) {
+            std::println(std::cerr, "[{}] 第 {} 块的单块 span 原地解密与原文不符", std::string(name), i);
+            return false;
+        }
+    }
+
+    cryptor.encrypt_blocks(data);
+    if (!std::equal(data.begin(), data.begin() + count * 16, cipher.begin())) {
+        std::println(std::cerr, "[{}] 原地加密与非原地加密不符", std::string(name));
+        return false;
+    }
+    cryptor.decrypt_blocks(data);
+    if (!std::equal(data.begin(), data.end(), plain.begin())) {
+        std::println(std::cerr, "[{}] 原地解密与原文不符或改动了尾部", std::string(name));
+        return false;
+    }
+    return true;
+}
+
+bool test_span_api() {
+    return test_span_blocks<AES128Cryptor, 16>("AES128-span")
+        && test_span_blocks<AES192Cryptor, 24>("AES192-span")
+        && test_span_blocks<AES256Cryptor, 32>("AES256-span")
+        && test_span_blocks<ReferenceCryptor<4, 10>, 16>("AES128-reference-span")
+        && test_span_blocks<TableCryptor<6, 12>, 24>("AES192-table-span")
+        && test_span_blocks<BitsliceCryptor<8, 14>, 32>("AES256-bitslice-span")
+        && test_span_blocks<VpermCryptor<4, 10>, 16>("AES128-vperm-span");
+}
+
+/// @brief 默认密码工具在运行时选择实现，在支持 AES-NI 的机器上即测试 AES-NI
+bool test_dispatch_engine() {
+    std::println("[dispatch] 当前实现：{}", engine_name(active_engine()));
+    return test_same_as_reference<ReferenceCryptor<4, 10>, AES128Cryptor, 16>("AES128-dispatch")
+        && test_same_as_reference<ReferenceCryptor<6, 12>, AES192Cryptor, 24>("AES192-dispatch")
+        && test_same_as_reference<ReferenceCryptor<8, 14>, AES256Cryptor, 32>("AES256-dispatch");
+}
+
+/// @brief 编译期扩展的轮密钥中，运行时可能选用的每一份都要与参考实现相同
+/// @details 运行时按 CPU 特性选择 T 表(AES-NI 也使用这份轮密钥)、向量置换或位切片实现，
+/// 编译期无法得知运行的 CPU ，因此三份轮密钥都必须可用；逐份直接检查，不依赖当前 CPU 选择的实现
+template<std::size_t NWord, std::size_t NRound, const std::array<std::uint8_t, NWord * 4>& Key>
+bool test_const_cryptor_of(const std::string_view name) {
+    using TCryptor = Cryptor<NWord, NRound>;
+    static constexpr TCryptor const_cryptor{Key};
+    static constexpr auto const_bare = TCryptor::create_const(Key);
+    const ReferenceCryptor<NWord, NRound> reference{Key};
+    const TCryptor runtime_cryptor{Key};
+
+    std::uint32_t seed = 0xc0de'57a7;
+    std::array<std::uint8_t, 8 * 16> plain{};
+    fill_pseudo_random(plain, seed);
+    const auto block_at = [&plain](const std::size_t i) {
+        block_t block{};
+        std::copy_n(plain.begin() + i * 16, 16, block.begin());
+        return block;
+    };
+    const auto check = [&](const std::string_view schedule, const auto& keys) {
+        for (std::size_t i = 0; i < 8; ++i) {
+            const auto block = block_at(i);
+            const auto expected = reference.encrypt(block);
+            auto buffer = block;
+            keys.encrypt(buffer);
+            if (buffer != expected) {
+                std::println(std::cerr, "[{}-{}] 第 {} 块编译期轮密钥的密文与参考实现不符", std::string(name), std::string(schedule), i);
+                return false;
+            }
+            keys.decrypt(buffer);
+            if (buffer != block) {
+                std::println(std::cerr, "[{}-{}] 第 {} 块编译期轮密钥解密与原文不符", std::string(name), std::string(schedule), i);
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!check("table", const_bare.keys.table) || !check("bitslice", const_bare.keys.sliced) || !check("vperm", const_bare.keys.vperm))
+        return false;
+#if CANGO_AES_X86
+    // AES-NI 直接使用 T 表轮密钥
+    if (cpu_features().aes && cpu_features().ssse3) {
+        for (std::size_t i = 0; i < 8; ++i) {
+            auto block = block_at(i);
+            const auto expected = reference.encrypt(block_at(i));
+            aesni::encrypt<NRound>(const_bare.keys.table.enc.data(), block.data());
+            if (block != expected) {
+                std::println(std::cerr, "[{}-aesni] 第 {} 块编译期轮密钥的密文与参考实现不符", std::string(name), i);
+                return false;
+            }
+            aesni::decrypt<NRound>(const_bare.keys.table.dec.data(), block.data());
+            if (!std::equal(block.begin(), block.end(), plain.begin() + i * 16)) {
+                std::println(std::cerr, "[{}-aesni] 第 {} 块编译期轮密钥解密与原文不符", std::string(name), i);
+                return false;
+            }
+        }
+    }
+#endif
+
+    // 当前 CPU 选择的实现下，编译期与运行时扩展的密码工具结果相同
+    auto const_buffer = plain;
+    auto runtime_buffer = plain;
+    const_cryptor.encrypt_blocks(std::as_writable_bytes(std::span{const_buffer}));
+    runtime_cryptor.encrypt_blocks(std::as_writable_bytes(std::span{runtime_buffer}));
+    if (const_buffer != runtime_buffer) {
+        std::println(std::cerr, "[{}] 编译期与运行时密钥的多块密文不符", std::string(name));
+        return false;
+    }
+    const_cryptor.decrypt_blocks(std::as_writable_bytes(std::span{const_buffer}));
+    return const_buffer == plain;
+}
+
+constexpr std::array<std::uint8_t, 16> const_key128 = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+constexpr std::array<std::uint8_t, 24> const_key192 = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17
+};
+constexpr std::array<std::uint8_t, 32> const_key256 = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static_assert([] {
+    const AES128Cryptor cryptor{const_key128};
+    std::array<std::byte, 16> bytes{};
+    cryptor.encrypt(bytes, bytes);
+    const auto expected = cryptor.encrypt(block_t{});
+    for (std::size_t i = 0; i < 16; ++i)
+        if (bytes[i] != static_cast<std::byte>(expected[i])) return false;
+    cryptor.decrypt(bytes, bytes);
+    return bytes == std::array<std::byte, 16>{};
+}(), "failed: " "编译期的单块 span 接口与数组接口结果相同");
+
+bool test_const_cryptor() {
+    return test_const_cryptor_of<4, 10, const_key128>("AES128-const")
+        && test_const_cryptor_of<6, 12, const_key192>("AES192-const")
+        && test_const_cryptor_of<8, 14, const_key256>("AES256-const");
+}
+
 /// @brief AES-128 example from FIPS-197 Appendix C.1
 /// https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.197.pdf
 bool test_aes128() {
@@ -77,8 +400,27 @@ bool test_aes128() {
     constexpr auto decrypted_mat = round_keys.decrypt(encrypted_mat);
     static_assert(encrypted_mat == cipher_mat, "failed: " "encrypted_mat == cipher_mat");
     static_assert(decrypted_mat == plain_text_mat, "failed: " "decrypted_mat == plain_text_mat");
+    constexpr auto staged_mat = pipe([&](auto& mat) { round_keys.encrypt_stages(mat); }, plain_text_mat);
+    static_assert(staged_mat == cipher_mat, "failed: " "staged_mat == cipher_mat");
+
+    constexpr auto table_keys = TableRoundKeys<10>::from_array(key);
+    constexpr auto table_encrypted = pipe([&](auto& data) { table_keys.encrypt(data); }, plain_text);
+    constexpr auto table_decrypted = pipe([&](auto& data) { table_keys.decrypt(data); }, table_encrypted);
+    static_assert(table_encrypted == expected_cipher, "failed: " "table_encrypted == expected_cipher");
+    static_assert(table_decrypted == plain_text, "failed: " "table_decrypted == plain_text");
+
+    constexpr auto sliced_keys = BitsliceRoundKeys<10>::from_array(key);
+    constexpr auto sliced_encrypted = pipe([&](auto& data) { sliced_keys.encrypt(data); }, plain_text);
+    static_assert(sliced_encrypted == expected_cipher, "failed: " "sliced_encrypted == expected_cipher");
 
-    return test_cryptor<AES128Cryptor>("AES128", plain_text, key, expected_cipher);
+    constexpr auto vperm_keys = VpermRoundKeys<10>::from_array(key);
+    constexpr auto vperm_encrypted = pipe([&](auto& data) { vperm_keys.encrypt(data); }, plain_text);
+    constexpr auto vperm_decrypted = pipe([&](auto& data) { vperm_keys.decrypt(data); }, vperm_encrypted);
+    static_assert(vperm_encrypted == expected_cipher, "failed: " "vperm_encrypted == expected_cipher");
+    static_assert(vperm_decrypted == plain_text, "failed: " "vperm_decrypted == plain_text");
+
+    return test_cryptor<AES128Cryptor>("AES128", plain_text, key, expected_cipher)
+        && test_cryptor<TableCryptor<4, 10>>("AES128-table", plain_text, key, expected_cipher);
 }
 
 /// @brief AES-192 example from FIPS-197 Appendix C.2
@@ -117,8 +459,27 @@ bool test_aes192() {
     constexpr auto decrypted_mat = round_keys.decrypt(encrypted_mat);
     static_assert(encrypted_mat == cipher_mat, "failed: " "encrypted_mat == cipher_mat");
     static_assert(decrypted_mat == plain_text_mat, "failed: " "decrypted_mat == plain_text_mat");
+    constexpr auto staged_mat = pipe([&](auto& mat) { round_keys.encrypt_stages(mat); }, plain_text_mat);
+    static_assert(staged_mat == cipher_mat, "failed: " "staged_mat == cipher_mat");
+
+    constexpr auto table_keys = TableRoundKeys<12>::from_array(key);
+    constexpr auto table_encrypted = pipe([&](auto& data) { table_keys.encrypt(data); }, plain_text);
+    constexpr auto table_decrypted = pipe([&](auto& data) { table_keys.decrypt(data); }, table_encrypted);
+    static_assert(table_encrypted == expected_cipher, "failed: " "table_encrypted == expected_cipher");
+    static_assert(table_decrypted == plain_text, "failed: " "table_decrypted == plain_text");
+
+    constexpr auto sliced_keys = BitsliceRoundKeys<12>::from_array(key);
+    constexpr auto sliced_encrypted = pipe([&](auto& data) { sliced_keys.encrypt(data); }, plain_text);
+    static_assert(sliced_encrypted == expected_cipher, "failed: " "sliced_encrypted == expected_cipher");
 
-    return test_cryptor<AES192Cryptor>("AES192", plain_text, key, expected_cipher);
+    constexpr auto vperm_keys = VpermRoundKeys<12>::from_array(key);
+    constexpr auto vperm_encrypted = pipe([&](auto& data) { vperm_keys.encrypt(data); }, plain_text);
+    constexpr auto vperm_decrypted = pipe([&](auto& data) { vperm_keys.decrypt(data); }, vperm_encrypted);
+    static_assert(vperm_encrypted == expected_cipher, "failed: " "vperm_encrypted == expected_cipher");
+    static_assert(vperm_decrypted == plain_text, "failed: " "vperm_decrypted == plain_text");
+
+    return test_cryptor<AES192Cryptor>("AES192", plain_text, key, expected_cipher)
+        && test_cryptor<TableCryptor<6, 12>>("AES192-table", plain_text, key, expected_cipher);
 }
 
 /// @brief AES-192 example from FIPS-197 Appendix C.3
@@ -159,8 +520,123 @@ bool test_aes256() {
     constexpr auto decrypted_mat = round_keys.decrypt(encrypted_mat);
     static_assert(encrypted_mat == cipher_mat, "failed: " "encrypted_mat == cipher_mat");
     static_assert(decrypted_mat == plain_text_mat, "failed: " "decrypted_mat == plain_text_mat");
+    constexpr auto staged_mat = pipe([&](auto& mat) { round_keys.encrypt_stages(mat); }, plain_text_mat);
+    static_assert(staged_mat == cipher_mat, "failed: " "staged_mat == cipher_mat");
+
+    constexpr auto table_keys = TableRoundKeys<14>::from_array(key);
+    constexpr auto table_encrypted = pipe([&](auto& data) { table_keys.encrypt(data); }, plain_text);
+    constexpr auto table_decrypted = pipe([&](auto& data) { table_keys.decrypt(data); }, table_encrypted);
+    static_assert(table_encrypted == expected_cipher, "failed: " "table_encrypted == expected_cipher");
+    static_assert(table_decrypted == plain_text, "failed: " "table_decrypted == plain_text");
+
+    constexpr auto sliced_keys = BitsliceRoundKeys<14>::from_array(key);
+    constexpr auto sliced_encrypted = pipe([&](auto& data) { sliced_keys.encrypt(data); }, plain_text);
+    static_assert(sliced_encrypted == expected_cipher, "failed: " "sliced_encrypted == expected_cipher");
+
+    constexpr auto vperm_keys = VpermRoundKeys<14>::from_array(key);
+    constexpr auto vperm_encrypted = pipe([&](auto& data) { vperm_keys.encrypt(data); }, plain_text);
+    constexpr auto vperm_decrypted = pipe([&](auto& data) { vperm_keys.decrypt(data); }, vperm_encrypted);
+    static_assert(vperm_encrypted == expected_cipher, "failed: " "vperm_encrypted == expected_cipher");
+    static_assert(vperm_decrypted == plain_text, "failed: " "vperm_decrypted == plain_text");
+
+    return test_cryptor<AES256Cryptor>("AES256", plain_text, key, expected_cipher)
+        && test_cryptor<TableCryptor<8, 14>>("AES256-table", plain_text, key, expected_cipher);
+}
+
+/// @brief 由标识确定的测试主钥
+std::array<std::uint8_t, 32> key_of(const std::uint64_t id) {
+    std::array<std::uint8_t, 32> key{};
+    auto seed = static_cast<std::uint32_t>(id * 2654435761u + 1);
+    fill_pseudo_random(key, seed);
+    return key;
+}
+
+/// @brief 密钥缓存：命中与未命中计数、换出后已取出的句柄仍可用、多线程同时查找和插入
+bool test_key_cache() {
+    KeyCache<AES256Cryptor> cache{{64, 2}};
+    const block_t plain{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    const auto first = cache.find_or_insert(0, key_of(0));
+    for (std::uint64_t id = 0; id < 200; ++id) {
+        const auto cryptor = cache.find_or_insert(id, key_of(id));
+        const AES256Cryptor expected{key_of(id)};
+        if (cryptor->encrypt(plain) != expected.encrypt(plain) || cryptor->decrypt(expected.encrypt(plain)) != plain) {
+            std::println(std::cerr, "[key-cache] 第 {} 个密钥的结果不正确", id);
+            return false;
+        }
+    }
+    const auto stats = cache.stats();
+    if (cache.capacity() != 64 || stats.hits != 1 || stats.misses != 200 || stats.evictions != 200 - 64) {
+        std::println(std::cerr, "[key-cache] 计数不正确：命中 {}，未命中 {}，换出 {}", stats.hits, stats.misses, stats.evictions);
+        return false;
+    }
+    if (first->encrypt(plain) != AES256Cryptor{key_of(0)}.encrypt(plain)) {
+        std::println(std::cerr, "[key-cache] 换出后已取出的句柄不可用");
+        return false;
+    }
+    const auto last = cache.find(199);
+    if (!last || !cache.erase(199) || cache.find(199) || cache.erase(199)) {
+        std::println(std::cerr, "[key-cache] 删除不正确");
+        return false;
+    }
+    cache.clear();
+    if (cache.find(198)) return false;
+
+    // 多个线程反复取用少量密钥，标识多于容量以触发换出
+    KeyCache<AES256Cryptor> shared{{128, 4}};
+    std::atomic<bool> passed{true};
+    {
+        std::vector<std::jthread> workers;
+        for (std::uint32_t t = 0; t < 4; ++t) {
+            workers.emplace_back([&, t] {
+                auto seed = 0xc0de'0017u + t;
+                for (std::size_t i = 0; i < 20000; ++i) {
+                    seed = seed * 1664525u + 1013904223u;
+                    const auto id = std::uint64_t{seed >> 24};
+                    const auto cryptor = shared.find_or_insert(id, [id] { return key_of(id); });
+                    if (i % 97 == 0 && cryptor->encrypt(plain) != AES256Cryptor{key_of(id)}.encrypt(plain)) passed = false;
+                }
+            });
+        }
+    }
+    const auto shared_stats = shared.stats();
+    std::println("[key-cache] 命中 {}，未命中 {}，换出 {}", shared_stats.hits, shared_stats.misses, shared_stats.evictions);
+    if (!passed || shared_stats.hits + shared_stats.misses != 80000) {
+        std::println(std::cerr, "[key-cache] 多线程使用的结果不正确");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 批量扩展的结果与逐个 reinit 相同，个数不是交错宽度的整数倍
+template<typename TCryptor, std::size_t NBytes>
+bool test_reinit_many_of(const std::string_view name) {
+    constexpr std::size_t count = 1000 + 3;
+    std::vector<std::array<std::uint8_t, NBytes>> keys(count);
+    auto seed = static_cast<std::uint32_t>(0x0018'0000u + NBytes);
+    for (auto& key: keys) fill_pseudo_random(key, seed);
+
+    std::vector<TCryptor> single(count, TCryptor{keys[0]});
+    std::vector<TCryptor> batch(count, TCryptor{keys[0]});
+    for (std::size_t i = 0; i < count; ++i) single[i].reinit(keys[i]);
+    const auto done = TCryptor::reinit_many(keys, batch);
+
+    const block_t plain{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    if (done != count) return false;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto cipher = single[i].encrypt(plain);
+        if (batch[i].encrypt(plain) != cipher || batch[i].decrypt(cipher) != plain) {
+            std::println(std::cerr, "[{}] 第 {} 个密钥的批量扩展结果不正确", std::string(name), i);
+            return false;
+        }
+    }
+    return TCryptor::reinit_many(std::span{keys}.first(2), batch) == 2 && TCryptor::reinit_many(keys, std::span{batch}.first(5)) == 5;
+}
 
-    return test_cryptor<AES256Cryptor>("AES256", plain_text, key, expected_cipher);
+bool test_reinit_many() {
+    return test_reinit_many_of<AES128Cryptor, 16>("reinit-many-128")
+        && test_reinit_many_of<AES192Cryptor, 24>("reinit-many-192")
+        && test_reinit_many_of<AES256Cryptor, 32>("reinit-many-256")
+        && test_reinit_many_of<TableCryptor<4, 10>, 16>("reinit-many-table");
 }
 
 void compile_example() {
@@ -189,6 +665,16 @@ int main() {
     tb.execute("aes128", test_aes128);
     tb.execute("aes192", test_aes192);
     tb.execute("aes256", test_aes256);
+    tb.execute("reference engine", test_reference_engine);
+    tb.execute("table engine", test_table_engine);
+    tb.execute("bitslice engine", test_bitslice_engine);
+    tb.execute("vperm engine", test_vperm_engine);
+    tb.execute("bitslice bulk", test_bitslice_bulk);
+    tb.execute("dispatch engine", test_dispatch_engine);
+    tb.execute("const cryptor", test_const_cryptor);
+    tb.execute("span api", test_span_api);
+    tb.execute("key cache", test_key_cache);
+    tb.execute("reinit many", test_reinit_many);
     tb.summary();
     return tb.failed > 0 ? 1 : 0;
 }
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <cango/aes.hpp>
+
+#include "toolbox.hpp"
+
+using namespace cango::aes;
+using namespace cango::aes::details;
+
+/// @brief GCM 测试向量，所有字段为十六进制字符串
+struct GcmVector {
+    std::string_view key;
+    std::string_view iv;
+    std::string_view plain;
+    std::string_view aad;
+    std::string_view cipher;
+    std::string_view tag;
+};
+
+constexpr std::string_view plain_60 =
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+    "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+
+constexpr std::string_view aad_20 = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+
+/// @brief 测试向量来自 GCM 规范(McGrew, Viega)附录 B ，即 NIST 的 GCM 验证向量
+/// https://csrc.nist.rip/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-spec.pdf
+constexpr std::array<GcmVector, 7> vectors{{
+    {"00000000000000000000000000000000", "000000000000000000000000", "", "", "",
+        "58e2fccefa7e3061367f1d57a4e7455a"},
+    {"00000000000000000000000000000000", "000000000000000000000000", "00000000000000000000000000000000", "",
+        "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+        "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255", "",
+        "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+        "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+        "4d5c2af327cd64a62cf35abd2ba6fab4"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", plain_60, aad_20,
+        "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+        "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+        "5bc94fbc3221a5db94fae95ae7121a47"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbad", plain_60, aad_20,
+        "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c7423"
+        "73806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+        "3612d2e79e3b0785561be14aaca2fccb"},
+    {"feffe9928665731c6d6a8f9467308308",
+        "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+        "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b", plain_60, aad_20,
+        "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca7"
+        "01e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+        "619cc5aefffe0bfa462af43c1699d050"},
+    {"feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", plain_60, aad_20,
+        "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+        "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+        "76fc6ece0f4e1768cddf8853bb2d551b"},
+}};
+
+template<typename TCryptor, std::size_t NKeyBytes>
+bool check_vector(const std::size_t index, const GcmVector& vector) {
+    const auto key_bytes = hex_to_bytes(vector.key);
+    std::array<std::uint8_t, NKeyBytes> key{};
+    std::memcpy(key.data(), key_bytes.data(), key.size());
+    const TCryptor cryptor{key};
+    GcmCryptor<TCryptor> gcm{cryptor};
+
+    const auto plain = hex_to_bytes(vector.plain);
+    const auto expected_tag = hex_to_bytes(vector.tag);
+    auto buffer = plain;
+    gcm.start(hex_to_bytes(vector.iv));
+    gcm.update_aad(hex_to_bytes(vector.aad));
+    gcm.encrypt(buffer);
+    const auto tag = gcm.finish().value_or(block_t{});
+    if (buffer != hex_to_bytes(vector.cipher) || !std::equal(tag.begin(), tag.end(), expected_tag.begin(), [](auto a, auto b) {
+        return static_cast<std::byte>(a) == b;
+    })) {
+        std::println(std::cerr, "[gcm-{}] 密文或标签与测试向量不符，标签({})", index, bytes_to_string(tag));
+        return false;
+    }
+
+    gcm.start(hex_to_bytes(vector.iv));
+    gcm.update_aad(hex_to_bytes(vector.aad));
+    gcm.decrypt(buffer);
+    if (!gcm.verify(expected_tag) || buffer != plain) {
+        std::println(std::cerr, "[gcm-{}] 解密或标签验证失败", index);
+        return false;
+    }
+    return true;
+}
+
+bool test_gcm_vectors() {
+    for (std::size_t i = 0; i < vectors.size(); ++i) {
+        const bool passed = vectors[i].key.size() == 64
+            ? check_vector<AES256Cryptor, 32>(i, vectors[i])
+            : check_vector<AES128Cryptor, 16>(i, vectors[i]);
+        if (!passed) return false;
+    }
+    return true;
+}
+
+/// @brief 4 位表和 PCLMULQDQ 的 GHASH 都应与逐位乘法相同
+bool test_ghash_backends() {
+    std::uint32_t seed = 0x6a5e'0001;
+    for (int round = 0; round < 64; ++round) {
+        std::array<std::uint8_t, 16> h{};
+        std::vector<std::uint8_t> data(16 * 13);
+        fill_pseudo_random(h, seed);
+        fill_pseudo_random(data, seed);
+
+        auto expected = ghash::Element{};
+        for (std::size_t i = 0; i < data.size(); i += 16) {
+            const auto block = ghash::load(data.data() + i);
+            expected = ghash::multiply_bitwise({expected.hi ^ block.hi, expected.lo ^ block.lo}, ghash::load(h.data()));
+        }
+
+        auto key = ghash::Key::from(h);
+        for (const bool clmul: {false, key.use_clmul}) {
+            key.use_clmul = clmul;
+            std::array<std::uint8_t, 16> state{};
+            key.absorb(state, data.data(), data.size() / 16);
+            if (ghash::load(state.data()) != expected) {
+                std::println(std::cerr, "[ghash] {} 实现与逐位乘法不符", clmul ? "pclmul" : "4 位表");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief 附加数据和载荷任意切分，结果应与一次性处理相同；篡改后验证应失败
+bool test_gcm_streaming() {
+    std::uint32_t seed = 0x6c3e'0002;
+    std::array<std::uint8_t, 16> key{};
+    fill_pseudo_random(key, seed);
+    const AES128Cryptor cryptor{key};
+    GcmCryptor<AES128Cryptor> gcm{cryptor};
+
+    std::vector<std::byte> iv(12), aad(77), plain(4099);
+    fill_pseudo_random(iv, seed);
+    fill_pseudo_random(aad, seed);
+    fill_pseudo_random(plain, seed);
+
+    std::vector<std::byte> cipher(plain.size());
+    gcm.start(iv);
+    gcm.update_aad(aad);
+    gcm.encrypt(plain, cipher);
+    const auto tag = gcm.finish().value_or(block_t{});
+
+    std::vector<std::byte> fragmented(plain.size());
+    gcm.start(iv);
+    for (std::size_t offset = 0, step = 1; offset < aad.size(); offset += step, step = step % 17 + 3)
+        gcm.update_aad(std::span{aad}.subspan(offset, std::min(step, aad.size() - offset)));
+    for (std::size_t offset = 0, step = 1; offset < plain.size(); offset += step, step = step * 5 % 257 + 1) {
+        const auto n = std::min(step, plain.size() - offset);
+        gcm.encrypt(std::span{plain}.subspan(offset, n), std::span{fragmented}.subspan(offset, n));
+    }
+    if (fragmented != cipher || gcm.finish() != tag) {
+        std::println(std::cerr, "[gcm] 分段处理与一次性处理不符");
+        return false;
+    }
+
+    const auto tag_bytes = std::as_bytes(std::span{tag});
+    cipher[100] ^= std::byte{1};
+    gcm.start(iv);
+    gcm.update_aad(aad);
+    gcm.decrypt(cipher);
+    if (gcm.verify(tag_bytes)) {
+        std::println(std::cerr, "[gcm] 篡改后的密文通过了验证");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 截断标签只接受 SP 800-38D 规定的长度，4 和 8 字节的短标签需要显式允许
+bool test_gcm_tag_length() {
+    std::uint32_t seed = 0x6c3e'0003;
+    std::array<std::uint8_t, 16> key{};
+    fill_pseudo_random(key, seed);
+    const AES128Cryptor cryptor{key};
+    GcmCryptor<AES128Cryptor> gcm{cryptor};
+
+    std::vector<std::byte> iv(12), cipher(45);
+    fill_pseudo_random(iv, seed);
+    fill_pseudo_random(cipher, seed);
+    gcm.start(iv);
+    gcm.encrypt(cipher);
+    const auto tag = gcm.finish().value_or(block_t{});
+    const auto tag_bytes = std::as_bytes(std::span{tag});
+
+    const auto verify = [&](const std::size_t size, const std::size_t min_size) {
+        auto buffer = cipher;
+        gcm.start(iv);
+        gcm.decrypt(buffer);
+        return gcm.verify(tag_bytes.first(size), min_size);
+    };
+    for (std::size_t size = 0; size <= 16; ++size) {
+        const bool expected = size >= 12;
+        const bool expected_short = expected || size == 8 || size == 4;
+        if (verify(size, GcmCryptor<AES128Cryptor>::min_tag_size) != expected || verify(size, 4) != expected_short) {
+            std::println(std::cerr, "[gcm] {} 字节的标签验证结果不正确", size);
+            return false;
+        }
+    }
+    if (verify(4, 8) || verify(8, 12) || verify(11, 1)) {
+        std::println(std::cerr, "[gcm] 接受了低于要求长度的短标签");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 载荷超过上限时拒绝处理并使消息失效，计数器不会回绕到 J0 ；上限通过构造参数缩小后可以在测试中达到
+bool test_gcm_length_limit() {
+    static_assert(GcmCryptor<AES128Cryptor>::max_payload_bytes == ((std::uint64_t{1} << 32) - 2) * 16);
+    static_assert(!details::exceeds_counter<32>(GcmCryptor<AES128Cryptor>::max_payload_bytes, 2));
+    static_assert(details::exceeds_counter<32>(GcmCryptor<AES128Cryptor>::max_payload_bytes + 1, 2));
+
+    std::uint32_t seed = 0x6c3e'0004;
+    std::array<std::uint8_t, 16> key{};
+    fill_pseudo_random(key, seed);
+    const AES128Cryptor cryptor{key};
+    constexpr std::size_t limit = 16 * 5 + 3;
+    GcmCryptor<AES128Cryptor> gcm{cryptor, limit};
+    GcmCryptor<AES128Cryptor> unlimited{cryptor};
+
+    std::vector<std::byte> iv(12), plain(limit + 1);
+    fill_pseudo_random(iv, seed);
+    fill_pseudo_random(plain, seed);
+
+    // 恰好达到上限时与不限长度的结果相同
+    auto expected = plain;
+    unlimited.start(iv);
+    unlimited.encrypt(std::span{expected}.first(limit));
+    auto buffer = plain;
+    gcm.start(iv);
+    if (gcm.encrypt(std::span{buffer}.first(50)) != 50 || gcm.encrypt(std::span{buffer}.subspan(50, limit - 50)) != limit - 50
+        || buffer != expected || gcm.finish() != unlimited.finish()) {
+        std::println(std::cerr, "[gcm] 达到载荷上限时的结果不正确");
+        return false;
+    }
+
+    // 超出上限的一段不被处理，之后的数据也被拒绝，finish 与 verify 都失败
+    buffer = plain;
+    gcm.start(iv);
+    if (gcm.encrypt(std::span{buffer}.first(50)) != 50 || gcm.encrypt(std::span{buffer}.subspan(50)) != 0
+        || !std::equal(buffer.begin() + 50, buffer.end(), plain.begin() + 50) || gcm.encrypt(std::span{buffer}.subspan(50, 1)) != 0
+        || gcm.finish().has_value()) {
+        std::println(std::cerr, "[gcm] 超出载荷上限的数据没有被拒绝");
+        return false;
+    }
+    gcm.start(iv);
+    std::array<std::byte, 16> tag{};
+    std::vector<std::array<std::byte, 1>> pieces(limit + 1);
+    std::vector<std::span<std::byte>> segments(pieces.begin(), pieces.end());
+    if (gcm.decrypt_segments(segments) != 0 || gcm.verify(tag)) {
+        std::println(std::cerr, "[gcm] 超出载荷上限的分段没有被拒绝");
+        return false;
+    }
+
+    // start 之后恢复正常
+    buffer = plain;
+    gcm.start(iv);
+    if (gcm.encrypt(std::span{buffer}.first(limit)) != limit || buffer != expected) {
+        std::println(std::cerr, "[gcm] 失效的消息影响了下一条消息");
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    toolbox tb{true};
+    tb.execute("gcm vectors", test_gcm_vectors);
+    tb.execute("ghash backends", test_ghash_backends);
+    tb.execute("gcm streaming", test_gcm_streaming);
+    tb.execute("gcm tag length", test_gcm_tag_length);
+    tb.execute("gcm length limit", test_gcm_length_limit);
+    tb.summary();
+    return tb.failed > 0 ? 1 : 0;
+}
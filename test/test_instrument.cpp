@@ -0,0 +1,95 @@
+// 开启计数器和分阶段计时后编译，其余测试以默认配置编译，检查关闭时的行为
+#define CANGO_AES_PROFILE_STAGES
+
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <cango/aes.hpp>
+
+#include "toolbox.hpp"
+
+using namespace cango::aes;
+using namespace cango::aes::details;
+
+constexpr std::array<std::uint8_t, 16> main_key{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+// 编译期求值不计数，也不计时
+constexpr auto const_cryptor = ReferenceCryptor<4, 10>::create_const(main_key);
+constexpr auto const_cipher = const_cryptor.encrypt(block_t{});
+static_assert(const_cryptor.decrypt(const_cipher) == block_t{}, "failed: " "const_cryptor.decrypt(const_cipher) == block_t{}");
+static_assert(instrument_enabled, "failed: " "instrument_enabled");
+
+/// @brief 多个线程的计数在快照中汇总，已退出线程的计数不丢失
+bool test_counters() {
+    const auto before = instrument_snapshot();
+    const AES128Cryptor cryptor{main_key};
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t t = 0; t < 4; ++t) {
+            workers.emplace_back([&cryptor] {
+                std::vector<std::byte> data(16 * 100 + 5);
+                cryptor.encrypt_blocks(data);
+                cryptor.decrypt_blocks(std::span{data}.first(16 * 30));
+                block_t block{};
+                cryptor.encrypt(block);
+            });
+        }
+    }
+    std::vector<AES128Cryptor> many(10);
+    const std::vector keys(10, main_key);
+    AES128Cryptor::reinit_many(keys, many);
+
+    const auto counters = instrument_snapshot() - before;
+    std::println("[counters] 加密 {} 块，解密 {} 块，{} 字节，扩展 {} 个密钥", counters.encrypted_blocks, counters.decrypted_blocks,
+                 counters.bytes(), counters.key_expansions);
+    if (counters.encrypted_blocks != 4 * 101 || counters.decrypted_blocks != 4 * 30 || counters.key_expansions != 11
+        || counters.bytes() != 16 * 4 * 131) {
+        std::println(std::cerr, "[counters] 计数与预期不符");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 参考实现的每个阶段都有计时，其他实现不计入阶段
+bool test_stage_profile() {
+    const ReferenceCryptor<4, 10> reference{main_key};
+    const TableCryptor<4, 10> table{main_key};
+    const block_t plain{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+
+    auto before = instrument_snapshot();
+    static_cast<void>(table.decrypt(table.encrypt(plain)));
+    if ((instrument_snapshot() - before).sub_bytes.calls != 0) return false;
+
+    before = instrument_snapshot();
+    constexpr std::size_t blocks = 1000;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        if (reference.decrypt(reference.encrypt(plain)) != plain) return false;
+    }
+    const auto profile = instrument_snapshot() - before;
+    // 每块 10 轮：字节替换和行移位各 10 次，列混合 9 次，轮密钥加 11 次
+    if (profile.sub_bytes.calls != 2 * 10 * blocks || profile.shift_rows.calls != 2 * 10 * blocks
+        || profile.mix_columns.calls != 2 * 9 * blocks || profile.add_round_key.calls != 2 * 11 * blocks) {
+        std::println(std::cerr, "[stages] 调用次数与预期不符");
+        return false;
+    }
+    const auto total = profile.sub_bytes.cycles + profile.shift_rows.cycles + profile.mix_columns.cycles + profile.add_round_key.cycles;
+    for (const auto& [name, stage]: {std::pair{"SubBytes", profile.sub_bytes}, std::pair{"ShiftRows", profile.shift_rows},
+                                      std::pair{"MixColumns", profile.mix_columns}, std::pair{"AddRoundKey", profile.add_round_key}}) {
+        std::println("[stages] {:<12} {:>8} 次，平均 {:.1f} 周期，占 {:.1f}%", name, stage.calls,
+                     static_cast<double>(stage.cycles) / static_cast<double>(stage.calls),
+                     100.0 * static_cast<double>(stage.cycles) / static_cast<double>(std::max<std::uint64_t>(total, 1)));
+    }
+    return total > 0;
+}
+
+int main() {
+    toolbox tb{true};
+    tb.execute("counters", test_counters);
+    tb.execute("stage profile", test_stage_profile);
+    tb.summary();
+    return tb.failed > 0 ? 1 : 0;
+}
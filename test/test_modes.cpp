@@ -0,0 +1,831 @@
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <cango/aes.hpp>
+#include <cango/aes/file.hpp>
+
+#include "toolbox.hpp"
+
+using namespace cango::aes;
+
+/// @brief 把字节列表转换为主密钥或数据块
+template<std::size_t N>
+std::array<std::uint8_t, N> to_array(const std::vector<std::byte>& bytes) {
+    std::array<std::uint8_t, N> result{};
+    for (std::size_t i = 0; i < N; ++i) result[i] = static_cast<std::uint8_t>(bytes[i]);
+    return result;
+}
+
+/// @brief CTR-AES128 example from NIST SP 800-38A F.5.1
+/// https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication800-38a.pdf
+bool test_ctr_vector() {
+    const AES128Cryptor cryptor{to_array<16>(hex_to_bytes("2b7e151628aed2a6abf7158809cf4f3c"))};
+    const auto counter = to_array<16>(hex_to_bytes("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+    const auto plain = hex_to_bytes(
+        "6bc1bee22e409f96e93d7e117393172a"
+        "ae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52ef"
+        "f69f2445df4f9b17ad2b417be66c3710");
+    const auto expected = hex_to_bytes(
+        "874d6191b620e3261bef6864990db6ce"
+        "9806f66b7970fdff8617187bb9fffdff"
+        "5ae4df3edbd5d35e5b4f09020db03eab"
+        "1e031dda2fbe03d1792170a0f3009cee");
+
+    CtrCryptor<AES128Cryptor> ctr{cryptor, counter};
+    auto buffer = plain;
+    ctr.apply(buffer);
+    if (buffer != expected) {
+        std::println(std::cerr, "[ctr] 密文与 SP 800-38A 不符");
+        return false;
+    }
+
+    ctr.seek(0);
+    ctr.apply(buffer);
+    if (buffer != plain) {
+        std::println(std::cerr, "[ctr] 解密与原文不符");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 任意切分、seek 和多线程的结果都应与一次性处理相同
+template<std::size_t NCounterBits>
+bool test_ctr_consistency() {
+    std::uint32_t seed = 0xc0de'0007;
+    std::array<std::uint8_t, 32> key{};
+    block_t counter{};
+    fill_pseudo_random(key, seed);
+    fill_pseudo_random(counter, seed);
+    // 让计数器在处理过程中溢出，检查只在计数器位内回绕
+    for (std::size_t i = 16 - NCounterBits / 8; i < 16; ++i) counter[i] = 0xff;
+    counter[15] = 0xf0;
+    const AES256Cryptor cryptor{key};
+
+    std::vector<std::byte> plain(3 * 1024 * 1024 + 77);
+    fill_pseudo_random(plain, seed);
+    std::vector<std::byte> expected(plain.size());
+    CtrCryptor<AES256Cryptor, NCounterBits> whole{cryptor, counter};
+    whole.apply(plain, expected);
+
+    // 逐块核对计数器的回绕规则
+    for (std::uint64_t block = 0; block < 32; ++block) {
+        auto counter_block = counter;
+        for (std::uint64_t i = 0; i < block; ++i) increment_counter<NCounterBits>(counter_block);
+        auto keystream = counter_block;
+        cryptor.encrypt(keystream);
+        for (std::size_t i = 0; i < 16; ++i) {
+            if ((plain[block * 16 + i] ^ expected[block * 16 + i]) != static_cast<std::byte>(keystream[i])) {
+                std::println(std::cerr, "[ctr-{}] 第 {} 块密钥流不正确", NCounterBits, block);
+                return false;
+            }
+        }
+    }
+
+    std::vector<std::byte> fragmented(plain.size());
+    CtrCryptor<AES256Cryptor, NCounterBits> stream{cryptor, counter};
+    for (std::size_t offset = 0, step = 1; offset < plain.size(); offset += step, step = step * 7 % 1021 + 1) {
+        const auto n = std::min(step, plain.size() - offset);
+        stream.apply(std::span{plain}.subspan(offset, n), std::span{fragmented}.subspan(offset, n));
+    }
+    if (fragmented != expected || stream.tell() != plain.size()) {
+        std::println(std::cerr, "[ctr-{}] 分段处理与一次性处理不符", NCounterBits);
+        return false;
+    }
+
+    for (const std::size_t offset: {0, 5, 16, 1000003}) {
+        std::vector<std::byte> part(plain.begin() + offset, plain.begin() + offset + 4099);
+        CtrCryptor<AES256Cryptor, NCounterBits> seeker{cryptor, counter};
+        seeker.seek(offset);
+        seeker.apply(part);
+        if (!std::equal(part.begin(), part.end(), expected.begin() + offset)) {
+            std::println(std::cerr, "[ctr-{}] seek({}) 后的结果不正确", NCounterBits, offset);
+            return false;
+        }
+    }
+
+    std::vector<std::byte> parallel(plain.size());
+    CtrCryptor<AES256Cryptor, NCounterBits> threaded{cryptor, counter};
+    threaded.apply(std::span{plain}.first(3), std::span{parallel}.first(3));
+    threaded.apply_parallel(std::span{plain}.subspan(3), std::span{parallel}.subspan(3), 4);
+    if (parallel != expected || threaded.tell() != plain.size()) {
+        std::println(std::cerr, "[ctr-{}] 多线程处理与一次性处理不符", NCounterBits);
+        return false;
+    }
+    return true;
+}
+
+bool test_ctr_counters() {
+    return test_ctr_consistency<32>() && test_ctr_consistency<64>() && test_ctr_consistency<128>();
+}
+
+/// @brief CBC-AES128 example from NIST SP 800-38A F.2.1
+bool test_cbc_vector() {
+    const AES128Cryptor cryptor{to_array<16>(hex_to_bytes("2b7e151628aed2a6abf7158809cf4f3c"))};
+    const auto iv = to_array<16>(hex_to_bytes("000102030405060708090a0b0c0d0e0f"));
+    const auto plain = hex_to_bytes(
+        "6bc1bee22e409f96e93d7e117393172a"
+        "ae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52ef"
+        "f69f2445df4f9b17ad2b417be66c3710");
+    const auto expected = hex_to_bytes(
+        "7649abac8119b246cee98e9b12e9197d"
+        "5086cb9b507219ee95db113a917678b2"
+        "73bed6b8e3c1743b7116e69e22229516"
+        "3ff1caa1681fac09120eca307586e1a7");
+
+    CbcCryptor<AES128Cryptor> cbc{cryptor, iv};
+    auto buffer = plain;
+    cbc.encrypt(buffer);
+    if (buffer != expected) {
+        std::println(std::cerr, "[cbc] 密文与 SP 800-38A 不符");
+        return false;
+    }
+
+    cbc.reset(iv);
+    cbc.decrypt(buffer);
+    if (buffer != plain) {
+        std::println(std::cerr, "[cbc] 解密与原文不符");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 分段、多线程、多路交错和填充的结果都应与逐块处理相同
+bool test_cbc_consistency() {
+    std::uint32_t seed = 0xc0de'0008;
+    std::array<std::uint8_t, 16> key{};
+    block_t iv{};
+    fill_pseudo_random(key, seed);
+    fill_pseudo_random(iv, seed);
+    const AES128Cryptor cryptor{key};
+
+    std::vector<std::byte> plain(16 * (256 * 1024 + 3));
+    fill_pseudo_random(plain, seed);
+    std::vector<std::byte> expected(plain.size());
+    CbcCryptor<AES128Cryptor> whole{cryptor, iv};
+    whole.encrypt(plain, expected);
+
+    std::vector<std::byte> decrypted(plain.size());
+    CbcCryptor<AES128Cryptor> serial{cryptor, iv};
+    for (std::size_t offset = 0, step = 1; offset < plain.size(); offset += step * 16, step = step * 7 % 61 + 1) {
+        const auto n = std::min(step * 16, plain.size() - offset);
+        serial.decrypt(std::span{expected}.subspan(offset, n), std::span{decrypted}.subspan(offset, n));
+    }
+    if (decrypted != plain) {
+        std::println(std::cerr, "[cbc] 分段解密与原文不符");
+        return false;
+    }
+
+    auto parallel = expected;
+    CbcCryptor<AES128Cryptor> threaded{cryptor, iv};
+    threaded.decrypt(std::span{parallel}.first(16));
+    threaded.decrypt_parallel(std::span{parallel}.subspan(16), 4);
+    if (parallel != plain) {
+        std::println(std::cerr, "[cbc] 多线程原地解密与原文不符");
+        return false;
+    }
+
+    // 长度不同的多条消息交错加密，包括空消息和超过 8 条时的补位
+    std::vector<std::vector<std::byte>> outputs;
+    std::vector<CbcStream> streams;
+    for (std::size_t i = 0; i < 13; ++i) outputs.emplace_back(16 * (i * i % 11));
+    for (std::size_t i = 0; i < 13; ++i) {
+        block_t stream_iv = iv;
+        stream_iv[0] ^= static_cast<std::uint8_t>(i);
+        streams.push_back({stream_iv, std::span{plain}.subspan(i * 1000 * 16, outputs[i].size()), outputs[i]});
+    }
+    cbc_encrypt_streams(cryptor, std::span{streams});
+    for (std::size_t i = 0; i < 13; ++i) {
+        block_t stream_iv = iv;
+        stream_iv[0] ^= static_cast<std::uint8_t>(i);
+        std::vector<std::byte> single(outputs[i].size());
+        CbcCryptor<AES128Cryptor> reference{cryptor, stream_iv};
+        reference.encrypt(streams[i].in, single);
+        const auto last = single.empty() ? stream_iv : to_array<16>({single.end() - 16, single.end()});
+        if (single != outputs[i] || last != streams[i].chain) {
+            std::println(std::cerr, "[cbc] 第 {} 条交错加密的消息不正确", i);
+            return false;
+        }
+    }
+
+    for (const std::size_t size: {0, 1, 15, 16, 17, 100}) {
+        const auto message = std::span{plain}.first(size);
+        std::vector<std::byte> sealed(size / 16 * 16 + 16);
+        CbcCryptor<AES128Cryptor> sender{cryptor, iv};
+        if (sender.encrypt_padded(message, sealed) != sealed.size()) {
+            std::println(std::cerr, "[cbc] {} 字节填充加密的长度不正确", size);
+            return false;
+        }
+        std::vector<std::byte> opened(sealed.size());
+        CbcCryptor<AES128Cryptor> receiver{cryptor, iv};
+        const auto length = receiver.decrypt_padded(sealed, opened);
+        if (length != size || !std::equal(message.begin(), message.end(), opened.begin())) {
+            std::println(std::cerr, "[cbc] {} 字节填充解密不正确", size);
+            return false;
+        }
+
+        // 篡改最后一块之前的密文会改变最后一块的填充字节
+        if (sealed.size() < 32) continue;
+        sealed[sealed.size() - 17] ^= std::byte{0x40};
+        receiver.reset(iv);
+        if (receiver.decrypt_padded(sealed, opened).has_value()) {
+            std::println(std::cerr, "[cbc] {} 字节消息的无效填充没有被拒绝", size);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief XTS-AES128 examples from IEEE 1619-2007 Annex B, vectors 1, 2 and 15
+bool test_xts_vector() {
+    struct Vector {
+        const char* key1;
+        const char* key2;
+        std::uint64_t sector;
+        const char* plain;
+        const char* cipher;
+    };
+    const Vector vectors[] = {
+        {"00000000000000000000000000000000", "00000000000000000000000000000000", 0,
+         "0000000000000000000000000000000000000000000000000000000000000000",
+         "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e"},
+        {"11111111111111111111111111111111", "22222222222222222222222222222222", 0x3333333333,
+         "4444444444444444444444444444444444444444444444444444444444444444",
+         "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0"},
+        {"fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", 0x123456789a,
+         "000102030405060708090a0b0c0d0e0f10",
+         "6c1625db4671522d3d7599601de7ca09ed"},
+    };
+    for (const auto& vector: vectors) {
+        const AES128Cryptor key1{to_array<16>(hex_to_bytes(vector.key1))};
+        const AES128Cryptor key2{to_array<16>(hex_to_bytes(vector.key2))};
+        const XtsCryptor<AES128Cryptor> xts{key1, key2};
+        const auto plain = hex_to_bytes(vector.plain);
+        auto buffer = plain;
+        xts.encrypt_sector(vector.sector, buffer);
+        if (buffer != hex_to_bytes(vector.cipher)) {
+            std::println(std::cerr, "[xts] 扇区 {:x} 的密文与 IEEE 1619 不符", vector.sector);
+            return false;
+        }
+        xts.decrypt_sector(vector.sector, buffer);
+        if (buffer != plain) {
+            std::println(std::cerr, "[xts] 扇区 {:x} 解密与原文不符", vector.sector);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 逐块按定义计算的 XTS 加密，调整值用逐字节的 xtime 更新
+std::vector<std::byte> xts_reference(const AES256Cryptor& key1, const AES256Cryptor& key2, const std::uint64_t sector, const std::vector<std::byte>& plain) {
+    block_t tweak{};
+    for (std::size_t i = 0; i < 8; ++i) tweak[i] = static_cast<std::uint8_t>(sector >> (8 * i));
+    key2.encrypt(tweak);
+    const auto next_tweak = [&tweak] {
+        const auto carry = tweak[15] >> 7;
+        for (std::size_t i = 15; i > 0; --i) tweak[i] = static_cast<std::uint8_t>(tweak[i] << 1 | tweak[i - 1] >> 7);
+        tweak[0] = static_cast<std::uint8_t>(tweak[0] << 1 ^ (carry ? 0x87 : 0));
+    };
+    const auto crypt = [&](block_t block) {
+        for (std::size_t i = 0; i < 16; ++i) block[i] ^= tweak[i];
+        key1.encrypt(block);
+        for (std::size_t i = 0; i < 16; ++i) block[i] ^= tweak[i];
+        next_tweak();
+        return block;
+    };
+
+    auto result = plain;
+    const auto blocks = plain.size() / 16;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        block_t block{};
+        for (std::size_t i = 0; i < 16; ++i) block[i] = static_cast<std::uint8_t>(plain[b * 16 + i]);
+        block = crypt(block);
+        for (std::size_t i = 0; i < 16; ++i) result[b * 16 + i] = static_cast<std::byte>(block[i]);
+    }
+    if (const auto tail = plain.size() % 16; tail != 0) {
+        const auto last = (blocks - 1) * 16;
+        block_t block{};
+        for (std::size_t i = 0; i < 16; ++i) block[i] = static_cast<std::uint8_t>(i < tail ? plain[last + 16 + i] : result[last + i]);
+        for (std::size_t i = 0; i < tail; ++i) result[last + 16 + i] = result[last + i];
+        block = crypt(block);
+        for (std::size_t i = 0; i < 16; ++i) result[last + i] = static_cast<std::byte>(block[i]);
+    }
+    return result;
+}
+
+/// @brief 各种长度与逐块参考实现一致，批量和多线程处理与逐扇区处理一致
+bool test_xts_consistency() {
+    std::uint32_t seed = 0xc0de'0009;
+    std::array<std::uint8_t, 32> key{};
+    fill_pseudo_random(key, seed);
+    const AES256Cryptor key1{key};
+    fill_pseudo_random(key, seed);
+    const AES256Cryptor key2{key};
+    const XtsCryptor<AES256Cryptor> xts{key1, key2};
+
+    for (const std::size_t size: {16, 17, 31, 32, 100, 127, 128, 129, 143, 4096, 4111}) {
+        std::vector<std::byte> plain(size);
+        fill_pseudo_random(plain, seed);
+        const auto sector = static_cast<std::uint64_t>(size) * 0x1'0000'0001;
+        const auto expected = xts_reference(key1, key2, sector, plain);
+        auto buffer = plain;
+        xts.encrypt_sector(sector, buffer);
+        if (buffer != expected) {
+            std::println(std::cerr, "[xts] {} 字节扇区的密文与参考实现不符", size);
+            return false;
+        }
+        xts.decrypt_sector(sector, buffer);
+        if (buffer != plain) {
+            std::println(std::cerr, "[xts] {} 字节扇区解密与原文不符", size);
+            return false;
+        }
+    }
+
+    constexpr std::size_t sector_size = 4096;
+    std::vector<std::byte> plain(sector_size * 300);
+    fill_pseudo_random(plain, seed);
+    std::vector<std::uint64_t> sectors(300);
+    for (std::size_t i = 0; i < sectors.size(); ++i) sectors[i] = i * 7919 + 3;
+
+    std::vector<std::byte> expected(plain.size());
+    for (std::size_t i = 0; i < sectors.size(); ++i)
+        xts.encrypt_sector(sectors[i], std::span{plain}.subspan(i * sector_size, sector_size), std::span{expected}.subspan(i * sector_size, sector_size));
+
+    for (const std::size_t threads: {1, 4}) {
+        auto buffer = plain;
+        if (xts.encrypt_sectors(sectors, buffer, buffer, sector_size, threads) != sectors.size() || buffer != expected) {
+            std::println(std::cerr, "[xts] {} 线程批量加密与逐扇区加密不符", threads);
+            return false;
+        }
+        xts.decrypt_sectors(sectors, buffer, buffer, sector_size, threads);
+        if (buffer != plain) {
+            std::println(std::cerr, "[xts] {} 线程批量解密与原文不符", threads);
+            return false;
+        }
+    }
+
+    std::vector<std::byte> consecutive(plain.size());
+    xts.encrypt_sectors(std::uint64_t{3}, plain, consecutive, sector_size, 4);
+    for (std::size_t i = 0; i < 300; i += 37) {
+        std::vector<std::byte> single(plain.begin() + i * sector_size, plain.begin() + (i + 1) * sector_size);
+        xts.encrypt_sector(3 + i, single);
+        if (!std::equal(single.begin(), single.end(), consecutive.begin() + i * sector_size)) {
+            std::println(std::cerr, "[xts] 连续扇区号批量加密的第 {} 个扇区不正确", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 任意切分的流式加密与解密应与整体 ECB 加 PKCS#7 填充一致
+bool test_stream_fragments() {
+    std::uint32_t seed = 0xc0de'0010;
+    std::array<std::uint8_t, 16> key{};
+    fill_pseudo_random(key, seed);
+    const AES128Cryptor cryptor{key};
+    StreamEncryptor<AES128Cryptor> encryptor{cryptor};
+    StreamDecryptor<AES128Cryptor> decryptor{cryptor};
+
+    for (const std::size_t size: {0, 1, 15, 16, 17, 31, 32, 1000, 4099}) {
+        std::vector<std::byte> plain(size);
+        fill_pseudo_random(plain, seed);
+        auto expected = plain;
+        const auto pad = 16 - size % 16;
+        expected.resize(size + pad, static_cast<std::byte>(pad));
+        cryptor.encrypt_blocks(expected);
+
+        // 同一个对象连续处理多条消息，检查 reset 后没有残留状态
+        std::vector<std::byte> sealed(expected.size());
+        std::size_t written = 0;
+        for (std::size_t offset = 0, step = 1; offset < size; offset += step, step = step * 5 % 37 + 1) {
+            const auto n = std::min(step, size - offset);
+            const auto expected_bytes = encryptor.update_size(n);
+            const auto bytes = encryptor.update(std::span{plain}.subspan(offset, n), std::span{sealed}.subspan(written));
+            if (bytes != expected_bytes) {
+                std::println(std::cerr, "[stream] update 报告的字节数 {} 与 update_size {} 不符", bytes.value_or(0), expected_bytes);
+                return false;
+            }
+            written += *bytes;
+        }
+        written += encryptor.finalize(std::span{sealed}.subspan(written));
+        if (written != sealed.size() || sealed != expected) {
+            std::println(std::cerr, "[stream] {} 字节消息的分段加密结果不正确", size);
+            return false;
+        }
+
+        std::vector<std::byte> opened(sealed.size());
+        written = 0;
+        for (std::size_t offset = 0, step = 3; offset < sealed.size(); offset += step, step = step * 7 % 41 + 1) {
+            const auto n = std::min(step, sealed.size() - offset);
+            written += decryptor.update(std::span{sealed}.subspan(offset, n), std::span{opened}.subspan(written)).value_or(0);
+        }
+        const auto last = decryptor.finalize(std::span{opened}.subspan(written));
+        if (!last || written + *last != size || !std::equal(plain.begin(), plain.end(), opened.begin())) {
+            std::println(std::cerr, "[stream] {} 字节消息的分段解密结果不正确", size);
+            return false;
+        }
+    }
+
+    // 输出不够大时应拒绝，与全部暂存区分开，且不改变暂存的数据
+    const std::array<std::byte, 20> message{};
+    std::array<std::byte, 32> sealed{};
+    std::array<std::byte, 32> opened{};
+    if (encryptor.update(std::span{message}.first(15), {}) != 0 || encryptor.update(std::span{message}.subspan(15), std::span{sealed}.first(15)).has_value()
+        || decryptor.update(std::span{message}.first(16), {}) != 0 || decryptor.update(std::span{message}.subspan(16), std::span{opened}.first(15)).has_value()) {
+        std::println(std::cerr, "[stream] 输出不够大时没有报告拒绝");
+        return false;
+    }
+    encryptor.reset();
+    decryptor.reset();
+
+    // 长度不是整块或填充被篡改时应拒绝
+    encryptor.update(message, sealed);
+    encryptor.finalize(std::span{sealed}.subspan(16));
+    decryptor.update(std::span{sealed}.first(31), opened);
+    if (decryptor.finalize(opened).has_value()) {
+        std::println(std::cerr, "[stream] 不完整的密文没有被拒绝");
+        return false;
+    }
+    sealed[20] ^= std::byte{0x80};
+    decryptor.update(sealed, opened);
+    if (decryptor.finalize(opened).has_value()) {
+        std::println(std::cerr, "[stream] 无效填充没有被拒绝");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 内存映射和读写两条路径的结果都应与内存中的 CTR 相同
+bool test_ctr_file() {
+    std::uint32_t seed = 0xc0de'0011;
+    std::array<std::uint8_t, 16> key{};
+    block_t counter{};
+    fill_pseudo_random(key, seed);
+    fill_pseudo_random(counter, seed);
+    const AES128Cryptor cryptor{key};
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto input = directory / "cango_aes_test_input.bin";
+    const auto output = directory / "cango_aes_test_output.bin";
+    std::vector<std::byte> plain(5 * 1024 * 1024 + 13);
+    fill_pseudo_random(plain, seed);
+    {
+        std::ofstream file{input, std::ios::binary};
+        file.write(reinterpret_cast<const char*>(plain.data()), static_cast<std::streamsize>(plain.size()));
+    }
+    auto expected = plain;
+    CtrCryptor<AES128Cryptor, 128>{cryptor, counter}.apply(expected);
+
+    bool passed = true;
+    for (const bool mmap: {true, false}) {
+        // 读写路径用较小的缓冲区，覆盖多次交替读写
+        const auto report = ctr_file(cryptor, counter, input, output, {4, 1024 * 1024 + 16, mmap});
+        std::vector<std::byte> result(plain.size());
+        std::ifstream file{output, std::ios::binary};
+        file.read(reinterpret_cast<char*>(result.data()), static_cast<std::streamsize>(result.size()));
+        if (report.error || report.bytes != plain.size() || file.gcount() != static_cast<std::streamsize>(plain.size()) || result != expected) {
+            std::println(std::cerr, "[ctr-file] {}路径的结果不正确", mmap ? "内存映射" : "读写");
+            passed = false;
+        }
+    }
+
+    const auto missing = ctr_file(cryptor, counter, directory / "cango_aes_test_missing.bin", output);
+    if (!missing.error) {
+        std::println(std::cerr, "[ctr-file] 输入文件不存在时没有报告错误");
+        passed = false;
+    }
+
+    // 用稀疏文件检查超出 32 位计数器范围(64 GiB)的输入被拒绝，文件系统不支持时跳过
+    std::error_code error;
+    std::filesystem::resize_file(input, (std::uint64_t{16} << 32) + 1, error);
+    if (!error) {
+        for (const bool mmap: {true, false}) {
+            const auto report = ctr_file<AES128Cryptor, 32>(cryptor, counter, input, output, {.allow_mmap = mmap});
+            if (report.error != std::errc::file_too_large || report.bytes != 0) {
+                std::println(std::cerr, "[ctr-file] 超出 32 位计数器范围的文件没有被拒绝");
+                passed = false;
+            }
+        }
+    }
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+    return passed;
+}
+
+/// @brief 线程池处理的各模式结果应与单线程相同，多个线程同时提交任务也应正确
+bool test_executor() {
+    std::uint32_t seed = 0xc0de'0012;
+    std::array<std::uint8_t, 32> key{};
+    block_t iv{};
+    fill_pseudo_random(key, seed);
+    fill_pseudo_random(iv, seed);
+    const AES256Cryptor cryptor{key};
+    // 降低阈值，使 4 MiB 的数据被拆成很多小任务
+    Executor executor{{.threads = 4, .serial_bytes = 64 * 1024, .min_chunk_bytes = 16 * 1024, .max_chunk_bytes = 64 * 1024}};
+    if (executor.plan(100, 16).count != 1 || executor.plan(1 << 20, 16).count < 16) {
+        std::println(std::cerr, "[executor] 切分方案不符合阈值");
+        return false;
+    }
+
+    std::vector<std::byte> plain(4 * 1024 * 1024 + 5);
+    fill_pseudo_random(plain, seed);
+
+    auto expected = plain;
+    cryptor.encrypt_blocks(expected);
+    auto buffer = plain;
+    if (encrypt_blocks(cryptor, buffer, buffer, executor) != plain.size() / 16 || buffer != expected) {
+        std::println(std::cerr, "[executor] 多块加密与单线程不符");
+        return false;
+    }
+    decrypt_blocks(cryptor, buffer, buffer, executor);
+    if (buffer != plain) {
+        std::println(std::cerr, "[executor] 多块解密与原文不符");
+        return false;
+    }
+
+    expected = plain;
+    CtrCryptor<AES256Cryptor>{cryptor, iv}.apply(expected);
+    buffer = plain;
+    CtrCryptor<AES256Cryptor> ctr{cryptor, iv};
+    ctr.apply(std::span{buffer}.first(7));
+    ctr.apply_parallel(std::span{buffer}.subspan(7), executor);
+    if (buffer != expected || ctr.tell() != plain.size()) {
+        std::println(std::cerr, "[executor] CTR 与单线程不符");
+        return false;
+    }
+
+    expected = plain;
+    CbcCryptor<AES256Cryptor>{cryptor, iv}.encrypt(expected);
+    buffer = expected;
+    CbcCryptor<AES256Cryptor> cbc{cryptor, iv};
+    cbc.decrypt_parallel(buffer, executor);
+    if (!std::equal(buffer.begin(), buffer.end() - 5, plain.begin())) {
+        std::println(std::cerr, "[executor] CBC 解密与原文不符");
+        return false;
+    }
+
+    fill_pseudo_random(key, seed);
+    const AES256Cryptor tweak_cryptor{key};
+    const XtsCryptor<AES256Cryptor> xts{cryptor, tweak_cryptor};
+    expected = plain;
+    xts.encrypt_sectors(std::uint64_t{9}, expected, expected, 4096, 1);
+    buffer = plain;
+    xts.encrypt_sectors(std::uint64_t{9}, buffer, buffer, 4096, executor);
+    if (buffer != expected) {
+        std::println(std::cerr, "[executor] XTS 与单线程不符");
+        return false;
+    }
+
+    // 多个线程共用同一个线程池
+    std::atomic<std::size_t> failures{0};
+    {
+        std::vector<std::jthread> clients;
+        for (std::size_t c = 0; c < 3; ++c) {
+            clients.emplace_back([&] {
+                for (std::size_t round = 0; round < 20; ++round) {
+                    auto data = plain;
+                    CtrCryptor<AES256Cryptor> local{cryptor, iv};
+                    local.apply_parallel(data, executor);
+                    local.seek(0);
+                    local.apply(data);
+                    if (data != plain) ++failures;
+                }
+            });
+        }
+    }
+    if (failures != 0) {
+        std::println(std::cerr, "[executor] 并发提交时有 {} 次结果不正确", failures.load());
+        return false;
+    }
+    return true;
+}
+
+/// @brief 把一段内存按伪随机长度切成分段，包括空分段和不足一块的分段
+template<typename TByte>
+std::vector<std::span<TByte>> split_segments(const std::span<TByte> data, std::uint32_t& seed) {
+    std::vector<std::span<TByte>> segments;
+    for (std::size_t offset = 0; offset < data.size();) {
+        seed = seed * 1664525u + 1013904223u;
+        const auto n = std::min<std::size_t>(seed >> 26, data.size() - offset);
+        segments.push_back(data.subspan(offset, n));
+        offset += n;
+    }
+    return segments;
+}
+
+/// @brief 分段处理的结果应与连续内存一致，输入和输出可以以不同方式切分
+bool test_segments() {
+    std::uint32_t seed = 0xc0de'0013;
+    std::array<std::uint8_t, 16> key{};
+    block_t iv{};
+    fill_pseudo_random(key, seed);
+    fill_pseudo_random(iv, seed);
+    const AES128Cryptor cryptor{key};
+
+    std::vector<std::byte> plain(1000);
+    fill_pseudo_random(plain, seed);
+    const auto in = split_segments(std::span<const std::byte>{plain}, seed);
+    std::vector<std::byte> output(plain.size());
+    const auto out = split_segments(std::span{output}, seed);
+    auto buffer = plain;
+    const auto data = split_segments(std::span{buffer}, seed);
+
+    // ECB 和 CBC 只处理完整的块，末尾不足一块的数据保持不变
+    auto expected = plain;
+    cryptor.encrypt_blocks(expected);
+    if (encrypt_segments(cryptor, in, out) != plain.size() / 16 || !std::equal(output.begin(), output.begin() + 992, expected.begin())
+        || encrypt_segments(cryptor, data) != plain.size() / 16 || buffer != expected) {
+        std::println(std::cerr, "[segments] ECB 分段加密与连续内存不符");
+        return false;
+    }
+    decrypt_segments(cryptor, data);
+    if (buffer != plain) {
+        std::println(std::cerr, "[segments] ECB 分段解密与原文不符");
+        return false;
+    }
+
+    expected = plain;
+    CbcCryptor<AES128Cryptor>{cryptor, iv}.encrypt(expected);
+    CbcCryptor<AES128Cryptor> cbc{cryptor, iv};
+    if (cbc.encrypt_segments(in, out) != 992 || !std::equal(output.begin(), output.begin() + 992, expected.begin())) {
+        std::println(std::cerr, "[segments] CBC 分段加密与连续内存不符");
+        return false;
+    }
+    cbc.reset(iv);
+    cbc.encrypt_segments(data);
+    cbc.reset(iv);
+    cbc.decrypt_segments(data);
+    if (buffer != plain) {
+        std::println(std::cerr, "[segments] CBC 分段解密与原文不符");
+        return false;
+    }
+
+    expected = plain;
+    CtrCryptor<AES128Cryptor>{cryptor, iv}.apply(expected);
+    CtrCryptor<AES128Cryptor> ctr{cryptor, iv};
+    if (ctr.apply_segments(in, out) != plain.size() || output != expected) {
+        std::println(std::cerr, "[segments] CTR 分段结果与连续内存不符");
+        return false;
+    }
+
+    // GCM 的附加数据也分段吸收，标签应与连续内存相同
+    const auto iv_bytes = std::as_bytes(std::span{iv}.first<12>());
+    const auto aad = std::span<const std::byte>{plain}.first(37);
+    GcmCryptor<AES128Cryptor> gcm{cryptor};
+    gcm.start(iv_bytes);
+    gcm.update_aad(aad);
+    expected = plain;
+    gcm.encrypt(expected);
+    const auto expected_tag = gcm.finish();
+    if (!expected_tag) return false;
+    gcm.start(iv_bytes);
+    gcm.update_aad_segments(split_segments(aad, seed));
+    if (gcm.encrypt_segments(in, out) != plain.size() || output != expected || gcm.finish() != expected_tag) {
+        std::println(std::cerr, "[segments] GCM 分段加密与连续内存不符");
+        return false;
+    }
+    gcm.start(iv_bytes);
+    gcm.update_aad_segments(split_segments(aad, seed));
+    const auto opened = split_segments(std::span{output}, seed);
+    gcm.decrypt_segments(opened);
+    if (!gcm.verify(std::as_bytes(std::span{*expected_tag})) || output != plain) {
+        std::println(std::cerr, "[segments] GCM 分段解密失败");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 立即开始、结束后自行销毁的协程，测试中代替事件循环的任务类型
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/// @brief 异步加密与同步一致，排队的操作受字节数上限约束，且可以在排队时取消
+bool test_async() {
+    std::uint32_t seed = 0xc0de'0014;
+    std::array<std::uint8_t, 32> key{};
+    fill_pseudo_random(key, seed);
+    const AES256Cryptor cryptor{key};
+    AsyncExecutor executor{{.threads = 4, .chunk_bytes = 64 * 1024, .max_inflight_bytes = 1024 * 1024}};
+
+    std::vector<std::byte> plain(4 * 1024 * 1024 + 5);
+    fill_pseudo_random(plain, seed);
+    auto expected = plain;
+    cryptor.encrypt_blocks(expected);
+
+    auto buffer = plain;
+    AsyncResult encrypted{}, decrypted{};
+    std::latch round_trip_done{1};
+    // 协程帧只保存闭包的地址，闭包必须比协程存活更久，不能是临时对象
+    const auto round_trip = [&]() -> Detached {
+        encrypted = co_await encrypt_async(cryptor, buffer, executor);
+        if (buffer == expected) decrypted = co_await decrypt_async(cryptor, buffer, executor);
+        round_trip_done.count_down();
+    };
+    round_trip();
+    round_trip_done.wait();
+    if (encrypted.units != plain.size() / 16 || encrypted.cancelled || decrypted.units != plain.size() / 16 || buffer != plain) {
+        std::println(std::cerr, "[async] 异步加解密与同步结果不符");
+        return false;
+    }
+
+    // 小于 inline_bytes 的操作在调用线程上直接完成
+    std::array<std::byte, 64> small{};
+    const auto caller = std::this_thread::get_id();
+    bool same_thread = false;
+    const auto encrypt_small = [&]() -> Detached {
+        co_await encrypt_async(cryptor, small, executor);
+        same_thread = std::this_thread::get_id() == caller;
+    };
+    encrypt_small();
+    if (!same_thread) {
+        std::println(std::cerr, "[async] 小操作没有在调用线程上完成");
+        return false;
+    }
+
+    // 同时提交 8 个 512 KiB 的操作，放行的字节数不应超过上限
+    std::vector<std::vector<std::byte>> messages(8, std::vector<std::byte>(512 * 1024));
+    std::atomic<std::size_t> peak{0};
+    std::atomic<std::size_t> failures{0};
+    std::latch all_done{static_cast<std::ptrdiff_t>(messages.size())};
+    const auto encrypt_message = [&](std::vector<std::byte>& data) -> Detached {
+        auto reference = data;
+        cryptor.encrypt_blocks(reference);
+        const auto result = co_await executor.run_async(data.size() / 16, 16, [&](const std::size_t begin, const std::size_t n) {
+            const auto now = executor.inflight_bytes();
+            auto seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            cryptor.encrypt_blocks(std::span{data}.subspan(begin * 16, n * 16));
+        });
+        if (result.units != data.size() / 16 || data != reference) ++failures;
+        all_done.count_down();
+    };
+    for (auto& message: messages) {
+        fill_pseudo_random(message, seed);
+        encrypt_message(message);
+    }
+    all_done.wait();
+    if (failures != 0 || peak.load() > 1024 * 1024 || peak.load() == 0) {
+        std::println(std::cerr, "[async] 背压下的结果不正确，峰值 {} 字节", peak.load());
+        return false;
+    }
+
+    // 占满上限的操作阻塞时，排队中的操作被取消后应立即完成
+    std::atomic<bool> release{false};
+    std::latch blocker_done{1}, cancelled_done{1};
+    const auto block_executor = [&]() -> Detached {
+        co_await executor.run_async(1, 1024 * 1024, [&](std::size_t, std::size_t) { release.wait(false); });
+        blocker_done.count_down();
+    };
+    block_executor();
+    std::stop_source stop;
+    std::vector<std::byte> queued(256 * 1024);
+    AsyncResult cancelled{};
+    const auto encrypt_queued = [&]() -> Detached {
+        cancelled = co_await encrypt_async(cryptor, queued, executor, stop.get_token());
+        cancelled_done.count_down();
+    };
+    encrypt_queued();
+    stop.request_stop();
+    cancelled_done.wait();
+    release = true;
+    release.notify_all();
+    blocker_done.wait();
+    if (!cancelled.cancelled || cancelled.units != 0 || std::ranges::any_of(queued, [](const std::byte b) { return b != std::byte{}; })) {
+        std::println(std::cerr, "[async] 排队中的操作没有被取消");
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    toolbox tb{true};
+    tb.execute("ctr vector", test_ctr_vector);
+    tb.execute("ctr counters", test_ctr_counters);
+    tb.execute("ctr file", test_ctr_file);
+    tb.execute("cbc vector", test_cbc_vector);
+    tb.execute("cbc consistency", test_cbc_consistency);
+    tb.execute("xts vector", test_xts_vector);
+    tb.execute("xts consistency", test_xts_consistency);
+    tb.execute("stream fragments", test_stream_fragments);
+    tb.execute("executor", test_executor);
+    tb.execute("segments", test_segments);
+    tb.execute("async", test_async);
+    tb.summary();
+    return tb.failed > 0 ? 1 : 0;
+}
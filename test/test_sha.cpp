@@ -0,0 +1,381 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cango/sha.hpp>
+#include <cango/sha/file.hpp>
+
+#include "toolbox.hpp"
+
+using cango::sha::Hkdf;
+using cango::sha::HmacSha256;
+using cango::sha::MerkleOptions;
+using cango::sha::MerkleTree;
+using cango::sha::SHA256;
+
+/// @brief 编译期计算的摘要
+constexpr auto abc_digest = SHA256::hash("abc");
+static_assert(abc_digest[0] == 0xba && abc_digest[1] == 0x78 && abc_digest[31] == 0xad);
+
+/// @brief 编译期计算的 HMAC ，RFC 4231 测试用例 2
+static_assert(HmacSha256::compute("Jefe", "what do ya want for nothing?")[0] == 0x5b);
+
+/// @brief 把十六进制摘要转换为数组
+SHA256::digest_t to_digest(const std::string_view hex) {
+    const auto bytes = hex_to_bytes(hex);
+    SHA256::digest_t digest{};
+    for (std::size_t i = 0; i < digest.size(); ++i) digest[i] = static_cast<std::uint8_t>(bytes[i]);
+    return digest;
+}
+
+/// @brief FIPS 180-2 附录 B 与 NIST CAVP 的短消息
+bool test_sha256_vectors() {
+    const std::pair<std::string, std::string_view> vectors[] = {
+        {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+        {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+        {std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+    };
+    for (const auto& [message, expected]: vectors) {
+        if (SHA256::hash(message) != to_digest(expected)) {
+            std::println(std::cerr, "[sha256] {} 字节消息的摘要不正确", message.size());
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 任意切分的输入应与一次性输入结果相同，覆盖填充跨块的长度
+bool test_sha256_fragments() {
+    std::uint32_t seed = 0xc0de'0013;
+    std::vector<std::byte> message(10000);
+    fill_pseudo_random(message, seed);
+    SHA256 hasher{};
+    for (const std::size_t size: {0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 10000}) {
+        const auto data = std::span{message}.first(size);
+        const auto expected = SHA256::hash(data);
+        for (std::size_t offset = 0, step = 1; offset < size; offset += step, step = step * 3 % 97 + 1)
+            hasher.update(data.subspan(offset, std::min(step, size - offset)));
+        if (hasher.finalize() != expected) {
+            std::println(std::cerr, "[sha256] {} 字节消息分段输入的摘要不正确", size);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 硬件实现与可移植实现的结果相同
+bool test_sha256_backends() {
+#if CANGO_AES_X86
+    if (!cango::sha::details::shani::available()) {
+        std::println("[sha256] CPU 不支持 SHA 扩展，跳过");
+        return true;
+    }
+    std::uint32_t seed = 0xc0de'1013;
+    std::vector<std::uint8_t> blocks(64 * 37);
+    fill_pseudo_random(blocks, seed);
+    auto portable = cango::sha::details::initial_state;
+    auto hardware = portable;
+    cango::sha::details::compress_portable(portable, blocks.data(), 37);
+    cango::sha::details::shani::compress(hardware.data(), blocks.data(), 37);
+    if (portable != hardware) {
+        std::println(std::cerr, "[sha256] SHA 扩展实现与可移植实现不符");
+        return false;
+    }
+#endif
+    return true;
+}
+
+/// @brief 多缓冲实现与逐条计算的结果相同，消息长度各不相同，数量多于通道数
+bool test_sha256_many() {
+    std::uint32_t seed = 0xc0de'0014;
+    std::vector<std::byte> data(4096 + 200);
+    fill_pseudo_random(data, seed);
+    std::vector<std::span<const std::byte>> messages;
+    for (std::size_t i = 0; i < 61; ++i) {
+        const auto size = i * i * 37 % 4097;
+        messages.push_back(std::span{data}.subspan(i, size));
+    }
+    messages.push_back({});
+    std::vector<SHA256::digest_t> digests(messages.size());
+    if (cango::sha::sha256_many(messages, digests) != messages.size()) return false;
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        if (digests[i] != SHA256::hash(messages[i])) {
+            std::println(std::cerr, "[sha256] 第 {} 条消息({} 字节)的多缓冲摘要不正确", i, messages[i].size());
+            return false;
+        }
+    }
+#if CANGO_SHA_MULTI_SIMD
+    // 直接检查两个 SIMD 实现，不依赖运行时选择的路径
+    const auto& features = cango::aes::details::cpu_features();
+    for (const auto lanes: {8, 16}) {
+        if (lanes == 8 ? !features.avx2 : !features.avx512f) continue;
+        std::vector<SHA256::digest_t> lane_digests(messages.size());
+        if (lanes == 8) cango::sha::details::multi::hash_lanes<8>(messages, lane_digests, cango::sha::details::multi::compress_avx2);
+        else cango::sha::details::multi::hash_lanes<16>(messages, lane_digests, cango::sha::details::multi::compress_avx512);
+        if (lane_digests != digests) {
+            std::println(std::cerr, "[sha256] {} 通道实现的摘要不正确", lanes);
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+/// @brief 按定义逐层计算的根，叶子为 SHA256(0x00 || 块)，内部节点为 SHA256(0x01 || 左 || 右)
+SHA256::digest_t merkle_root_reference(const std::span<const std::byte> data, const std::size_t leafSize) {
+    std::vector<SHA256::digest_t> level;
+    for (std::size_t offset = 0; offset < data.size() || level.empty(); offset += leafSize) {
+        SHA256 hasher{};
+        hasher.update(std::string_view{"\0", 1});
+        hasher.update(data.subspan(offset, std::min(leafSize, data.size() - offset)));
+        level.push_back(hasher.finalize());
+    }
+    while (level.size() > 1) {
+        std::vector<SHA256::digest_t> next;
+        for (std::size_t i = 0; i < level.size(); i += 2) {
+            if (i + 1 == level.size()) {
+                next.push_back(level[i]);
+                continue;
+            }
+            SHA256 hasher{};
+            hasher.update(std::string_view{"\1", 1});
+            hasher.update(level[i]);
+            hasher.update(level[i + 1]);
+            next.push_back(hasher.finalize());
+        }
+        level = std::move(next);
+    }
+    return level.front();
+}
+
+/// @brief 树哈希：并行与定义一致，增量更新与重新计算一致，单块校验，序列化
+bool test_sha256_merkle() {
+    std::uint32_t seed = 0xc0de'0015;
+    std::vector<std::byte> data(300 * 1024 + 7);
+    fill_pseudo_random(data, seed);
+    const MerkleOptions options{4096, 4};
+    auto tree = MerkleTree::build(data, options);
+    if (tree.leaf_count() != 76 || tree.root() != merkle_root_reference(data, 4096)) {
+        std::println(std::cerr, "[merkle] 根摘要不正确");
+        return false;
+    }
+    cango::aes::Executor executor{{3}};
+    if (MerkleTree::build(data, {4096, 1}).root() != tree.root() || MerkleTree::build(data, {4096, 0, &executor}).root() != tree.root()) {
+        std::println(std::cerr, "[merkle] 不同线程数的结果不同");
+        return false;
+    }
+    if (MerkleTree::build({}, options).root() != merkle_root_reference({}, 4096)) {
+        std::println(std::cerr, "[merkle] 空数据的根摘要不正确");
+        return false;
+    }
+
+    data[3 * 4096 + 5] ^= std::byte{1};
+    data[data.size() - 1] ^= std::byte{1};
+    const std::size_t changed[] = {75, 3, 3};
+    if (!tree.update(data, changed, options) || tree.root() != merkle_root_reference(data, 4096)) {
+        std::println(std::cerr, "[merkle] 增量更新的结果不正确");
+        return false;
+    }
+    const std::size_t out_of_range[] = {76};
+    if (tree.update(data, out_of_range) || tree.update(std::span{data}.first(100), changed)) {
+        std::println(std::cerr, "[merkle] 非法的增量更新没有失败");
+        return false;
+    }
+
+    auto chunk = std::vector(data.begin() + 75 * 4096, data.end());
+    if (!tree.verify_leaf(75, chunk) || tree.verify_leaf(74, chunk)) {
+        std::println(std::cerr, "[merkle] 单块校验不正确");
+        return false;
+    }
+    chunk[0] ^= std::byte{1};
+    if (tree.verify_leaf(75, chunk)) {
+        std::println(std::cerr, "[merkle] 被修改的块通过了校验");
+        return false;
+    }
+
+    auto bytes = tree.serialize();
+    const auto loaded = MerkleTree::deserialize(bytes);
+    if (!loaded || loaded->root() != tree.root() || loaded->leaf_size() != 4096 || loaded->size() != data.size()) {
+        std::println(std::cerr, "[merkle] 序列化后读取的树不同");
+        return false;
+    }
+    bytes[bytes.size() - 1] ^= std::byte{1};
+    if (MerkleTree::deserialize(bytes) || MerkleTree::deserialize(std::span{bytes}.first(bytes.size() - 1))) {
+        std::println(std::cerr, "[merkle] 损坏的序列化数据没有被拒绝");
+        return false;
+    }
+
+    // 头部声称约 2^64 字节时，向上取整的叶子数不能回绕成 1
+    auto single = MerkleTree::build(std::span{data}.first(100)).serialize();
+    cango::aes::details::store_u64le(reinterpret_cast<std::uint8_t*>(single.data()) + 12, UINT64_MAX);
+    if (MerkleTree::deserialize(single) || MerkleTree::leaf_count_of(UINT64_MAX, 4096) != (UINT64_MAX >> 12) + 1) {
+        std::println(std::cerr, "[merkle] 声称长度接近 2^64 的数据没有被拒绝");
+        return false;
+    }
+    return true;
+}
+
+/// @brief 文件的树哈希：内存映射与读写路径一致，增量更新只读取被修改的块
+bool test_sha256_merkle_file() {
+    std::uint32_t seed = 0xc0de'1015;
+    std::vector<std::byte> data(3 * 1024 * 1024 + 100);
+    fill_pseudo_random(data, seed);
+    const auto path = std::filesystem::temp_directory_path() / "cango_sha_test_merkle.bin";
+    const auto write = [&] {
+        std::ofstream file{path, std::ios::binary};
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    };
+    write();
+
+    bool passed = true;
+    for (const bool mmap: {true, false}) {
+        MerkleOptions options{64 * 1024, 2};
+        options.allow_mmap = mmap;
+        MerkleTree tree{};
+        const auto report = cango::sha::merkle_file(path, tree, options);
+        if (report.error || report.bytes != data.size() || tree.root() != merkle_root_reference(data, 64 * 1024)) {
+            std::println(std::cerr, "[merkle-file] {}路径的根摘要不正确", mmap ? "内存映射" : "读写");
+            passed = false;
+            continue;
+        }
+
+        // 乱序且有重复的序号，重复的叶子只读一次；最后一个叶子只有 100 字节
+        data[10 * 64 * 1024] ^= std::byte{1};
+        data[40 * 64 * 1024 + 7] ^= std::byte{1};
+        data.back() ^= std::byte{1};
+        write();
+        const std::size_t changed[] = {40, 10, 48, 40, 10};
+        const auto update = cango::sha::merkle_file_update(path, tree, changed, options);
+        if (update.error || update.bytes != 2 * 64 * 1024 + 100 || tree.root() != merkle_root_reference(data, 64 * 1024)) {
+            std::println(std::cerr, "[merkle-file] {}路径的增量更新不正确", mmap ? "内存映射" : "读写");
+            passed = false;
+        }
+        if (!cango::sha::merkle_file_verify_leaf(path, tree, 10) || !cango::sha::merkle_file_verify_leaf(path, tree, tree.leaf_count() - 1)) {
+            std::println(std::cerr, "[merkle-file] 单块校验不正确");
+            passed = false;
+        }
+    }
+    std::filesystem::remove(path);
+    return passed;
+}
+
+/// @brief RFC 4231 测试用例，覆盖短密钥、长于一块的密钥、分段输入与截断标签
+bool test_hmac_sha256() {
+    const std::tuple<std::string, std::string, std::string_view> vectors[] = {
+        {std::string(20, '\x0b'), "Hi There", "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"},
+        {"Jefe", "what do ya want for nothing?", "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"},
+        {std::string(20, '\xaa'), std::string(50, '\xdd'), "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe"},
+        {std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First",
+         "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"},
+    };
+    for (const auto& [key, message, expected]: vectors) {
+        HmacSha256 hmac{key};
+        if (hmac.mac(message) != to_digest(expected) || HmacSha256::compute(key, message) != to_digest(expected)) {
+            std::println(std::cerr, "[hmac] {} 字节密钥的标签不正确", key.size());
+            return false;
+        }
+        // 分段输入，两次使用同一个对象
+        for (std::size_t round = 0; round < 2; ++round) {
+            for (std::size_t offset = 0; offset < message.size(); offset += 7)
+                hmac.update(std::string_view{message}.substr(offset, 7));
+            if (hmac.finalize() != to_digest(expected)) {
+                std::println(std::cerr, "[hmac] {} 字节密钥分段输入的标签不正确", key.size());
+                return false;
+            }
+        }
+    }
+
+    const HmacSha256 hmac{std::string_view{"key"}};
+    const auto message = hex_to_bytes("00112233445566778899");
+    auto tag = hmac.mac(message);
+    const auto tag_bytes = std::as_bytes(std::span{tag});
+    if (!hmac.verify(message, tag_bytes) || !hmac.verify(message, tag_bytes.first(16))) {
+        std::println(std::cerr, "[hmac] 正确的标签没有通过校验");
+        return false;
+    }
+    if (hmac.verify(message, {}) || hmac.verify(message, tag_bytes.first(1)) || hmac.verify(message, tag_bytes.first(15))) {
+        std::println(std::cerr, "[hmac] 短于 16 字节的截断标签通过了校验");
+        return false;
+    }
+    tag[31] ^= 1;
+    if (hmac.verify(message, tag_bytes)) {
+        std::println(std::cerr, "[hmac] 错误的标签通过了校验");
+        return false;
+    }
+    return true;
+}
+
+/// @brief RFC 5869 附录 A 的 SHA-256 测试用例，以及批量派生与逐个派生结果相同
+bool test_hkdf() {
+    struct Vector {
+        std::string_view ikm, salt, info, prk, okm;
+    };
+    const Vector vectors[] = {
+        {"0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", "000102030405060708090a0b0c", "f0f1f2f3f4f5f6f7f8f9",
+         "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5",
+         "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"},
+        {"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+         "303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f",
+         "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f"
+         "909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+         "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+         "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+         "06a6b88c5853361a06104c9ceb35b45cef760014904671014a193f40c15fc244",
+         "b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c59045a99cac7827271cb41c65e590e09"
+         "da3275600c2f09b8367793a9aca3db71cc30c58179ec3e87c14c01d5c1f3434f1d87"},
+        {"0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b", "", "",
+         "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04",
+         "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"},
+    };
+    for (const auto& vector: vectors) {
+        const auto prk = Hkdf::extract(hex_to_bytes(vector.salt), hex_to_bytes(vector.ikm));
+        const auto expected = hex_to_bytes(vector.okm);
+        std::vector<std::byte> okm(expected.size());
+        if (prk != to_digest(vector.prk) || !Hkdf{prk}.expand(hex_to_bytes(vector.info), okm) || okm != expected) {
+            std::println(std::cerr, "[hkdf] {} 字节输出的测试用例不正确", expected.size());
+            return false;
+        }
+    }
+
+    const Hkdf hkdf{Hkdf::extract({}, hex_to_bytes("000102030405060708090a0b0c0d0e0f"))};
+    std::vector<std::byte> too_long(Hkdf::max_output + 1);
+    if (hkdf.expand({}, too_long)) {
+        std::println(std::cerr, "[hkdf] 超过最大长度的输出没有失败");
+        return false;
+    }
+
+    // 每个会话的 info 为序号，批量派生 32 字节的 AES-256 主钥
+    std::vector<std::array<std::byte, 8>> ids(1000);
+    for (std::size_t i = 0; i < ids.size(); ++i)
+        for (std::size_t j = 0; j < 8; ++j) ids[i][j] = static_cast<std::byte>(i >> (8 * j));
+    std::vector<std::span<const std::byte>> infos(ids.begin(), ids.end());
+    std::vector<std::byte> keys(infos.size() * 32);
+    if (hkdf.expand_many(infos, keys, 32) != infos.size()) return false;
+    for (std::size_t i = 0; i < infos.size(); ++i) {
+        const auto key = hkdf.expand<32>(infos[i]);
+        if (std::memcmp(key.data(), keys.data() + 32 * i, 32) != 0) {
+            std::println(std::cerr, "[hkdf] 批量派生的第 {} 个密钥不正确", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    toolbox tb{true};
+    tb.execute("sha256 vectors", test_sha256_vectors);
+    tb.execute("sha256 fragments", test_sha256_fragments);
+    tb.execute("sha256 backends", test_sha256_backends);
+    tb.execute("sha256 many", test_sha256_many);
+    tb.execute("sha256 merkle", test_sha256_merkle);
+    tb.execute("sha256 merkle file", test_sha256_merkle_file);
+    tb.execute("hmac sha256", test_hmac_sha256);
+    tb.execute("hkdf", test_hkdf);
+    tb.summary();
+    return tb.failed > 0 ? 1 : 0;
+}
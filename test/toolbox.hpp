@@ -6,6 +6,7 @@
 #include <list>
 #include <print>
 #include <sstream>
+#include <vector>
 
 #include <cango/aes.hpp>
 
@@ -20,6 +21,25 @@ std::string bytes_to_string(const auto& bytes) {
     return ss.str();
 }
 
+/// @brief 把十六进制字符串转换为字节列表，用于书写标准测试向量
+std::vector<std::byte> hex_to_bytes(const std::string_view hex) {
+    const auto digit = [](const char c) {
+        return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+    };
+    std::vector<std::byte> result(hex.size() / 2);
+    for (std::size_t i = 0; i < result.size(); ++i)
+        result[i] = static_cast<std::byte>(digit(hex[2 * i]) << 4 | digit(hex[2 * i + 1]));
+    return result;
+}
+
+/// @brief 用线性同余生成器填充伪随机字节，保证每次运行的数据相同
+void fill_pseudo_random(auto& bytes, std::uint32_t& seed) {
+    for (auto& byte: bytes) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<std::remove_reference_t<decltype(byte)>>(seed >> 24);
+    }
+}
+
 struct toolbox {
     bool verbose;
 
@@ -0,0 +1,86 @@
+// 用 AES-CTR 加密或解密整个文件，并报告吞吐量，整个计数器块按 128 位大端计数器递增
+// 用法：cango_aes_file <密钥十六进制> <计数器块十六进制> <输入文件> <输出文件> [线程数] [--no-mmap]
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include <cango/aes.hpp>
+#include <cango/aes/file.hpp>
+
+using namespace cango::aes;
+
+namespace {
+
+/// @brief 解析定长的十六进制字符串
+template<std::size_t N>
+std::optional<std::array<std::uint8_t, N>> parse_hex(const std::string_view hex) {
+    if (hex.size() != N * 2) return std::nullopt;
+    const auto digit = [](const char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') return (c | 0x20) - 'a' + 10;
+        return -1;
+    };
+    std::array<std::uint8_t, N> result{};
+    for (std::size_t i = 0; i < N; ++i) {
+        const auto hi = digit(hex[2 * i]);
+        const auto lo = digit(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return std::nullopt;
+        result[i] = static_cast<std::uint8_t>(hi << 4 | lo);
+    }
+    return result;
+}
+
+template<typename TCryptor, std::size_t NKeyBytes>
+int run(const std::string_view keyHex, const block_t& counter, const char* input, const char* output, const FileOptions& options) {
+    const auto key = parse_hex<NKeyBytes>(keyHex);
+    if (!key) {
+        std::fprintf(stderr, "密钥不是有效的十六进制字符串\n");
+        return 2;
+    }
+    const TCryptor cryptor{*key};
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto report = ctr_file<TCryptor, 128>(cryptor, counter, input, output, options);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (report.error) {
+        std::fprintf(stderr, "处理失败：%s\n", report.error.message().c_str());
+        return 1;
+    }
+    std::printf("%llu 字节，%.3f 秒，%.2f GB/s (%s，%s 引擎)\n", static_cast<unsigned long long>(report.bytes), elapsed.count(),
+                static_cast<double>(report.bytes) / elapsed.count() / 1e9, report.mapped ? "内存映射" : "读写",
+                details::engine_name(details::active_engine()));
+    return 0;
+}
+
+}
+
+int main(const int argc, char** argv) {
+    if (argc < 5) {
+        std::fprintf(stderr, "用法：%s <密钥十六进制> <计数器块十六进制> <输入文件> <输出文件> [线程数] [--no-mmap]\n", argv[0]);
+        return 2;
+    }
+    const auto counter = parse_hex<16>(argv[2]);
+    if (!counter) {
+        std::fprintf(stderr, "计数器块必须是 32 个十六进制字符\n");
+        return 2;
+    }
+    FileOptions options{};
+    for (int i = 5; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-mmap") == 0) options.allow_mmap = false;
+        else options.threads = static_cast<std::size_t>(std::strtoull(argv[i], nullptr, 10));
+    }
+
+    switch (const std::string_view key{argv[1]}; key.size()) {
+        case 32: return run<AES128Cryptor, 16>(key, *counter, argv[3], argv[4], options);
+        case 48: return run<AES192Cryptor, 24>(key, *counter, argv[3], argv[4], options);
+        case 64: return run<AES256Cryptor, 32>(key, *counter, argv[3], argv[4], options);
+        default:
+            std::fprintf(stderr, "密钥必须是 32, 48 或 64 个十六进制字符\n");
+            return 2;
+    }
+}